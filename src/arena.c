@@ -0,0 +1,147 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <msglog.h>
+
+#include <arena.h>
+
+
+#define ARENA_ALIGN( size )  ( ((size) + 15) & ~((size_t)15) )
+
+struct arena_block
+{
+  struct arena_block *next;
+  size_t              size; /* size of data area */
+  size_t              used;
+};
+
+#define BLOCK_HEADER_SIZE  ARENA_ALIGN( sizeof( struct arena_block ) )
+#define BLOCK_DATA( block )  ( (char *)(block) + BLOCK_HEADER_SIZE )
+
+struct arena
+{
+  struct arena_block *blocks; /* the first block is the current one */
+  size_t              block_size;
+};
+
+
+static struct arena_block *__block_alloc( size_t size )
+{
+  struct arena_block *block = NULL;
+
+  block = (struct arena_block *)malloc( BLOCK_HEADER_SIZE + size );
+  if( !block ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  block->next = NULL;
+  block->size = size;
+  block->used = 0;
+
+  return block;
+}
+
+struct arena *arena_create( size_t block_size )
+{
+  struct arena *arena = NULL;
+
+  arena = (struct arena *)malloc( sizeof( struct arena ) );
+  if( !arena ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  bzero( (void *)arena, sizeof( struct arena ) );
+
+  arena->block_size = ARENA_ALIGN( block_size ? block_size : (size_t)ARENA_BLOCK_SIZE );
+
+  return arena;
+}
+
+void arena_destroy( struct arena *arena )
+{
+  struct arena_block *block, *next;
+
+  if( !arena ) return;
+
+  for( block = arena->blocks; block; block = next )
+  {
+    next = block->next;
+    free( block );
+  }
+  free( arena );
+}
+
+void *arena_alloc( struct arena *arena, size_t size )
+{
+  struct arena_block *block = NULL;
+  void               *ptr   = NULL;
+
+  if( !arena ) return ptr;
+
+  size = ARENA_ALIGN( size ? size : 1 );
+
+  block = arena->blocks;
+  if( block && block->size - block->used >= size )
+  {
+    ptr = (void *)(BLOCK_DATA( block ) + block->used);
+    block->used += size;
+    return ptr;
+  }
+
+  if( size > arena->block_size / 4 )
+  {
+    /*
+      Large objects get their own blocks which are placed behind
+      the current one to keep the rest of current block in use:
+     */
+    block = __block_alloc( size );
+    block->used = size;
+    if( arena->blocks )
+    {
+      block->next = arena->blocks->next;
+      arena->blocks->next = block;
+    }
+    else
+    {
+      arena->blocks = block;
+    }
+    return (void *)BLOCK_DATA( block );
+  }
+
+  block = __block_alloc( arena->block_size );
+  block->next   = arena->blocks;
+  arena->blocks = block;
+
+  block->used = size;
+
+  return (void *)BLOCK_DATA( block );
+}
+
+char *arena_strdup( struct arena *arena, const char *s )
+{
+  char   *p   = NULL;
+  size_t  len;
+
+  if( !s ) return p;
+
+  len = strlen( s ) + 1;
+  p = (char *)arena_alloc( arena, len );
+  if( p ) memcpy( (void *)p, (const void *)s, len );
+
+  return p;
+}
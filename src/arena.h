@@ -0,0 +1,62 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+
+/***************************************************************
+  Memory ARENA:
+  ============
+
+    Bump-pointer allocator for objects which live up to the end
+    of some stage of the program (for example, the packages  of
+    repository with their lists and strings). Objects are taken
+    from large blocks one after another and cannot be freed one
+    by one; arena_destroy() releases all blocks at once:
+
+      struct arena *arena = arena_create( 0 );
+      char         *name  = arena_strdup( arena, "pkgtools" );
+
+      ...
+
+      arena_destroy( arena );
+
+    Memory returned by arena_alloc() is not cleared.
+ */
+struct arena;
+
+#define ARENA_BLOCK_SIZE  (1024 * 1024) /* default size of blocks */
+
+extern struct arena *arena_create( size_t block_size );
+extern void arena_destroy( struct arena *arena );
+
+extern void *arena_alloc( struct arena *arena, size_t size );
+extern char *arena_strdup( struct arena *arena, const char *s );
+
+
+#ifdef __cplusplus
+}  /* ... extern "C" */
+#endif
+
+#endif /* _ARENA_H_ */
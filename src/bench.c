@@ -0,0 +1,521 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+/***************************************************************
+  Microbenchmarks of cmpvers.c, dlist.c, pkglist.c and JSON:
+  =========================================================
+
+    Built and run by 'make bench' command; not installed. Usage:
+
+      pkgtools-bench [cmpvers] [dlist] [resolver] [json]
+
+    Each line of the report contains the number of operations,
+    the time in nanoseconds and the number of malloc(3) calls per
+    operation. Allocations are counted by the malloc(3) functions
+    of this program which are passed to the C library.
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <msglog.h>
+
+#include <cmpvers.h>
+#include <dlist.h>
+#include <jsmin.h>
+#include <json.h>
+#include <pkglist.h>
+
+
+char *program     = "pkgtools-bench";
+int   exit_status = EXIT_SUCCESS; /* errors counter */
+
+static volatile long sink = 0; /* keeps results of benchmarked calls */
+
+
+/***************************************************************
+  Allocations counter:
+ */
+extern void *__libc_malloc( size_t size );
+extern void *__libc_calloc( size_t nmemb, size_t size );
+extern void *__libc_realloc( void *ptr, size_t size );
+extern void  __libc_free( void *ptr );
+
+static unsigned long allocs = 0;
+
+void *malloc( size_t size )
+{
+  ++allocs; return __libc_malloc( size );
+}
+
+void *calloc( size_t nmemb, size_t size )
+{
+  ++allocs; return __libc_calloc( nmemb, size );
+}
+
+void *realloc( void *ptr, size_t size )
+{
+  if( !ptr ) ++allocs;
+  return __libc_realloc( ptr, size );
+}
+
+void free( void *ptr )
+{
+  __libc_free( ptr );
+}
+/*
+  End of allocations counter.
+ ***************************************************************/
+
+
+static double now( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+
+  return (double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec;
+}
+
+struct measure
+{
+  double        start;
+  unsigned long allocs;
+};
+
+static void measure_start( struct measure *m )
+{
+  m->allocs = allocs;
+  m->start  = now();
+}
+
+static void measure_stop( struct measure *m, const char *name, unsigned long ops )
+{
+  double        ns = now() - m->start;
+  unsigned long n  = allocs - m->allocs;
+
+  if( !ops ) ops = 1;
+
+  fprintf( stdout, "%-36s %10lu ops %12.1f ns/op %10.2f allocs/op\n",
+                    name, ops, ns / (double)ops, (double)n / (double)ops );
+  fflush( stdout );
+}
+
+/* Deterministic random numbers (xorshift) to have the same data on each run: */
+static uint32_t rnd_state = 2463534242u;
+
+static uint32_t rnd( void )
+{
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+  return rnd_state;
+}
+
+
+/***************************************************************
+  CMPVERS benchmarks:
+ */
+static const char *versions[] =
+{
+  "0.9.8zh", "1.0.2u", "1.1.1w", "3.0.13", "3.2.1",
+  "2.31", "2.36", "2.38", "2.39",
+  "1.2.11", "1.2.13", "1.3.1",
+  "4.9.337", "5.4.281", "5.10.223", "5.15.0-rc3", "6.1.102", "6.6.44",
+  "1.0", "1.0.0", "1.00", "1.01", "1.001", "1.1",
+  "20190315", "20211026", "2023.09.14",
+  "0.0.9", "0.1.0-alpha", "0.1.0-beta2", "0.1.0-rc1", "0.1.0",
+  "1.36.1", "1.6.2", "1.16.5", "10.2.0", "12.3.0", "13.2.1",
+  "r1248", "git20220830",
+  NULL
+};
+
+static void bench_cmpvers( void )
+{
+  struct measure m;
+  unsigned long  ops = 0;
+  int            i, j, pass, n;
+  char         **keys;
+  char           key[VERSION_KEY_SIZE( 64 )]; /* versions of the list are shorter */
+  long           r = 0;
+
+  for( n = 0; versions[n]; ++n ) ;
+
+  measure_start( &m );
+  for( pass = 0; pass < 2000; ++pass )
+    for( i = 0; i < n; ++i )
+      for( j = 0; j < n; ++j, ++ops )
+        r += cmp_version( versions[i], versions[j] );
+  measure_stop( &m, "cmp_version", ops );
+
+  keys = (char **)malloc( sizeof(char *) * (size_t)n );
+  if( !keys ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  ops = 0;
+  measure_start( &m );
+  for( pass = 0; pass < 20000; ++pass )
+    for( i = 0; i < n; ++i, ++ops )
+      r += (long)version_key( key, versions[i] );
+  measure_stop( &m, "version_key", ops );
+
+  for( i = 0; i < n; ++i )
+  {
+    keys[i] = (char *)malloc( VERSION_KEY_SIZE( strlen( versions[i] ) ) );
+    if( !keys[i] ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    (void)version_key( keys[i], versions[i] );
+  }
+
+  ops = 0;
+  measure_start( &m );
+  for( pass = 0; pass < 2000; ++pass )
+    for( i = 0; i < n; ++i )
+      for( j = 0; j < n; ++j, ++ops )
+        r += strcmp( keys[i], keys[j] );
+  measure_stop( &m, "strcmp(version keys)", ops );
+
+  for( i = 0; i < n; ++i ) free( keys[i] );
+  free( keys );
+
+  sink += r;
+}
+/*
+  End of CMPVERS benchmarks.
+ ***************************************************************/
+
+
+/***************************************************************
+  DLIST benchmarks:
+ */
+static const int sizes[] = { 1000, 10000, 100000, 1000000, 0 };
+
+/* dlist_append() walks to the end of list; larger lists take too long: */
+#define DLIST_APPEND_MAX  100000
+
+static int __compare_ints( const void *a, const void *b )
+{
+  intptr_t i1 = (intptr_t)a, i2 = (intptr_t)b;
+
+  return ( i1 > i2 ) - ( i1 < i2 );
+}
+
+static void bench_dlist( void )
+{
+  struct measure m;
+  char           name[64];
+  int            s;
+
+  for( s = 0; sizes[s]; ++s )
+  {
+    struct dlist_head  head = DLIST_HEAD_INIT;
+    struct dlist      *list = NULL;
+    const void       **targets;
+    int                i, n = sizes[s], finds;
+
+    if( n <= DLIST_APPEND_MAX )
+    {
+      sprintf( name, "dlist_append/%d", n );
+      measure_start( &m );
+      for( i = 0; i < n; ++i )
+        list = dlist_append( list, (void *)(intptr_t)rnd() );
+      measure_stop( &m, name, (unsigned long)n );
+      dlist_free( list, NULL ); list = NULL;
+    }
+
+    sprintf( name, "dlist_head_append/%d", n );
+    measure_start( &m );
+    for( i = 0; i < n; ++i )
+      (void)dlist_head_append( &head, (void *)(intptr_t)(rnd() & 0x7fffffff) );
+    measure_stop( &m, name, (unsigned long)n );
+
+    list = dlist_head_detach( &head );
+
+    finds = ( 10000000 / n < 10 ) ? 10 : 10000000 / n;
+    if( finds > 10000 ) finds = 10000;
+
+    targets = (const void **)malloc( sizeof(void *) * (size_t)finds );
+    if( !targets ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    for( i = 0; i < finds; ++i )
+      targets[i] = dlist_nth_data( list, (int)(rnd() % (uint32_t)n) );
+
+    sprintf( name, "dlist_find_data/%d", n );
+    measure_start( &m );
+    for( i = 0; i < finds; ++i )
+      sink += (long)(intptr_t)dlist_find_data( list, __compare_ints, targets[i] );
+    measure_stop( &m, name, (unsigned long)finds );
+
+    free( targets );
+
+    sprintf( name, "dlist_sort/%d", n );
+    measure_start( &m );
+    list = dlist_sort( list, __compare_ints );
+    measure_stop( &m, name, (unsigned long)n );
+
+    dlist_free( list, NULL );
+  }
+}
+/*
+  End of DLIST benchmarks.
+ ***************************************************************/
+
+
+/***************************************************************
+  RESOLVER benchmarks:
+  ===================
+
+    create_provides_list() over synthetic dependency graphs:
+
+      chain   - each package requires the previous one;
+      fan     - all packages require the first one and the last
+                package requires all others;
+      diamond - layers of 32 packages, each package requires two
+                packages of the previous layer.
+ */
+enum _graph
+{
+  GRAPH_CHAIN = 0,
+  GRAPH_FAN,
+  GRAPH_DIAMOND
+};
+
+#define DIAMOND_WIDTH  32
+
+static const char *groups[] = { "base", "libs", "dev", "app", "net", "X11", NULL };
+
+static struct package **pkgs = NULL;
+
+static void __require( struct package *package, struct package *required )
+{
+  struct pkg *pkg = pkg_alloc();
+
+  pkg->group   = required->pkginfo->group;
+  pkg->name    = required->pkginfo->name;
+  pkg->version = required->pkginfo->version;
+
+  add_required( package, pkg );
+}
+
+static void build_graph( enum _graph type, int n )
+{
+  char buf[64];
+  int  i;
+
+  pkgs = (struct package **)malloc( sizeof(struct package *) * (size_t)n );
+  if( !pkgs ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( i = 0; i < n; ++i )
+  {
+    struct package *package = package_alloc();
+    struct pkginfo *info    = package->pkginfo;
+
+    sprintf( buf, "pkg%d", i );
+    info->name  = pkglist_intern( buf );
+    sprintf( buf, "1.%d.%d", i % 7, i % 13 );
+    info->version        = pkglist_intern( buf );
+    info->group          = pkglist_intern( groups[i % 6] );
+    info->arch           = pkglist_intern( "x86_64" );
+    info->distro_name    = pkglist_intern( "radix" );
+    info->distro_version = pkglist_intern( "1.1" );
+
+    package->procedure = INSTALL;
+    package->priority  = REQUIRED;
+
+    pkgs[i] = package;
+  }
+
+  for( i = 1; i < n; ++i )
+  {
+    switch( type )
+    {
+      case GRAPH_CHAIN:
+        __require( pkgs[i], pkgs[i - 1] );
+        break;
+      case GRAPH_FAN:
+        __require( pkgs[i], pkgs[0] );
+        break;
+      case GRAPH_DIAMOND:
+        if( i >= DIAMOND_WIDTH )
+        {
+          int layer = i / DIAMOND_WIDTH - 1;
+          __require( pkgs[i], pkgs[layer * DIAMOND_WIDTH + i % DIAMOND_WIDTH] );
+          __require( pkgs[i], pkgs[layer * DIAMOND_WIDTH + (i + 1) % DIAMOND_WIDTH] );
+        }
+        break;
+    }
+  }
+  if( type == GRAPH_FAN )
+  {
+    for( i = 1; i < n - 1; ++i ) __require( pkgs[n - 1], pkgs[i] );
+  }
+
+  /* shuffle packages to not give the resolver a sorted list: */
+  for( i = n - 1; i > 0; --i )
+  {
+    int j = (int)(rnd() % (uint32_t)(i + 1));
+    struct package *p = pkgs[i]; pkgs[i] = pkgs[j]; pkgs[j] = p;
+  }
+  for( i = 0; i < n; ++i ) add_package( pkgs[i] );
+
+  free( pkgs ); pkgs = NULL;
+}
+
+static void bench_resolver( void )
+{
+  static const char *names[] = { "chain", "fan", "diamond" };
+
+  struct measure m;
+  char           name[64];
+  int            type, n;
+
+  for( type = GRAPH_CHAIN; type <= GRAPH_DIAMOND; ++type )
+  {
+    for( n = 1000; n <= 10000; n *= 10 )
+    {
+      build_graph( (enum _graph)type, n );
+
+      sprintf( name, "create_provides_list/%s/%d", names[type], n );
+      measure_start( &m );
+      sink += create_provides_list( NULL );
+      measure_stop( &m, name, (unsigned long)n );
+
+      free_provides_list();
+      free_packages();
+    }
+  }
+}
+/*
+  End of RESOLVER benchmarks.
+ ***************************************************************/
+
+
+/***************************************************************
+  JSON benchmarks:
+ */
+#define JSON_RECORDS  20000
+
+static void write_records( struct json *json, int n )
+{
+  int i;
+
+  json_text( json, "[{\n" );
+  for( i = 0; i < n; ++i )
+  {
+    if( i ) json_text( json, " },\n {\n" );
+
+    json_text( json, "  \"id\": " );
+    json_stringf( json, "libs:pkg%d-1.%d.%d", i, i % 7, i % 13 );
+    json_text( json, ",\n  \"name\": " );
+    json_stringf( json, "pkg%d", i );
+    json_text( json, ",\n  \"description\": " );
+    json_string( json, "synthetic package (\"bench\" data)" );
+    json_text( json, ",\n  \"total_files\": " );
+    json_printf( json, "\"%d\"", i % 1000 );
+    json_text( json, "\n" );
+  }
+  json_text( json, " }]\n" );
+}
+
+static void bench_json( void )
+{
+  struct measure m;
+  struct json    json;
+  struct jsmin   jsmin;
+  char           name[64];
+  char          *doc = NULL;
+  size_t         len = 0, off;
+  FILE          *null, *mem;
+
+  null = fopen( "/dev/null", "w" );
+  mem  = open_memstream( &doc, &len );
+  if( !null || !mem ) { FATAL_ERROR( "Cannot open output stream" ); }
+
+  json_init( &json, mem, NULL );
+  write_records( &json, JSON_RECORDS );
+  json_free( &json );
+  fclose( mem );
+
+  sprintf( name, "json_writer/pretty/%d", JSON_RECORDS );
+  measure_start( &m );
+  json_init( &json, null, NULL );
+  write_records( &json, JSON_RECORDS );
+  json_free( &json );
+  measure_stop( &m, name, JSON_RECORDS );
+
+  sprintf( name, "json_writer/pretty+compact/%d", JSON_RECORDS );
+  measure_start( &m );
+  json_init( &json, null, null );
+  write_records( &json, JSON_RECORDS );
+  json_free( &json );
+  measure_stop( &m, name, JSON_RECORDS );
+
+  sprintf( name, "json_writer+jsmin/memory/%d", JSON_RECORDS );
+  measure_start( &m );
+  jsmin_init( &jsmin, NULL, NULL );
+  json_init_jsmin( &json, NULL, &jsmin );
+  write_records( &json, JSON_RECORDS );
+  json_free( &json );
+  sink += jsmin_finish( &jsmin ) + (long)jsmin.len;
+  jsmin_free( &jsmin );
+  measure_stop( &m, name, JSON_RECORDS );
+
+  /* ops are bytes of input: */
+  sprintf( name, "jsmin/memory/%lu", (unsigned long)len );
+  measure_start( &m );
+  jsmin_init( &jsmin, NULL, NULL );
+  for( off = 0; off < len; off += JSMIN_BUFFER_SIZE )
+  {
+    jsmin_write( &jsmin, doc + off, ( len - off < JSMIN_BUFFER_SIZE ) ? len - off : JSMIN_BUFFER_SIZE );
+  }
+  sink += jsmin_finish( &jsmin ) + (long)jsmin.len;
+  jsmin_free( &jsmin );
+  measure_stop( &m, name, (unsigned long)len );
+
+  fclose( null );
+  free( doc );
+}
+/*
+  End of JSON benchmarks.
+ ***************************************************************/
+
+
+static int selected( int argc, char *argv[], const char *name )
+{
+  int i;
+
+  if( argc < 2 ) return 1;
+
+  for( i = 1; i < argc; ++i )
+    if( !strcmp( argv[i], name ) ) return 1;
+
+  return 0;
+}
+
+int main( int argc, char *argv[] )
+{
+  errlog = stderr;
+
+  if( selected( argc, argv, "cmpvers" ) )  bench_cmpvers();
+  if( selected( argc, argv, "dlist" ) )    bench_dlist();
+  if( selected( argc, argv, "resolver" ) ) bench_resolver();
+  if( selected( argc, argv, "json" ) )     bench_json();
+
+  exit( exit_status );
+}
@@ -54,6 +54,7 @@
 #include <msglog.h>
 #include <system.h>
 #include <cmpvers.h>
+#include <tarball.h>
 
 #define PROGRAM_NAME "check-package"
 
@@ -403,12 +404,10 @@ static void set_signal_handlers()
 static enum _input_type check_input_file( char *uncompress, const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   if( uncompress )
   {
     *uncompress = '\0';
@@ -419,8 +418,6 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -439,47 +436,14 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     close( fd ); return IFMT_LOG;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    if( uncompress ) { *uncompress = 'x'; }
-    close( fd ); return IFMT_PKG;
-  }
+  close( fd );
 
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    if( uncompress ) { *uncompress = 'j'; }
-    close( fd ); return IFMT_PKG;
-  }
-
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
-  {
-    if( uncompress ) { *uncompress = 'J'; }
-    close( fd ); return IFMT_PKG;
-  }
+  /* GZ, BZ2, XZ or TAR */
+  if( (compression = tarball_compression( fname )) == TARBALL_UNKNOWN ) return IFMT_UNKNOWN;
 
-  if( pkglog_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return IFMT_PKG;
-    }
-  }
+  if( uncompress ) { *uncompress = tarball_tar_option( compression ); }
 
-  close( fd ); return IFMT_UNKNOWN;
+  return IFMT_PKG;
 }
 
 
@@ -57,6 +57,8 @@
 #include <system.h>
 #include <dlist.h>
 #include <pkglist.h>
+#include <pkgdb.h>
+#include <tarball.h>
 
 #define PROGRAM_NAME "check-requires"
 
@@ -429,12 +431,10 @@ static void set_signal_handlers()
 static enum _input_type check_input_file( char *uncompress, const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   if( uncompress )
   {
     *uncompress = '\0';
@@ -445,8 +445,6 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -465,47 +463,14 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     close( fd ); return IFMT_LOG;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    if( uncompress ) { *uncompress = 'x'; }
-    close( fd ); return IFMT_PKG;
-  }
-
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    if( uncompress ) { *uncompress = 'j'; }
-    close( fd ); return IFMT_PKG;
-  }
+  close( fd );
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
-  {
-    if( uncompress ) { *uncompress = 'J'; }
-    close( fd ); return IFMT_PKG;
-  }
+  /* GZ, BZ2, XZ or TAR */
+  if( (compression = tarball_compression( fname )) == TARBALL_UNKNOWN ) return IFMT_UNKNOWN;
 
-  if( pkglog_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return IFMT_PKG;
-    }
-  }
+  if( uncompress ) { *uncompress = tarball_tar_option( compression ); }
 
-  close( fd ); return IFMT_UNKNOWN;
+  return IFMT_PKG;
 }
 
 
@@ -749,1217 +714,165 @@ static void _search_pkglogs( const char *dirpath, const char *grp )
  */
 int copy_pkglogs( void )
 {
-  int ret = 0;
-
-  __done = 0; __child = 0;
-
-  _search_pkglogs( (const char *)pkgs_path, NULL );
-
-  if( __child > 0 )
-  {
-    while( !__done ) usleep( 1 );
-    ret = __child;
-  }
-
-  __done = 0; __child = 0;
-
-  return ret;
-}
-/*
-  Enf of Copy functions.
- ***********************************************************/
-
-
-/***********************************************************
-  Remove leading spaces and take non-space characters only:
-  (Especialy for pkginfo lines)
- */
-static char *skip_spaces( char *s )
-{
-  char *q, *p = (char *)0;
-
-  if( !s || *s == '\0' ) return p;
-
-  p = s;
-
-  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
-  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
-
-  if( *p == '\0' ) return (char *)0;
-
-  return( strdup( p ) );
-}
-
-
-/*******************************
-  remove spaces at end of line:
- */
-static void skip_eol_spaces( char *s )
-{
-  char *p = (char *)0;
-
-  if( !s || *s == '\0' ) return;
-
-  p = s + strlen( s ) - 1;
-  while( isspace( *p ) ) { *p-- = '\0'; }
-}
-
-static size_t read_usize( char *s )
-{
-  size_t  size = 0;
-  size_t  mult = 1;
-  double  sz = 0.0;
-
-  char    suffix;
-  char   *q, *p = (char *)0;
-
-  if( !s || *s == '\0' ) return size;
-
-  p = s;
-
-  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
-  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
-
-  if( *p == '\0' ) return size;
-
-  --q;
-  suffix = *q;
-  switch( suffix )
-  {
-    /* by default size calculates in KiB - 1024 Bytes (du -s -h .) */
-    case 'G':
-    case 'g':
-      mult = 1024 * 1024;
-      *q = '\0';
-      break;
-    case 'M':
-    case 'm':
-      mult = 1024;
-      *q = '\0';
-      break;
-    case 'K':
-    case 'k':
-      *q = '\0';
-      break;
-    default:
-      break;
-  }
-
-  if( sscanf( p, "%lg", &sz ) != 1 ) return size;
-
-  return (size_t)round( sz * (double)mult );
-}
-
-static int read_total_files( char *s )
-{
-  int   n = 0;
-  char *q, *p = (char *)0;
-
-  if( !s || *s == '\0' ) return n;
-
-  p = s;
-
-  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
-  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
-
-  if( *p == '\0' ) return n;
-
-  if( sscanf( p, "%u", &n ) != 1 ) return 0;
-
-  return n;
-}
-
-static struct pkg *input_package( const char *pkginfo_fname )
-{
-  char *ln      = NULL;
-  char *line    = NULL;
-
-  FILE *pkginfo = NULL;
-
-  struct pkg *pkg = NULL;
-  char *pkgname = NULL, *pkgver = NULL, *group = NULL;
-
-  if( pkginfo_fname != NULL )
-  {
-    pkginfo = fopen( (const char *)pkginfo_fname, "r" );
-    if( !pkginfo )
-    {
-      FATAL_ERROR( "Cannot open %s file", pkginfo_fname );
-    }
-  }
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
-  {
-    FATAL_ERROR( "Cannot allocate memory" );
-  }
-
-  while( (ln = fgets( line, PATH_MAX, pkginfo )) )
-  {
-    char *match = NULL;
-
-    ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-    skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-    if( (match = strstr( ln, "pkgname" )) && match == ln ) {
-      char *p = index( match, '=' ) + 1;
-      if( p != NULL ) pkgname = skip_spaces( p );
-    }
-    if( (match = strstr( ln, "pkgver" )) && match == ln ) {
-      char *p = index( match, '=' ) + 1;
-      if( p != NULL ) pkgver = skip_spaces( p );
-    }
-    if( (match = strstr( ln, "group" )) && match == ln ) {
-      char *p = index( match, '=' ) + 1;
-      if( p != NULL ) group = skip_spaces( p );
-    }
-  }
-
-  free( line );
-
-  if( pkgname && pkgver )
-  {
-    pkg = pkg_alloc();
-    if( pkg )
-    {
-      if( group )
-      {
-        pkg->group = group;
-      }
-      pkg->name    = pkgname;
-      pkg->version = pkgver;
-    }
-
-  }
-  else
-  {
-    if( group )      free( group );
-    if( pkgname )    free( pkgname );
-    if( pkgver )     free( pkgver );
-
-    FATAL_ERROR( "Invalid input .PKGINFO file" );
-  }
-
-  fclose( pkginfo );
-
-  return( pkg );
-}
-
-
-static void get_short_description( char *buf, const char *line )
-{
-  char *s, *p, *q;
-
-  if( buf ) { buf[0] = '\0'; s = buf; }
-  if( !line || line[0] == '\0' ) return;
-
-  p = index( line, '(' );
-  q = index( line, ')' );
-  if( p && q && q > p )
-  {
-    ++p;
-    while( *p && p < q )
-    {
-      *s = *p;
-      ++p; ++s;
-    }
-    *s = '\0';
-  }
-  else
-  {
-    /*
-      If short description declaration is incorrect at first line
-      of description; then we take whole first line of description:
-     */
-    p = index( line, ':' ); ++p;
-    while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; }
-    strcpy( buf, p );
-  }
-}
-
-
-static int get_references_section( int *start, int *stop, unsigned int *cnt, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop || !cnt ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "REFERENCE COUNTER:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-
-        /* Get reference counter */
-        {
-          unsigned int count;
-          int          rc;
-
-          ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-          skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-          rc = sscanf( ln, "REFERENCE COUNTER: %u", &count );
-          if( rc == 1 && cnt != NULL )
-          {
-            *cnt = count;
-          }
-        }
-      }
-      if( (match = strstr( ln, "REQUIRES:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-static int get_requires_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "REQUIRES:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-      if( (match = strstr( ln, "PACKAGE DESCRIPTION:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-static int get_description_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "PACKAGE DESCRIPTION:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-      if( (match = strstr( ln, "RESTORE LINKS:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-static int get_restore_links_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "RESTORE LINKS:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-      if( (match = strstr( ln, "INSTALL SCRIPT:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-
-static int get_install_script_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "INSTALL SCRIPT:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-      if( (match = strstr( ln, "FILE LIST:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-
-static int get_file_list_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "FILE LIST:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 1 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-
-int read_pkginfo( FILE *log, struct package *package )
-{
-  int ret = -1;
-
-  char *ln   = NULL;
-  char *line = NULL;
-
-  char           *pkgname_pattern = "PACKAGE NAME:",
-                  *pkgver_pattern = "PACKAGE VERSION:",
-                    *arch_pattern = "ARCH:",
-              *distroname_pattern = "DISTRO:",
-               *distrover_pattern = "DISTRO VERSION:",
-                   *group_pattern = "GROUP:",
-                     *url_pattern = "URL:",
-                 *license_pattern = "LICENSE:",
-       *uncompressed_size_pattern = "UNCOMPRESSED SIZE:",
-             *total_files_pattern = "TOTAL FILES:";
-
-
-  if( !log || !package ) return ret;
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
-  {
-    FATAL_ERROR( "Cannot allocate memory" );
-  }
-
-  ++ret;
-
-  while( (ln = fgets( line, PATH_MAX, log )) )
-  {
-    char *match = NULL;
-
-    ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-    skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-    if( (match = strstr( ln, pkgname_pattern )) && match == ln ) /* at start of line only */
-    {
-      package->pkginfo->name = skip_spaces( ln + strlen( pkgname_pattern ) );
-    }
-    if( (match = strstr( ln, pkgver_pattern )) && match == ln )
-    {
-      package->pkginfo->version = skip_spaces( ln + strlen( pkgver_pattern ) );
-    }
-    if( (match = strstr( ln, arch_pattern )) && match == ln )
-    {
-      package->pkginfo->arch = skip_spaces( ln + strlen( arch_pattern ) );
-    }
-    if( (match = strstr( ln, distroname_pattern )) && match == ln )
-    {
-      package->pkginfo->distro_name = skip_spaces( ln + strlen( distroname_pattern ) );
-    }
-    if( (match = strstr( ln, distrover_pattern )) && match == ln )
-    {
-      package->pkginfo->distro_version = skip_spaces( ln + strlen( distrover_pattern ) );
-    }
-    if( (match = strstr( ln, group_pattern )) && match == ln )
-    {
-      package->pkginfo->group = skip_spaces( ln + strlen( group_pattern ) );
-    }
-    if( (match = strstr( ln, url_pattern )) && match == ln )
-    {
-      package->pkginfo->url = skip_spaces( ln + strlen( url_pattern ) );
-    }
-    if( (match = strstr( ln, license_pattern )) && match == ln )
-    {
-      package->pkginfo->license = skip_spaces( ln + strlen( license_pattern ) );
-    }
-    if( (match = strstr( ln, uncompressed_size_pattern )) && match == ln )
-    {
-      package->pkginfo->uncompressed_size = read_usize( ln + strlen( uncompressed_size_pattern ) );
-    }
-    if( (match = strstr( ln, total_files_pattern )) && match == ln )
-    {
-      package->pkginfo->total_files = read_total_files( ln + strlen( total_files_pattern ) );
-    }
-
-    if( (match = strstr( ln, "PACKAGE DESCRIPTION:" )) && match == ln )
-    {
-      char *buf = NULL;
-
-      buf = (char *)malloc( (size_t)PATH_MAX );
-      if( !buf )
-      {
-        FATAL_ERROR( "Cannot allocate memory" );
-      }
-
-      /* Get short_description from PACKAGE DESCRIPTION */
-      ln = fgets( line, PATH_MAX, log );
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol */
-
-      bzero( (void *)buf, PATH_MAX );
-      get_short_description( buf, (const char *)line );
-      if( buf[0] != '\0' )
-      {
-        package->pkginfo->short_description = strdup( buf );
-      }
-      free( buf );
-    }
-
-  } /* End of while() */
-
-  free( line );
-
-  if( package->pkginfo->name           == NULL ) ++ret;
-  if( package->pkginfo->version        == NULL ) ++ret;
-  if( package->pkginfo->arch           == NULL ) ++ret;
-  if( package->pkginfo->distro_name    == NULL ) ++ret;
-  if( package->pkginfo->distro_version == NULL ) ++ret;
-  /* group can be equal to NULL */
-
-  fseek( log, 0, SEEK_SET );
-
-  return( ret );
-}
-
-
-static unsigned int read_references( FILE *log, int start, unsigned int *cnt, struct package *package )
-{
-  char *ln   = NULL;
-  char *line = NULL;
-  char *p = NULL, *group = NULL, *name = NULL, *version = NULL;
-  int   n = 1;
-
-  unsigned int counter, pkgs = 0;
-
-  struct pkg *pkg = NULL;
-
-  if( !log || !cnt || *cnt == 0 || !package ) return pkgs;
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
-  {
-    FATAL_ERROR( "Cannot allocate memory" );
-  }
-
-  counter = *cnt;
-
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
-
-  n = 0;
-  while( (ln = fgets( line, PATH_MAX, log )) )
-  {
-    ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-    skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-    if( strstr( ln, "REQUIRES:" ) ) break; /* if cnt greater than real number of references */
-
-    if( n < counter )
-    {
-      if( (p = index( (const char *)ln, '=' )) )
-      {
-        *p = '\0'; version = ++p;
-        if( (p = index( (const char *)ln, '/' )) )
-        {
-          *p = '\0'; name = ++p; group = (char *)&ln[0];
-        }
-        else
-        {
-          name  = (char *)&ln[0]; group = NULL;
-        }
-
-        pkg = pkg_alloc();
-
-        if( group ) pkg->group = strdup( group );
-        pkg->name    = strdup( name );
-        pkg->version = strdup( version );
-
-        add_reference( package, pkg );
-        ++pkgs;
-      }
-      ++n;
-    }
-    else
-      break;
-  }
-
-  free( line );
-
-  fseek( log, 0, SEEK_SET );
-
-  *cnt = pkgs;
-
-  return pkgs;
-}
-
-
-static unsigned int read_requires( FILE *log, int start, int stop, struct package *package )
-{
-  char *ln   = NULL;
-  char *line = NULL;
-  char *p = NULL, *group = NULL, *name = NULL, *version = NULL;
-  int   n = 1;
-
-  unsigned int pkgs = 0;
-
-  struct pkg *pkg = NULL;
-
-  if( !log || !package ) return pkgs;
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
-  {
-    FATAL_ERROR( "Cannot allocate memory" );
-  }
-
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
-
-  if( start && start < stop )
-  {
-    ++n; /* skip section header */
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      if( strstr( ln, "PACKAGE DESCRIPTION:" ) ) break; /* if (stop - start - 1) greater than real number of requiress */
-
-      if( (n > start) && (n < stop) )
-      {
-        if( (p = index( (const char *)ln, '=' )) )
-        {
-          *p = '\0'; version = ++p;
-          if( (p = index( (const char *)ln, '/' )) )
-          {
-            *p = '\0'; name = ++p; group = (char *)&ln[0];
-          }
-          else
-          {
-            name  = (char *)&ln[0]; group = NULL;
-          }
-
-          pkg = pkg_alloc();
-
-          if( group ) pkg->group = strdup( group );
-          pkg->name    = strdup( name );
-          pkg->version = strdup( version );
-
-          add_required( package, pkg );
-          ++pkgs;
-        }
-
-      }
-      ++n;
-    }
-
-  } /* End if( start && start < stop ) */
-
-  free( line );
-
-  fseek( log, 0, SEEK_SET );
-
-  return pkgs;
-}
-
-
-static unsigned int read_description( FILE *log, int start, int stop, struct package *package )
-{
-  char *ln      = NULL;
-  char *line    = NULL;
-  char *pattern = NULL;
-  int   n = 1;
-
-  char  *tmp_fname = NULL;
-  FILE  *tmp = NULL;
-
-  unsigned int lines = 0;
-
-  if( !log || !package ) return lines;
-
-  tmp_fname = (char *)malloc( (size_t)PATH_MAX );
-  if( !tmp_fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  bzero( (void *)tmp_fname, PATH_MAX );
-  (void)sprintf( (char *)&tmp_fname[0], "%s/.DESCRIPTION", tmpdir );
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )    { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  pattern = (char *)malloc( (size_t)strlen( package->pkginfo->name ) + 2 );
-  if( !pattern ) { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  (void)sprintf( pattern, "%s:", package->pkginfo->name );
-
-
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
-
-  if( start && start < stop )
-  {
-    ++n; /* skip section header */
-
-    tmp = fopen( (const char *)&tmp_fname[0], "w" );
-    if( !tmp )
-    {
-      FATAL_ERROR( "Cannot create temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      if( strstr( ln, "RESTORE LINKS:" ) ) break; /* if (stop - start - 1) greater than real number of lines */
-
-      if( (n > start) && (n < stop) )
-      {
-        /*
-          skip non-significant spaces at beginning of line
-          and print lines started with 'pkgname:'
-         */
-        if( (match = strstr( ln, pattern )) && lines < DESCRIPTION_NUMBER_OF_LINES )
-        {
-          int mlen   = strlen( match ), plen = strlen( pattern );
-          int length = ( mlen > plen )  ? (mlen - plen - 1) : 0 ;
-
-          if( length > DESCRIPTION_LENGTH_OF_LINE )
-          {
-            /* WARNING( "Package DESCRIPTION contains lines with length greater than %d characters", DESCRIPTION_LENGTH_OF_LINE ); */
-            match[plen + 1 + DESCRIPTION_LENGTH_OF_LINE] = '\0'; /* truncating description line  */
-            skip_eol_spaces( match );                            /* remove spaces at end-of-line */
-          }
-          fprintf( tmp, "%s\n", match );
-          ++lines;
-        }
-
-      }
-      ++n;
-    }
-
-    if( lines < (unsigned int)DESCRIPTION_NUMBER_OF_LINES )
-    {
-      /* WARNING( "Package DESCRIPTION contains less than %d lines", DESCRIPTION_NUMBER_OF_LINES ); */
-      while( lines < (unsigned int)DESCRIPTION_NUMBER_OF_LINES )
-      {
-        fprintf( tmp, "%s\n", pattern );
-        ++lines;
-      }
-    }
-
-    fflush( tmp );
-    fclose( tmp );
-
-  } /* End if( start && start < stop ) */
-
-  free( pattern );
-  free( line );
-
-  fseek( log, 0, SEEK_SET );
-
-  /* read temporary saved description */
-  {
-    struct stat sb;
-    size_t size = 0;
-    int    fd;
-
-    char  *desc = NULL;
-
-    if( stat( tmp_fname, &sb ) == -1 )
-    {
-      FATAL_ERROR( "Cannot stat temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
-    size = (size_t)sb.st_size;
-
-    if( size )
-    {
-      ssize_t rc = 0;
-
-      desc = (char *)malloc( size + 1 );
-      if( !desc ) { FATAL_ERROR( "Cannot allocate memory" ); }
-      bzero( (void *)desc, size + 1 );
-
-      if( (fd = open( (const char *)&tmp_fname[0], O_RDONLY )) == -1 )
-      {
-        FATAL_ERROR( "Canot access temporary %s file: %s", basename( (char *)&tmp_fname[0] ), strerror( errno ) );
-      }
-
-      rc = read( fd, (void *)desc, size );
-      if( rc != (ssize_t)size )
-      {
-        ERROR( "The %s file is not fully read", basename( (char *)&tmp_fname[0] ) );
-      }
-
-      package->description = desc;
-
-      close( fd );
-    }
-
-  }
-
-  (void)unlink( tmp_fname );
-  free( tmp_fname );
-
-  return lines;
-}
-
-
-static unsigned int read_restore_links( FILE *log, int start, int stop, struct package *package )
-{
-  char *ln      = NULL;
-  char *line    = NULL;
-  int   n = 1;
-
-  char  *tmp_fname = NULL;
-  FILE  *tmp = NULL;
-
-  unsigned int lines = 0;
-
-  if( !log || !package ) return lines;
-
-  tmp_fname = (char *)malloc( (size_t)PATH_MAX );
-  if( !tmp_fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  bzero( (void *)tmp_fname, PATH_MAX );
-  (void)sprintf( (char *)&tmp_fname[0], "%s/.RESTORELINKS", tmpdir );
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )    { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
-
-  if( start && start < stop )
-  {
-    ++n; /* skip section header */
-
-    tmp = fopen( (const char *)&tmp_fname[0], "w" );
-    if( !tmp )
-    {
-      FATAL_ERROR( "Cannot create temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      if( strstr( ln, "INSTALL SCRIPT:" ) ) break; /* if (stop - start - 1) greater than real number of lines */
-
-      if( (n > start) && (n < stop) )
-      {
-        fprintf( tmp, "%s\n", ln );
-        ++lines;
-      }
-      ++n;
-    }
+  int ret = 0;
 
-    fflush( tmp );
-    fclose( tmp );
+  __done = 0; __child = 0;
 
-  } /* End if( start && start < stop ) */
+  _search_pkglogs( (const char *)pkgs_path, NULL );
 
-  free( line );
+  if( __child > 0 )
+  {
+    while( !__done ) usleep( 1 );
+    ret = __child;
+  }
 
-  fseek( log, 0, SEEK_SET );
+  __done = 0; __child = 0;
 
-  /* read temporary saved description */
-  {
-    struct stat sb;
-    size_t size = 0;
-    int    fd;
+  return ret;
+}
+/*
+  Enf of Copy functions.
+ ***********************************************************/
 
-    char  *links = NULL;
 
-    if( stat( tmp_fname, &sb ) == -1 )
-    {
-      FATAL_ERROR( "Cannot stat temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
-    size = (size_t)sb.st_size;
+/***********************************************************
+  Remove leading spaces and take non-space characters only:
+  (Especialy for pkginfo lines)
+ */
+static char *skip_spaces( char *s )
+{
+  char *q, *p = (char *)0;
 
-    if( size )
-    {
-      ssize_t rc = 0;
+  if( !s || *s == '\0' ) return p;
 
-      links = (char *)malloc( size + 1 );
-      if( !links ) { FATAL_ERROR( "Cannot allocate memory" ); }
-      bzero( (void *)links, size + 1 );
+  p = s;
 
-      if( (fd = open( (const char *)&tmp_fname[0], O_RDONLY )) == -1 )
-      {
-        FATAL_ERROR( "Canot access temporary %s file: %s", basename( (char *)&tmp_fname[0] ), strerror( errno ) );
-      }
+  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
+  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
 
-      rc = read( fd, (void *)links, size );
-      if( rc != (ssize_t)size )
-      {
-        ERROR( "The %s file is not fully read", basename( (char *)&tmp_fname[0] ) );
-      }
+  if( *p == '\0' ) return (char *)0;
 
-      package->restore_links = links;
+  return( strdup( p ) );
+}
 
-      close( fd );
-    }
 
-  }
+/*******************************
+  remove spaces at end of line:
+ */
+static void skip_eol_spaces( char *s )
+{
+  char *p = (char *)0;
 
-  (void)unlink( tmp_fname );
-  free( tmp_fname );
+  if( !s || *s == '\0' ) return;
 
-  return lines;
+  p = s + strlen( s ) - 1;
+  while( isspace( *p ) ) { *p-- = '\0'; }
 }
 
-
-static unsigned int read_install_script( FILE *log, int start, int stop, struct package *package )
+static struct pkg *input_package( const char *pkginfo_fname )
 {
   char *ln      = NULL;
   char *line    = NULL;
-  int   n = 1;
-
-  char  *tmp_fname = NULL;
-  FILE  *tmp = NULL;
-
-  unsigned int lines = 0;
 
-  if( !log || !package ) return lines;
-
-  tmp_fname = (char *)malloc( (size_t)PATH_MAX );
-  if( !tmp_fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  bzero( (void *)tmp_fname, PATH_MAX );
-  (void)sprintf( (char *)&tmp_fname[0], "%s/.INSTALL", tmpdir );
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )    { FATAL_ERROR( "Cannot allocate memory" ); }
+  FILE *pkginfo = NULL;
 
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
+  struct pkg *pkg = NULL;
+  char *pkgname = NULL, *pkgver = NULL, *group = NULL;
 
-  if( start && start < stop )
+  if( pkginfo_fname != NULL )
   {
-    ++n; /* skip section header */
-
-    tmp = fopen( (const char *)&tmp_fname[0], "w" );
-    if( !tmp )
+    pkginfo = fopen( (const char *)pkginfo_fname, "r" );
+    if( !pkginfo )
     {
-      FATAL_ERROR( "Cannot create temporary %s file", basename( (char *)&tmp_fname[0] ) );
+      FATAL_ERROR( "Cannot open %s file", pkginfo_fname );
     }
+  }
 
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      if( strstr( ln, "FILE LIST:" ) ) break; /* if (stop - start - 1) greater than real number of lines */
+  line = (char *)malloc( (size_t)PATH_MAX );
+  if( !line )
+  {
+    FATAL_ERROR( "Cannot allocate memory" );
+  }
 
-      if( (n > start) && (n < stop) )
-      {
-        fprintf( tmp, "%s\n", ln );
-        ++lines;
-      }
-      ++n;
-    }
+  while( (ln = fgets( line, PATH_MAX, pkginfo )) )
+  {
+    char *match = NULL;
 
-    fflush( tmp );
-    fclose( tmp );
+    ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
+    skip_eol_spaces( ln );     /* remove spaces at end-of-line */
 
-  } /* End if( start && start < stop ) */
+    if( (match = strstr( ln, "pkgname" )) && match == ln ) {
+      char *p = index( match, '=' ) + 1;
+      if( p != NULL ) pkgname = skip_spaces( p );
+    }
+    if( (match = strstr( ln, "pkgver" )) && match == ln ) {
+      char *p = index( match, '=' ) + 1;
+      if( p != NULL ) pkgver = skip_spaces( p );
+    }
+    if( (match = strstr( ln, "group" )) && match == ln ) {
+      char *p = index( match, '=' ) + 1;
+      if( p != NULL ) group = skip_spaces( p );
+    }
+  }
 
   free( line );
 
-  fseek( log, 0, SEEK_SET );
-
-  /* read temporary saved description */
+  if( pkgname && pkgver )
   {
-    struct stat sb;
-    size_t size = 0;
-    int    fd;
-
-    char  *install = NULL;
-
-    if( stat( tmp_fname, &sb ) == -1 )
-    {
-      FATAL_ERROR( "Cannot stat temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
-    size = (size_t)sb.st_size;
-
-    if( size )
+    pkg = pkg_alloc();
+    if( pkg )
     {
-      ssize_t rc = 0;
-
-      install = (char *)malloc( size + 1 );
-      if( !install ) { FATAL_ERROR( "Cannot allocate memory" ); }
-      bzero( (void *)install, size + 1 );
-
-      if( (fd = open( (const char *)&tmp_fname[0], O_RDONLY )) == -1 )
-      {
-        FATAL_ERROR( "Canot access temporary %s file: %s", basename( (char *)&tmp_fname[0] ), strerror( errno ) );
-      }
-
-      rc = read( fd, (void *)install, size );
-      if( rc != (ssize_t)size )
+      if( group )
       {
-        ERROR( "The %s file is not fully read", basename( (char *)&tmp_fname[0] ) );
+        pkg->group = pkglist_intern( group );
       }
-
-      package->install_script = install;
-
-      close( fd );
+      pkg->name    = pkglist_intern( pkgname );
+      pkg->version = pkglist_intern( pkgver );
     }
 
   }
 
-  (void)unlink( tmp_fname );
-  free( tmp_fname );
-
-  return lines;
-}
-
-
-static unsigned int read_file_list( FILE *log, int start, struct package *package )
-{
-  char *ln   = NULL;
-  char *line = NULL;
-  int   n = 1;
-
-  unsigned int files = 0;
+  if( group )      free( group );
+  if( pkgname )    free( pkgname );
+  if( pkgver )     free( pkgver );
 
-  if( !log || !package ) return files;
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
+  if( !pkg )
   {
-    FATAL_ERROR( "Cannot allocate memory" );
+    FATAL_ERROR( "Invalid input .PKGINFO file" );
   }
 
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
-
-  if( start )
-  {
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      add_file( package, (const char *)ln );
-      ++files;
-    }
-
-  } /* End if( start && start < stop ) */
-
-  free( line );
-
-  fseek( log, 0, SEEK_SET );
+  fclose( pkginfo );
 
-  return files;
+  return( pkg );
 }
 
 
-
 static void _read_pkglog( const char *group, const char *fname )
 {
-  FILE *log   = NULL;
   char *bname = NULL;
 
   if( fname != NULL )
-  {
-    log = fopen( (const char *)fname, "r" );
-    if( !log )
-    {
-      FATAL_ERROR( "Cannot open %s file", fname );
-    }
-    bname = (char *)fname + strlen( tmpdir ) + 1;
-  }
-
-  if( log != NULL )
   {
     struct package *package = NULL;
-    int             rc, start, stop;
-    unsigned int    counter;
+    int             rc;
+
+    bname = (char *)fname + strlen( tmpdir ) + 1;
 
     package = package_alloc();
 
-    if( read_pkginfo( log, package ) != 0 )
+    rc = read_pkglog( fname, package );
+    if( rc < 0 )
+    {
+      FATAL_ERROR( "Cannot open %s file", fname );
+    }
+    if( rc == PKGLOG_INVALID )
     {
-      ERROR( "%s: Invalid PKGLOG file", bname );
+      ERROR( "%s: %s", bname, pkglog_strerror( rc ) );
       package_free( package );
-      fclose( log );
       return;
     }
 
-    if( hardware ) package->hardware = strdup( hardware );
+    if( hardware ) package->hardware = pkglist_strdup( hardware );
     if( tarballs ) /* find tarball and allocate package->tarball */
     {
       struct pkginfo *info = package->pkginfo;
@@ -1985,7 +898,7 @@ static void _read_pkglog( const char *group, const char *fname )
       tgz = find_tarball( (const char *)&buf[0] );
       if( tgz )
       {
-        package->tarball = strdup( tgz );
+        package->tarball = pkglist_strdup( tgz );
 
         bzero( (void *)&buf[0], PATH_MAX );
         (void)sprintf( buf, "%s/%s", pkgs_path, tgz );
@@ -2009,138 +922,25 @@ static void _read_pkglog( const char *group, const char *fname )
       WARNING( "%s: Should be moved into '%s' subdir", tgz, package->pkginfo->group );
     }
 
-    /******************
-      read references:
-     */
-    rc = get_references_section( &start, &stop, &counter, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains REFERENCE COUNTER section", bname );
-      package_free( package );
-      fclose( log );
-      return;
-    }
-    if( counter > 0 )
-    {
-      unsigned int pkgs = counter;
-
-      if( read_references( log, start, &counter, package ) != pkgs )
-      {
-        ERROR( "%s: Invalid REFERENCE COUNTER section", bname );
-        package_free( package );
-        fclose( log );
-        return;
-      }
-    }
-
-    /******************
-      read requires:
-     */
-    rc = get_requires_section( &start, &stop, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains REQUIRES section", bname );
-      package_free( package );
-      fclose( log );
-      return;
-    }
-    if( (stop - start) > 1 )
-    {
-      unsigned int pkgs = (unsigned int)(stop - start - 1); /* -1 skips section header */
-
-      if( read_requires( log, start, stop, package ) != pkgs )
-      {
-        ERROR( "%s: Invalid REQUIRES section", bname );
-        package_free( package );
-        fclose( log );
-        return;
-      }
-    }
-
-    /*******************
-      read description:
-     */
-    rc = get_description_section( &start, &stop, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains PACKAGE DESCRIPTION section", bname );
-      package_free( package );
-      fclose( log );
-      return;
-    }
-    if( (stop - start) > 1 )
+    if( rc == PKGLOG_EMPTY_FILE_LIST )
     {
-      if( read_description( log, start, stop, package ) != (unsigned int)DESCRIPTION_NUMBER_OF_LINES )
+      /*
+        Packages that do not contain regular files are ignored.
+        For example, service package base/init-devices-1.2.3-s9xx-glibc-radix-1.1.txz
+       */
+      if( ! DO_NOT_PRINTOUT_INFO )
       {
-        ERROR( "%s: Invalid DESCRIPTION section", bname );
-        package_free( package );
-        fclose( log );
-        return;
+        INFO( "%s: %s", bname, pkglog_strerror( rc ) );
       }
-    }
-
-    /*********************
-      read restore links:
-     */
-    rc = get_restore_links_section( &start, &stop, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains RESTORE LINKS section", bname );
-      package_free( package );
-      fclose( log );
-      return;
-    }
-    if( (stop - start) > 1 )
-    {
-      (void)read_restore_links( log, start, stop, package );
-    }
-
-    /*********************
-      read install script:
-     */
-    rc = get_install_script_section( &start, &stop, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains INSTALL SCRIPT section", bname );
       package_free( package );
-      fclose( log );
       return;
     }
-    if( (stop - start) > 1 )
-    {
-      (void)read_install_script( log, start, stop, package );
-    }
-
-    /*****************
-      read file_list:
-     */
-    rc = get_file_list_section( &start, &stop, log );
-    if( rc != 0 )
+    if( rc != PKGLOG_OK )
     {
-      ERROR( "%s: PKGLOG doesn't contains FILE LIST section", bname );
+      ERROR( "%s: %s", bname, pkglog_strerror( rc ) );
       package_free( package );
-      fclose( log );
       return;
     }
-    if( start )
-    {
-      unsigned int files = read_file_list( log, start, package );
-      if( files == (unsigned int)0 )
-      {
-        /*
-          Packages that do not contain regular files are ignored.
-          For example, service package base/init-devices-1.2.3-s9xx-glibc-radix-1.1.txz
-         */
-        if( ! DO_NOT_PRINTOUT_INFO )
-        {
-          INFO( "%s: PKGLOG contains empty FILE LIST section", bname );
-        }
-        package_free( package );
-        fclose( log );
-        return;
-      }
-      package->pkginfo->total_files = (int)files;
-    }
 
     /*
       Здесь можно организовать проверку  пакета на предмет его
@@ -2150,7 +950,6 @@ static void _read_pkglog( const char *group, const char *fname )
     add_package( package );
 
     ++__child;
-    fclose( log );
   }
 }
 
@@ -2228,6 +1027,106 @@ int read_pkglogs( void )
 }
 
 
+/***************************************************************
+  Setup Database INDEX functions:
+ */
+static int check_pkgdb( struct pkgdb *db )
+{
+  uint32_t i;
+
+  /*
+    Invalid PKGLOGs should be reported as usual,
+    so we use the index only if all records are valid:
+   */
+  for( i = 0; i < pkgdb_count( db ); ++i )
+  {
+    if( !db->records[i].name ) return 0;
+  }
+  return 1;
+}
+
+static char *__pkgdb_strdup( const struct pkgdb *db, uint32_t offset )
+{
+  const char *s = pkgdb_string( db, offset );
+  return ( s ) ? pkglist_strdup( s ) : NULL;
+}
+
+static char *__pkgdb_intern( const struct pkgdb *db, uint32_t offset )
+{
+  const char *s = pkgdb_string( db, offset );
+  return ( s ) ? pkglist_intern( s ) : NULL;
+}
+
+/***********************************************************
+  read_pkgdb() - creates packages from the index of Setup
+                 Database. The PKGLOG of input package is
+                 already placed into TMPDIR and replaces
+                 the installed one. Returns number of
+                 added packages.
+ */
+static int read_pkgdb( struct pkgdb *db )
+{
+  char     *path = NULL;
+  uint32_t  i, j;
+  int       ret = 0;
+
+  path = (char *)malloc( (size_t)PATH_MAX );
+  if( !path ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( i = 0; i < pkgdb_count( db ); ++i )
+  {
+    const struct pkgdb_record *record = &db->records[i];
+    struct package *package = NULL;
+    struct pkginfo *info    = NULL;
+    struct stat     st;
+
+    /* Packages that do not contain regular files are ignored: */
+    if( !record->total_files ) continue;
+
+    (void)snprintf( path, PATH_MAX, "%s/%s", tmpdir, pkgdb_string( db, record->pkglog ) );
+    if( stat( (const char *)path, &st ) == 0 ) continue;
+
+    package = package_alloc();
+    info    = package->pkginfo;
+
+    info->name              = __pkgdb_intern( db, record->name );
+    info->version           = __pkgdb_intern( db, record->version );
+    info->arch              = __pkgdb_intern( db, record->arch );
+    info->distro_name       = __pkgdb_intern( db, record->distro_name );
+    info->distro_version    = __pkgdb_intern( db, record->distro_version );
+    info->group             = __pkgdb_intern( db, record->group );
+    info->short_description = __pkgdb_strdup( db, record->short_description );
+    info->total_files       = (int)record->total_files;
+
+    if( hardware ) package->hardware = pkglist_strdup( hardware );
+    package->procedure = INSTALL;
+    package->priority  = priority;
+
+    for( j = 0; j < record->nrequires; ++j )
+    {
+      const struct pkgdb_requires *requires = &db->requires[record->requires + j];
+      struct pkg *pkg = pkg_alloc();
+
+      pkg->group   = __pkgdb_intern( db, requires->group );
+      pkg->name    = __pkgdb_intern( db, requires->name );
+      pkg->version = __pkgdb_intern( db, requires->version );
+
+      add_required( package, pkg );
+    }
+
+    add_package( package );
+    ++ret;
+  }
+
+  free( path );
+
+  return ret;
+}
+/*
+  End of Setup Database INDEX functions.
+ ***************************************************************/
+
+
 static void check_pkg_fname( void )
 {
   struct stat st;
@@ -2545,6 +1444,7 @@ void set_stack_size( void )
 int main( int argc, char *argv[] )
 {
   gid_t  gid;
+  struct pkgdb *db = NULL;
 
   set_signal_handlers();
 
@@ -2568,7 +1468,15 @@ int main( int argc, char *argv[] )
     FATAL_ERROR( "Cannot create temporary directory" );
   }
 
+  /*********************************************************
+    If the index of Setup Database is up to date we don't
+    need to copy and parse all installed PKGLOGs:
+   */
+  db = pkgdb_open( (const char *)pkgs_path );
+  if( db && !check_pkgdb( db ) ) { pkgdb_close( db ); db = NULL; }
+
   /* Copy PKGLOGs into TMPDIR: */
+  if( !db )
   {
     int pkgs = copy_pkglogs();
     if( pkgs == 0 )       { FATAL_ERROR( "There are no PKGLOG files in the '%s' directory", pkgs_path ); }
@@ -2578,6 +1486,14 @@ int main( int argc, char *argv[] )
       INFO( "Found %d PKGLOG files in the '%s' directory", pkgs, pkgs_path );
     }
   }
+  else
+  {
+    if( pkgdb_count( db ) == 0 ) { FATAL_ERROR( "There are no PKGLOG files in the '%s' directory", pkgs_path ); }
+    if( ! DO_NOT_PRINTOUT_INFO )
+    {
+      INFO( "Found %d PKGLOG files in the '%s' directory", (int)pkgdb_count( db ), pkgs_path );
+    }
+  }
 
   /***********************************************************
     Fill srcpkg struct and put or replace pkglog into tmpdir:
@@ -2587,8 +1503,13 @@ int main( int argc, char *argv[] )
   /* Read PKGLOGs from TMPDIR and create Double Linked List of PACKAGES: */
   {
     int pkgs = read_pkglogs();
-    if( pkgs == 0 )       { FATAL_ERROR( "There are no PKGLOG files in the '%s' directory", tmpdir ); }
     if( exit_status > 0 ) { FATAL_ERROR( "Cannot read some PKGLOG file" ); }
+    if( db )
+    {
+      pkgs += read_pkgdb( db );
+      pkgdb_close( db );
+    }
+    if( pkgs == 0 )       { FATAL_ERROR( "There are no PKGLOG files in the '%s' directory", tmpdir ); }
     if( ! DO_NOT_PRINTOUT_INFO )
     {
       /* INFO( "Found %d PKGLOG files in the '%s' directory", pkgs, tmpdir ); */
@@ -51,6 +51,8 @@
 
 #include <msglog.h>
 #include <system.h>
+#include <pkgdb.h>
+#include <tarball.h>
 
 #define PROGRAM_NAME "chrefs"
 
@@ -95,6 +97,10 @@ static void free_requires( struct package **requires );
 
 struct package **requires = NULL;
 
+/* PKGLOGs changed in the Setup Database ([group/]fname): */
+static char     **changed  = NULL;
+static uint32_t   nchanged = 0;
+
 
 /********************************************
   LOCK FILE declarations:
@@ -123,6 +129,13 @@ void free_resources()
   if( pkglog_fname )   { free( pkglog_fname );   pkglog_fname   = NULL; }
   if( requires_fname ) { free( requires_fname ); requires_fname = NULL; }
 
+  if( changed )
+  {
+    uint32_t i;
+    for( i = 0; i < nchanged; ++i ) { free( changed[i] ); }
+    free( changed ); changed = NULL; nchanged = 0;
+  }
+
   FREE_PKGINFO_VARIABLES();
 }
 
@@ -528,12 +541,10 @@ static char uncompress[2] = { 0, 0 };
 static enum _pkglog_type check_pkglog_file( const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   uncompress[0] = '\0';
 
   if( stat( fname, &st ) == -1 )
@@ -541,8 +552,6 @@ static enum _pkglog_type check_pkglog_file( const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -561,47 +570,22 @@ static enum _pkglog_type check_pkglog_file( const char *fname )
     close( fd ); return PKGLOG_TEXT;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    uncompress[0] = 'x';
-    close( fd ); return PKGLOG_GZ;
-  }
-
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    uncompress[0] = 'j';
-    close( fd ); return PKGLOG_BZ2;
-  }
+  close( fd );
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
-  {
-    uncompress[0] = 'J';
-    close( fd ); return PKGLOG_XZ;
-  }
+  compression = tarball_compression( fname );
+  uncompress[0] = tarball_tar_option( compression );
 
-  if( pkglog_size > 262 )
+  switch( compression )
   {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return PKGLOG_TAR;
-    }
+    case TARBALL_GZIP:  return PKGLOG_GZ;
+    case TARBALL_BZIP2: return PKGLOG_BZ2;
+    case TARBALL_XZ:    return PKGLOG_XZ;
+    case TARBALL_NONE:  return PKGLOG_TAR;
+    default:
+      break;
   }
 
-  close( fd ); return PKGLOG_UNKNOWN;
+  return PKGLOG_UNKNOWN;
 }
 
 
@@ -1759,6 +1743,24 @@ static void _change_references( char *grp, char *name, char *version, const char
 }
 
 
+static void add_changed_pkglog( const char *grp, const char *fname )
+{
+  char *pkglog = NULL;
+
+  changed = (char **)realloc( (void *)changed, (size_t)(nchanged + 1) * sizeof(char *) );
+  if( !changed ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  pkglog = (char *)malloc( strlen( fname ) + ( ( grp ) ? strlen( grp ) + 1 : 0 ) + 1 );
+  if( !pkglog ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  if( grp )
+    (void)sprintf( pkglog, "%s/%s", grp, fname );
+  else
+    (void)sprintf( pkglog, "%s", fname );
+
+  changed[nchanged++] = pkglog;
+}
+
 static void _search_required_packages( const char *dirpath, const char *grp )
 {
   DIR    *dir;
@@ -1804,6 +1806,7 @@ static void _search_required_packages( const char *dirpath, const char *grp )
         if( find_requires( entry->d_name, grp ) )
         {
           _change_references( group, pkgname, pkgver, (const char *)path );
+          add_changed_pkglog( grp, (const char *)entry->d_name );
         }
       }
       if( S_ISDIR(entry_sb.st_mode) && grp == NULL )
@@ -1922,6 +1925,12 @@ int main( int argc, char *argv[] )
     /* We have non-empty list of REQUIRES in the 'requires_fname' file */
     requires = read_requires( (const char *)requires_fname, ret );
     _search_required_packages( (const char *)destination, NULL );
+
+    /* REFERENCE COUNTERs are changed; update existing index only: */
+    if( pkgdb_update( (const char *)destination, (const char * const *)changed, nchanged, 0 ) != 0 )
+    {
+      WARNING( "Cannot update the index of Setup Database" );
+    }
   }
 
   if( tmpdir ) { _rm_tmpdir( (const char *)tmpdir ); free( tmpdir ); }
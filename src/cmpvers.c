@@ -108,3 +108,64 @@ const char *max_version( const char *s1, const char *s2 )
   if( cmp_version( s1, s2 ) < 0 ) return s2;
   else                            return s1;
 }
+
+
+/*
+  Version KEYs:
+  ============
+
+    The key is a string which strcmp() orders exactly as cmp_version()
+    orders the versions. Non-digit characters are copied as is, digit
+    runs are replaced by:
+
+      - integral run (starts with nonzero digit): '1', the number of
+        digits and the digits. The '1' orders the run against other
+        characters as any nonzero digit does; equal placeholders make
+        the length to be compared first;
+
+      - fractional run (starts with '0'): the digits as is and 0xff
+        after the run if it consists of zeros only (in this state the
+        run which ends first is greater than the run which continues).
+
+    The keys have no zero bytes inside, so they are compared by strcmp().
+ */
+#define  KEY_INTEGRAL    '1'
+#define  KEY_ZEROS_END   0xff
+#define  KEY_MAX_DIGITS  0xfe
+
+size_t version_key( char *key, const char *version )
+{
+  const unsigned char *p = (const unsigned char *)version;
+  unsigned char       *k = (unsigned char *)key;
+
+  if( !key || !version ) return 0;
+
+  while( *p )
+  {
+    if( !isdigit( *p ) )
+    {
+      *k++ = *p++;
+    }
+    else if( *p != '0' )
+    {
+      const unsigned char *q = p;
+
+      while( isdigit( *q ) ) ++q;
+      if( q - p > KEY_MAX_DIGITS ) return 0;
+
+      *k++ = KEY_INTEGRAL;
+      *k++ = (unsigned char)(q - p);
+      while( p < q ) *k++ = *p++;
+    }
+    else
+    {
+      while( *p == '0' ) *k++ = *p++;
+
+      if( !isdigit( *p ) ) *k++ = KEY_ZEROS_END;
+      else while( isdigit( *p ) ) *k++ = *p++;
+    }
+  }
+  *k = '\0';
+
+  return (size_t)(k - (unsigned char *)key);
+}
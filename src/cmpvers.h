@@ -23,10 +23,23 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
+
 
 extern int cmp_version( const char *s1, const char *s2 );
 extern const char *max_version( const char *s1, const char *s2 );
 
+/*
+  Writes into KEY the string which strcmp() orders exactly as the
+  cmp_version() orders versions. The KEY buffer should have at least
+  VERSION_KEY_SIZE( strlen( version ) ) bytes. Returns the length of
+  KEY or 0 if the VERSION has too long digit run (more than 254 digits)
+  and should be compared by cmp_version():
+ */
+#define VERSION_KEY_SIZE( len )  ( 3 * (len) + 1 )
+
+extern size_t version_key( char *key, const char *version );
+
 
 #ifdef __cplusplus
 }  /* ... extern "C" */
@@ -144,11 +144,22 @@ struct dlist *dlist_find_data( struct dlist *list, DLCMPF cmp_func, const void *
 struct dlist *dlist_append( struct dlist *list, void *data )
 {
   struct dlist *node = NULL;
-  struct dlist *last = NULL;
 
   node = __dlist_alloc();
   node->data = data;
 
+  return dlist_append_link( list, node );
+}
+
+struct dlist *dlist_append_link( struct dlist *list, struct dlist *node )
+{
+  struct dlist *last = NULL;
+
+  if( !node ) return list;
+
+  dlist_next( node ) = NULL;
+  dlist_prev( node ) = NULL;
+
   if( list )
   {
     last = dlist_last( list );
@@ -490,15 +501,15 @@ struct dlist *dlist_remove_data_all( struct dlist *list, DLCMPF cmp_func, DLFUNC
 
 struct dlist *dlist_copy( struct dlist *list )
 {
-  struct dlist *copy = NULL;
+  struct dlist_head copy = DLIST_HEAD_INIT;
 
   while( list )
   {
-    copy = dlist_append( copy, list->data );
+    (void)dlist_head_append( &copy, list->data );
     list = dlist_next( list );
   }
 
-  return copy;
+  return dlist_head_detach( &copy );
 }
 
 /* It simply switches the next and prev pointers of each element. */
@@ -678,3 +689,163 @@ void dlist_free( struct dlist *list, DLFUNC free_func )
   dlist_foreach( list, free_func, NULL );
   __dlist_free( list );
 }
+
+
+/***************************************************************
+  List HEAD functions:
+ */
+void dlist_head_init( struct dlist_head *head )
+{
+  if( !head ) return;
+
+  head->first  = NULL;
+  head->last   = NULL;
+  head->length = 0;
+}
+
+void dlist_head_attach( struct dlist_head *head, struct dlist *list )
+{
+  if( !head ) return;
+
+  head->first  = dlist_first( list );
+  head->last   = NULL;
+  head->length = 0;
+
+  list = head->first;
+  while( list )
+  {
+    head->last = list;
+    ++head->length;
+    list = dlist_next( list );
+  }
+}
+
+struct dlist *dlist_head_detach( struct dlist_head *head )
+{
+  struct dlist *list = NULL;
+
+  if( !head ) return list;
+
+  list = head->first;
+  dlist_head_init( head );
+
+  return list;
+}
+
+struct dlist *dlist_head_append( struct dlist_head *head, void *data )
+{
+  struct dlist *node = NULL;
+
+  if( !head ) return node;
+
+  node = __dlist_alloc();
+  node->data = data;
+
+  return dlist_head_append_link( head, node );
+}
+
+struct dlist *dlist_head_append_link( struct dlist_head *head, struct dlist *node )
+{
+  if( !head || !node ) return node;
+
+  dlist_next( node ) = NULL;
+  dlist_prev( node ) = NULL;
+
+  if( head->last )
+  {
+    dlist_next( head->last ) = node;
+    dlist_prev( node ) = head->last;
+  }
+  else
+  {
+    head->first = node;
+  }
+  head->last = node;
+  ++head->length;
+
+  return node;
+}
+
+struct dlist *dlist_head_prepend( struct dlist_head *head, void *data )
+{
+  struct dlist *node = NULL;
+
+  if( !head ) return node;
+
+  node = __dlist_alloc();
+  node->data = data;
+
+  if( head->first )
+  {
+    dlist_prev( head->first ) = node;
+    dlist_next( node ) = head->first;
+  }
+  else
+  {
+    head->last = node;
+  }
+  head->first = node;
+  ++head->length;
+
+  return node;
+}
+
+/* Unlinks the node from the list. The node is not freed. */
+void dlist_head_remove_link( struct dlist_head *head, struct dlist *link )
+{
+  if( !head || !link ) return;
+
+  if( link == head->last ) head->last = dlist_prev( link );
+  head->first = __dlist_remove_link( head->first, link );
+  --head->length;
+}
+
+void dlist_head_remove( struct dlist_head *head, const void *data )
+{
+  struct dlist *ptr = NULL;
+
+  if( !head ) return;
+
+  if( (ptr = dlist_find( head->first, data )) )
+  {
+    dlist_head_remove_link( head, ptr );
+    free( ptr );
+  }
+}
+
+void dlist_head_remove_data( struct dlist_head *head, DLCMPF cmp_func, DLFUNC free_func, const void *data )
+{
+  struct dlist *ptr = NULL;
+
+  if( !head || !cmp_func ) return;
+
+  if( (ptr = dlist_find_data( head->first, cmp_func, data )) )
+  {
+    dlist_head_remove_link( head, ptr );
+    if( free_func ) free_func( ptr->data, (void *)data ); /* free_func() can compare pointers */
+    free( ptr );
+  }
+}
+
+void dlist_head_sort( struct dlist_head *head, DLCMPF cmp_func )
+{
+  if( !head ) return;
+
+  dlist_head_attach( head, dlist_sort( head->first, cmp_func ) );
+}
+
+void dlist_head_foreach( struct dlist_head *head, DLFUNC func, void *user_data )
+{
+  if( head ) { dlist_foreach( head->first, func, user_data ); }
+}
+
+void dlist_head_free( struct dlist_head *head, DLFUNC free_func )
+{
+  if( !head ) return;
+
+  dlist_free( head->first, free_func );
+  dlist_head_init( head );
+}
+/*
+  End of List HEAD functions.
+ ***************************************************************/
@@ -38,6 +38,31 @@ typedef int  (*DLCMPDF) ( const void *a, const void *b, void *user_data );
 #define dlist_prev( list )  ( (list)->prev )
 #define dlist_next( list )  ( (list)->next )
 
+
+/***************************************************************
+  List HEAD:
+  =========
+
+    The container which holds the first and the last nodes of
+    the list together with the number of nodes. It allows O(1)
+    append, length and last operations on long lists such  as
+    FILE LISTs of packages or the list of repository packages.
+    Nodes are ordinary dlist nodes and the dlist_first( head )
+    list can be passed to any dlist_*() read-only function.
+ */
+struct dlist_head {
+  struct dlist *first;
+  struct dlist *last;
+
+  int    length;
+};
+
+#define DLIST_HEAD_INIT  { NULL, NULL, 0 }
+
+#define dlist_head_first( head )   ( (head)->first )
+#define dlist_head_last( head )    ( (head)->last )
+#define dlist_head_length( head )  ( (head)->length )
+
 extern struct dlist *__dlist_alloc( void );
 extern struct dlist *dlist_first( struct dlist *list );
 extern struct dlist *dlist_last( struct dlist *list );
@@ -50,6 +75,7 @@ extern struct dlist *dlist_find( struct dlist *list, const void *data );
 extern struct dlist *dlist_find_data( struct dlist *list, DLCMPF func, const void *data );
 
 extern struct dlist *dlist_append( struct dlist *list, void *data );
+extern struct dlist *dlist_append_link( struct dlist *list, struct dlist *node ); /* NODE is allocated by caller */
 extern struct dlist *dlist_prepend( struct dlist *list, void *data );
 extern struct dlist *dlist_insert( struct dlist *list, void *data, int position );
 extern struct dlist *dlist_insert_sorted( struct dlist *list, DLCMPF cmp_func, void *data );
@@ -76,6 +102,24 @@ extern void __dlist_free( struct dlist *list );
 extern void dlist_free( struct dlist *list, DLFUNC free_func );
 
 
+extern void dlist_head_init( struct dlist_head *head );
+extern void dlist_head_attach( struct dlist_head *head, struct dlist *list );
+extern struct dlist *dlist_head_detach( struct dlist_head *head );
+
+extern struct dlist *dlist_head_append( struct dlist_head *head, void *data );
+extern struct dlist *dlist_head_append_link( struct dlist_head *head, struct dlist *node );
+extern struct dlist *dlist_head_prepend( struct dlist_head *head, void *data );
+
+extern void dlist_head_remove_link( struct dlist_head *head, struct dlist *link );
+extern void dlist_head_remove( struct dlist_head *head, const void *data );
+extern void dlist_head_remove_data( struct dlist_head *head, DLCMPF cmp_func, DLFUNC free_func, const void *data );
+
+extern void dlist_head_sort( struct dlist_head *head, DLCMPF cmp_func );
+extern void dlist_head_foreach( struct dlist_head *head, DLFUNC func, void *user_data );
+
+extern void dlist_head_free( struct dlist_head *head, DLFUNC free_func );
+
+
 #ifdef __cplusplus
 }  /* ... extern "C" */
 #endif
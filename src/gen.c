@@ -0,0 +1,794 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+/***************************************************************
+  Synthetic repository generator:
+  ==============================
+
+    Creates N fake packages (PKGLOGs or .txz packages made by the
+    make-package utility) and optionally the Setup Database of a
+    root file system where all of them are installed. Used for
+    scale testing of make-pkglist, check-db-integrity, install-
+    pkglist and other utilities in a --root sandbox. Built by the
+    'make bench' command; not installed.
+
+    Each package requires up to R packages generated before it,
+    so the requires graph has no cycles.
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <limits.h>
+#include <string.h>   /* strdup(3)   */
+#include <strings.h>  /* index(3)    */
+#include <libgen.h>   /* basename(3) */
+#include <ctype.h>    /* toupper(3)  */
+#include <errno.h>
+#include <unistd.h>
+
+#define _GNU_SOURCE
+#include <getopt.h>
+
+#include <msglog.h>
+#include <system.h>
+
+#include <pkgdb.h>
+
+#define PROGRAM_NAME "pkgtools-gen"
+
+#include <defs.h>
+
+
+char *program     = PROGRAM_NAME;
+int   exit_status = EXIT_SUCCESS; /* errors counter */
+char *selfdir     = NULL;
+
+static char *destination = NULL, *root = NULL, *tmpdir = NULL;
+static char *arch = NULL;
+
+static int packages     = 100;
+static int files        = 20;
+static int max_requires = 4;
+static int version_skew = 0; /* percent of requires of older versions */
+static unsigned int seed = 1;
+static int service_first = 0; /* layout of .txz packages */
+
+static char **groups  = NULL;
+static int    ngroups = 0;
+
+enum _output_format {
+  OFMT_LOG = 0,
+  OFMT_TXZ,
+
+  OFMT_UNKNOWN
+} output_format = OFMT_LOG;
+
+struct fake_package
+{
+  const char *group;
+  char       *name;
+  char       *version;
+
+  int        *requires;  /* indexes of required packages     */
+  char      **versions;  /* required versions                */
+  int         nrequires;
+
+  int        *references; /* indexes of packages which require this one */
+  int         nreferences;
+};
+
+static struct fake_package *fakes = NULL;
+
+
+static void free_fakes( void )
+{
+  int i, j;
+
+  if( !fakes ) return;
+
+  for( i = 0; i < packages; ++i )
+  {
+    if( fakes[i].name )    free( fakes[i].name );
+    if( fakes[i].version ) free( fakes[i].version );
+    for( j = 0; j < fakes[i].nrequires; ++j ) free( fakes[i].versions[j] );
+    if( fakes[i].versions )   free( fakes[i].versions );
+    if( fakes[i].requires )   free( fakes[i].requires );
+    if( fakes[i].references ) free( fakes[i].references );
+  }
+  free( fakes ); fakes = NULL;
+}
+
+static void free_groups( void )
+{
+  int i;
+
+  if( !groups ) return;
+
+  for( i = 0; i < ngroups; ++i ) free( groups[i] );
+  free( groups ); groups = NULL; ngroups = 0;
+}
+
+void free_resources()
+{
+  if( selfdir )     { free( selfdir );     selfdir     = NULL; }
+  if( destination ) { free( destination ); destination = NULL; }
+  if( root )        { free( root );        root        = NULL; }
+  if( arch )        { free( arch );        arch        = NULL; }
+
+  free_fakes();
+  free_groups();
+}
+
+void usage()
+{
+  free_resources();
+
+  fprintf( stdout, "\n" );
+  fprintf( stdout, "Usage: %s [options] <destination>\n", program );
+  fprintf( stdout, "\n" );
+  fprintf( stdout, "Create synthetic packages in the DESTINATION directory (in GROUP sub-\n" );
+  fprintf( stdout, "directories) to test utilities on repositories of any size.\n" );
+  fprintf( stdout, "\n" );
+  fprintf( stdout, "Options:\n" );
+  fprintf( stdout, "  -h,--help                     Display this information.\n" );
+  fprintf( stdout, "  -v,--version                  Display the version of %s utility.\n", program );
+  fprintf( stdout, "  -n,--packages=<N>             Number of packages (default: 100).\n" );
+  fprintf( stdout, "  -f,--files=<N>                Number of files in each package\n" );
+  fprintf( stdout, "                                (default: 20).\n" );
+  fprintf( stdout, "  -q,--requires=<N>             Maximal number of required packages\n" );
+  fprintf( stdout, "                                of each package (default: 4).\n" );
+  fprintf( stdout, "  -g,--groups=<LIST>            Comma separated list of groups\n" );
+  fprintf( stdout, "                                (default: base,libs,dev,app,net,X11).\n" );
+  fprintf( stdout, "  -k,--version-skew=<PERCENT>   Percent of requires which declare older\n" );
+  fprintf( stdout, "                                versions than provided (default: 0).\n" );
+  fprintf( stdout, "  -s,--seed=<N>                 Seed of random numbers (default: 1).\n" );
+  fprintf( stdout, "  -a,--arch=<ARCH>              Architecture of packages\n" );
+  fprintf( stdout, "                                (default: x86_64-glibc).\n" );
+  fprintf( stdout, "  -o,--output=<log|txz>         Create PKGLOG files (default) or .txz\n" );
+  fprintf( stdout, "                                packages by make-package utility.\n" );
+  fprintf( stdout, "  -l,--layout=<std|service>     Layout of .txz packages: standard layout\n" );
+  fprintf( stdout, "                                of make-package (default) or service\n" );
+  fprintf( stdout, "                                files at the beginning of package.\n" );
+  fprintf( stdout, "  -r,--root=<DIR>               Also create the Setup Database in the\n" );
+  fprintf( stdout, "                                '<DIR>/%s/'\n", PACKAGES_PATH );
+  fprintf( stdout, "                                directory where all packages are\n" );
+  fprintf( stdout, "                                installed (files are not created).\n" );
+  fprintf( stdout, "\n" );
+  fprintf( stdout, "Parameter:\n" );
+  fprintf( stdout, "  <destination>                 Directory to save packages.\n"  );
+  fprintf( stdout, "\n" );
+
+  exit( EXIT_FAILURE );
+}
+
+void to_uppercase( char *s )
+{
+  char *p = s;
+  while( *p ) { *p = toupper( *p ); p++; }
+}
+
+void version()
+{
+  char *upper = NULL;
+
+  upper = (char *)alloca( strlen( program ) + 1 );
+
+  strcpy( (char *)upper, (const char *)program );
+  to_uppercase( upper );
+
+  fprintf( stdout, "%s (%s) %s\n", program, upper, PROGRAM_VERSION );
+
+  fprintf( stdout, "Copyright (C) 2019 Andrey V.Kosteltsev.\n" );
+  fprintf( stdout, "This is free software.   There is NO warranty; not even\n" );
+  fprintf( stdout, "for MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.\n" );
+  fprintf( stdout, "\n" );
+
+  free_resources();
+  exit( EXIT_SUCCESS );
+}
+
+
+static void remove_trailing_slash( char *dir )
+{
+  char *s;
+
+  if( !dir || dir[0] == '\0' ) return;
+
+  s = dir + strlen( dir ) - 1;
+  while( *s == '/' )
+  {
+    *s = '\0'; --s;
+  }
+}
+
+static int _mkdir_p( const char *dir, const mode_t mode )
+{
+  char  *buf;
+  char  *p = NULL;
+  struct stat sb;
+
+  if( !dir ) return -1;
+
+  buf = (char *)alloca( strlen( dir ) + 1 );
+  strcpy( buf, dir );
+
+  remove_trailing_slash( buf );
+
+  /* check if path exists and is a directory */
+  if( stat( buf, &sb ) == 0 )
+  {
+    if( S_ISDIR(sb.st_mode) )
+    {
+      return 0;
+    }
+  }
+
+  /* mkdir -p */
+  for( p = buf + 1; *p; ++p )
+  {
+    if( *p == '/' )
+    {
+      *p = 0;
+      /* test path */
+      if( stat( buf, &sb ) != 0 )
+      {
+        /* path does not exist - create directory */
+        if( mkdir( buf, mode ) < 0 )
+        {
+          return -1;
+        }
+      } else if( !S_ISDIR(sb.st_mode) )
+      {
+        /* not a directory */
+        return -1;
+      }
+      *p = '/';
+    }
+  }
+
+  /* test path */
+  if( stat( buf, &sb ) != 0 )
+  {
+    /* path does not exist - create directory */
+    if( mkdir( buf, mode ) < 0 )
+    {
+      return -1;
+    }
+  } else if( !S_ISDIR(sb.st_mode) )
+  {
+    /* not a directory */
+    return -1;
+  }
+
+  return 0;
+}
+
+static int read_number( const char *optarg )
+{
+  char *end = NULL;
+  long  n;
+
+  if( !optarg ) usage();
+
+  n = strtol( optarg, &end, 10 );
+  if( !end || *end != '\0' || n < 0 || n > INT_MAX ) usage();
+
+  return (int)n;
+}
+
+static void read_groups( const char *optarg )
+{
+  char *list, *p, *q;
+
+  free_groups();
+
+  list = (char *)alloca( strlen( optarg ) + 1 );
+  strcpy( list, optarg );
+
+  for( p = list; p; p = q )
+  {
+    if( (q = index( p, ',' )) ) *q++ = '\0';
+    if( *p == '\0' ) continue;
+
+    groups = (char **)realloc( groups, sizeof(char *) * (size_t)(ngroups + 1) );
+    if( !groups ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    groups[ngroups++] = strdup( p );
+  }
+
+  if( !ngroups ) usage();
+}
+
+void get_args( int argc, char *argv[] )
+{
+  const char* short_options = "hvn:f:q:g:k:s:a:o:l:r:";
+
+  const struct option long_options[] =
+  {
+    { "help",         no_argument,       NULL, 'h' },
+    { "version",      no_argument,       NULL, 'v' },
+    { "packages",     required_argument, NULL, 'n' },
+    { "files",        required_argument, NULL, 'f' },
+    { "requires",     required_argument, NULL, 'q' },
+    { "groups",       required_argument, NULL, 'g' },
+    { "version-skew", required_argument, NULL, 'k' },
+    { "seed",         required_argument, NULL, 's' },
+    { "arch",         required_argument, NULL, 'a' },
+    { "output",       required_argument, NULL, 'o' },
+    { "layout",       required_argument, NULL, 'l' },
+    { "root",         required_argument, NULL, 'r' },
+    { NULL,           0,                 NULL,  0  }
+  };
+
+  int ret;
+  int option_index = 0;
+
+  while( (ret = getopt_long( argc, argv, short_options, long_options, &option_index )) != -1 )
+  {
+    switch( ret )
+    {
+      case 'h':
+      {
+        usage();
+        break;
+      }
+      case 'v':
+      {
+        version();
+        break;
+      }
+
+      case 'n': packages     = read_number( optarg ); break;
+      case 'f': files        = read_number( optarg ); break;
+      case 'q': max_requires = read_number( optarg ); break;
+      case 's': seed         = (unsigned int)read_number( optarg ); break;
+      case 'k':
+      {
+        version_skew = read_number( optarg );
+        if( version_skew > 100 ) usage();
+        break;
+      }
+
+      case 'g':
+      {
+        if( optarg != NULL )
+          read_groups( optarg );
+        else
+          /* option is present but without value */
+          usage();
+        break;
+      }
+
+      case 'a':
+      {
+        if( optarg != NULL )
+        {
+          if( arch ) free( arch );
+          arch = strdup( optarg );
+        }
+        else
+          /* option is present but without value */
+          usage();
+        break;
+      }
+
+      case 'o':
+      {
+        if( optarg != NULL )
+        {
+          if( !strcmp( optarg, "log" ) )      output_format = OFMT_LOG;
+          else if( !strcmp( optarg, "txz" ) ) output_format = OFMT_TXZ;
+          else
+            usage();
+        }
+        else
+          /* option is present but without value */
+          usage();
+        break;
+      }
+
+      case 'l':
+      {
+        if( optarg != NULL )
+        {
+          if( !strcmp( optarg, "std" ) )          service_first = 0;
+          else if( !strcmp( optarg, "service" ) ) service_first = 1;
+          else
+            usage();
+        }
+        else
+          /* option is present but without value */
+          usage();
+        break;
+      }
+
+      case 'r':
+      {
+        if( optarg != NULL )
+        {
+          root = strdup( optarg );
+          remove_trailing_slash( root );
+        }
+        else
+          /* option is present but without value */
+          usage();
+        break;
+      }
+
+      case '?': default:
+      {
+        usage();
+        break;
+      }
+    }
+  }
+
+  if( optind < argc )
+  {
+    destination = strdup( (const char *)argv[optind] );
+    remove_trailing_slash( destination );
+  }
+  else
+  {
+    usage();
+  }
+
+  if( !packages ) usage();
+
+  if( !groups ) read_groups( "base,libs,dev,app,net,X11" );
+  if( !arch )   arch = strdup( "x86_64-glibc" );
+}
+
+
+char *get_selfdir( void )
+{
+  char    *buf = NULL;
+  ssize_t  len;
+
+  buf = (char *)malloc( PATH_MAX );
+  if( !buf )
+  {
+    FATAL_ERROR( "Cannot allocate memory" );
+  }
+
+  bzero( (void *)buf, PATH_MAX );
+  len = readlink( "/proc/self/exe", buf, (size_t)PATH_MAX );
+  if( len > 0 && len < PATH_MAX )
+  {
+    char *p = strdup( dirname( buf ) );
+    free( buf );
+    return p;
+  }
+  return (char *)NULL;
+}
+
+
+/***************************************************************
+  Requires graph:
+ */
+static void __add_reference( struct fake_package *fake, int index )
+{
+  fake->references = (int *)realloc( fake->references, sizeof(int) * (size_t)(fake->nreferences + 1) );
+  if( !fake->references ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  fake->references[fake->nreferences++] = index;
+}
+
+static void create_fakes( void )
+{
+  char buf[64];
+  int  i, j, k;
+
+  fakes = (struct fake_package *)calloc( (size_t)packages, sizeof(struct fake_package) );
+  if( !fakes ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  srand( seed );
+
+  for( i = 0; i < packages; ++i )
+  {
+    struct fake_package *fake = &fakes[i];
+    int                  n;
+
+    fake->group = groups[i % ngroups];
+    (void)sprintf( buf, "pkg%d", i );
+    fake->name = strdup( buf );
+    (void)sprintf( buf, "1.%d.%d", (i / 13) % 7, i % 13 );
+    fake->version = strdup( buf );
+
+    n = ( i && max_requires ) ? rand() % ((i < max_requires ? i : max_requires) + 1) : 0;
+
+    fake->requires = (int *)calloc( (size_t)n + 1, sizeof(int) );
+    fake->versions = (char **)calloc( (size_t)n + 1, sizeof(char *) );
+    if( !fake->requires || !fake->versions ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+    for( j = 0; j < n; ++j )
+    {
+      int r = rand() % i, dup = 0;
+
+      for( k = 0; k < fake->nrequires; ++k ) if( fake->requires[k] == r ) dup = 1;
+      if( dup ) continue;
+
+      if( rand() % 100 < version_skew )
+      {
+        /* declare older version than provided: */
+        (void)sprintf( buf, "1.%d.0", ((r / 13) % 7) / 2 );
+        fake->versions[fake->nrequires] = strdup( buf );
+      }
+      else
+      {
+        fake->versions[fake->nrequires] = strdup( fakes[r].version );
+      }
+      fake->requires[fake->nrequires++] = r;
+
+      __add_reference( &fakes[r], i );
+    }
+  }
+}
+/*
+  End of requires graph.
+ ***************************************************************/
+
+
+/***************************************************************
+  Output functions:
+ */
+static void write_pkgtool_file( const char *fname, const char *content )
+{
+  FILE *output = fopen( fname, "w" );
+
+  if( !output ) { FATAL_ERROR( "Cannot create %s file", fname ); }
+  fprintf( output, "%s", content );
+  fclose( output );
+}
+
+static void write_requires( FILE *output, struct fake_package *fake )
+{
+  int j;
+
+  for( j = 0; j < fake->nrequires; ++j )
+  {
+    struct fake_package *req = &fakes[fake->requires[j]];
+    fprintf( output, "%s/%s=%s\n", req->group, req->name, fake->versions[j] );
+  }
+}
+
+static void write_description( FILE *output, struct fake_package *fake, int index )
+{
+  int n;
+
+  fprintf( output, "%s: %s %s (synthetic package %d)\n", fake->name, fake->name, fake->version, index );
+  fprintf( output, "%s:\n", fake->name );
+  fprintf( output, "%s: The package is created by %s utility for testing.\n", fake->name, program );
+  for( n = 3; n < DESCRIPTION_NUMBER_OF_LINES; ++n )
+    fprintf( output, "%s:\n", fake->name );
+}
+
+static const char *install_script = "#!/bin/sh\n"
+                                    "\n"
+                                    "# arguments: $1 = operation, $2 = version\n"
+                                    "\n"
+                                    "exit 0\n";
+
+/*
+  Writes the PKGLOG in the format of pkglog utility. For installed
+  packages (REFERENCES is not zero) the list of packages which
+  require this one is written after the REFERENCE COUNTER.
+ */
+static void write_pkglog( const char *dir, struct fake_package *fake, int index, int references )
+{
+  char  fname[PATH_MAX];
+  FILE *output;
+  int   n;
+
+  (void)snprintf( fname, PATH_MAX, "%s/%s", dir, fake->group );
+  if( _mkdir_p( fname, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
+  {
+    FATAL_ERROR( "Cannot create %s directory", fname );
+  }
+
+  (void)snprintf( fname, PATH_MAX, "%s/%s/%s-%s-%s-%s-%s", dir, fake->group,
+                  fake->name, fake->version, arch, DISTRO_NAME, DISTRO_VERSION );
+  output = fopen( fname, "w" );
+  if( !output ) { FATAL_ERROR( "Cannot create %s file", fname ); }
+
+  fprintf( output, "PACKAGE NAME: %s\n",    fake->name    );
+  fprintf( output, "PACKAGE VERSION: %s\n", fake->version );
+  fprintf( output, "ARCH: %s\n",            arch          );
+  fprintf( output, "DISTRO: %s\n",          DISTRO_NAME   );
+  fprintf( output, "DISTRO VERSION: %s\n",  DISTRO_VERSION );
+  fprintf( output, "GROUP: %s\n",           fake->group   );
+  fprintf( output, "URL: %s\n",             DISTRO_URL    );
+  fprintf( output, "LICENSE: %s\n",         DISTRO_LICENSE );
+  fprintf( output, "UNCOMPRESSED SIZE: %dK\n", 12 + files / 32 ); /* about as make-package counts */
+  fprintf( output, "TOTAL FILES: %d\n",     files );
+
+  if( references )
+  {
+    fprintf( output, "REFERENCE COUNTER: %d\n", fake->nreferences );
+    for( n = 0; n < fake->nreferences; ++n )
+    {
+      struct fake_package *ref = &fakes[fake->references[n]];
+      fprintf( output, "%s/%s=%s\n", ref->group, ref->name, ref->version );
+    }
+  }
+  else
+  {
+    fprintf( output, "REFERENCE COUNTER: 0\n" );
+  }
+
+  fprintf( output, "REQUIRES:\n" );
+  write_requires( output, fake );
+
+  fprintf( output, "PACKAGE DESCRIPTION:\n" );
+  write_description( output, fake, index );
+
+  fprintf( output, "RESTORE LINKS:\n" );
+  fprintf( output, "INSTALL SCRIPT:\n" );
+  fprintf( output, "%s", install_script );
+
+  fprintf( output, "FILE LIST:\n" );
+  fprintf( output, "usr/\n" );
+  fprintf( output, "usr/share/\n" );
+  fprintf( output, "usr/share/%s/\n", fake->name );
+  for( n = 0; n < files; ++n )
+    fprintf( output, "usr/share/%s/file%06d\n", fake->name, n );
+
+  fclose( output );
+}
+
+/*
+  Creates the source package directory and calls make-package
+  utility to create the .txz package in the DESTINATION/GROUP:
+ */
+static void write_package( struct fake_package *fake, int index )
+{
+  char  dir[PATH_MAX], fname[PATH_MAX + 32], cmd[3 * PATH_MAX];
+  char  errmsg[PATH_MAX];
+  FILE *output;
+  pid_t p;
+  int   n, rc;
+
+  (void)snprintf( dir, PATH_MAX, "%s/%s", tmpdir, fake->name );
+  (void)snprintf( fname, sizeof(fname), "%s/usr/share/%s", dir, fake->name );
+  if( _mkdir_p( fname, S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH ) != 0 )
+  {
+    FATAL_ERROR( "Cannot create %s directory", fname );
+  }
+
+  for( n = 0; n < files; ++n )
+  {
+    (void)snprintf( fname, sizeof(fname), "%s/usr/share/%s/file%06d", dir, fake->name, n );
+    output = fopen( fname, "w" );
+    if( !output ) { FATAL_ERROR( "Cannot create %s file", fname ); }
+    fprintf( output, "%s-%s: file %d\n", fake->name, fake->version, n );
+    fclose( output );
+  }
+
+  (void)snprintf( fname, sizeof(fname), "%s/.PKGINFO", dir );
+  output = fopen( fname, "w" );
+  if( !output ) { FATAL_ERROR( "Cannot create %s file", fname ); }
+  fprintf( output, "pkgname=%s\n",    fake->name    );
+  fprintf( output, "pkgver=%s\n",     fake->version );
+  fprintf( output, "arch=%s\n",       arch          );
+  fprintf( output, "distroname=%s\n", DISTRO_NAME   );
+  fprintf( output, "distrover=%s\n",  DISTRO_VERSION );
+  fprintf( output, "group=%s\n",      fake->group   );
+  fprintf( output, "short_description=\"synthetic package %d\"\n", index );
+  fclose( output );
+
+  (void)snprintf( fname, sizeof(fname), "%s/.REQUIRES", dir );
+  output = fopen( fname, "w" );
+  if( !output ) { FATAL_ERROR( "Cannot create %s file", fname ); }
+  write_requires( output, fake );
+  fclose( output );
+
+  (void)snprintf( fname, sizeof(fname), "%s/.DESCRIPTION", dir );
+  output = fopen( fname, "w" );
+  if( !output ) { FATAL_ERROR( "Cannot create %s file", fname ); }
+  write_description( output, fake, index );
+  fclose( output );
+
+  (void)snprintf( fname, sizeof(fname), "%s/.INSTALL", dir );
+  write_pkgtool_file( fname, install_script );
+
+  (void)snprintf( cmd, sizeof(cmd), "%s/make-package -J -m %s-d %s %s > /dev/null 2>&1",
+                  selfdir, ( service_first ) ? "-s " : "", destination, dir );
+  p  = sys_exec_command( cmd );
+  rc = sys_wait_command( p, (char *)&errmsg[0], PATH_MAX );
+  if( rc != 0 )
+  {
+    FATAL_ERROR( "Cannot create package %s-%s", fake->name, fake->version );
+  }
+
+  (void)snprintf( cmd, sizeof(cmd), "rm -rf %s", dir );
+  p = sys_exec_command( cmd );
+  (void)sys_wait_command( p, (char *)&errmsg[0], PATH_MAX );
+}
+/*
+  End of output functions.
+ ***************************************************************/
+
+
+int main( int argc, char *argv[] )
+{
+  char *pkgs_path = NULL;
+  int   i;
+
+  errlog = stderr;
+
+  selfdir = get_selfdir();
+
+  program = basename( argv[0] );
+  get_args( argc, argv );
+
+  if( _mkdir_p( destination, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
+  {
+    FATAL_ERROR( "Cannot create %s directory", destination );
+  }
+
+  create_fakes();
+
+  if( output_format == OFMT_TXZ )
+  {
+    tmpdir = (char *)alloca( strlen( destination ) + 32 );
+    (void)sprintf( tmpdir, "%s/.%s-%d", destination, PROGRAM_NAME, (int)getpid() );
+    if( _mkdir_p( tmpdir, S_IRWXU ) != 0 )
+    {
+      FATAL_ERROR( "Cannot create %s directory", tmpdir );
+    }
+  }
+
+  for( i = 0; i < packages; ++i )
+  {
+    if( output_format == OFMT_TXZ ) write_package( &fakes[i], i );
+    else                            write_pkglog( destination, &fakes[i], i, 0 );
+  }
+
+  if( tmpdir ) (void)rmdir( tmpdir );
+
+  if( root )
+  {
+    pkgs_path = (char *)alloca( strlen( root ) + strlen( REMOVED_PKGS_PATH ) + 2 );
+    (void)sprintf( pkgs_path, "%s/%s", root, PACKAGES_PATH );
+    if( _mkdir_p( pkgs_path, S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH ) != 0 )
+    {
+      FATAL_ERROR( "Cannot create %s directory", pkgs_path );
+    }
+
+    for( i = 0; i < packages; ++i )
+      write_pkglog( pkgs_path, &fakes[i], i, 1 );
+
+    (void)sprintf( pkgs_path, "%s/%s", root, REMOVED_PKGS_PATH );
+    if( _mkdir_p( pkgs_path, S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH ) != 0 )
+    {
+      FATAL_ERROR( "Cannot create %s directory", pkgs_path );
+    }
+    (void)sprintf( pkgs_path, "%s/%s", root, PACKAGES_PATH );
+
+    if( pkgdb_sync( pkgs_path, 1 ) != 0 )
+    {
+      ERROR( "Cannot create index of Setup Database" );
+    }
+  }
+
+  free_resources();
+
+  exit( exit_status );
+}
@@ -0,0 +1,130 @@
+#
+# html2c.awk - converts HTML template into C source of static text segments:
+#
+#   awk -v dir=html -v name=pkglist_html -f html2c.awk html/pkglist.html > pkglist-html.h
+#
+# Build-time directives of the template:
+#
+#   @INCLUDE:file@ - the line is replaced by lines of 'dir/file' indented
+#                    by the same spaces as the directive;
+#   @BASE64:file@  - is replaced by base64 encoded content of 'dir/file'
+#                    (binary assets such as favicon for data: URIs).
+#
+# Run-time variables (uppercase names such as @ROOT@) end the current text
+# segment. The result is an array of { data, size, HTML_<NAME> } entries:
+# the program writes the data and then the value of variable. The line which
+# holds only a variable (for example, @IF_GRAPH@, @ELSE@, @ENDIF@) does not
+# produce a line feed. The last segment is ended by HTML_NONE variable.
+#
+
+function c_escape( s,    r, i )
+{
+  r = ""
+  while( (i = match( s, /["\\]/ )) > 0 )
+  {
+    r = r substr( s, 1, i - 1 ) "\\" substr( s, i, 1 )
+    s = substr( s, i + 1 )
+  }
+  return r s
+}
+
+function text( s )
+{
+  if( s == "" ) return
+  data = data "\n  \"" s "\""
+}
+
+function segment( var )
+{
+  if( data == "" )
+    entries = entries sprintf( "  { \"\", 0, HTML_%s },\n", var )
+  else
+  {
+    printf( "static const char %s_%d[] =%s;\n\n", name, count, data )
+    entries = entries sprintf( "  { %s_%d, sizeof( %s_%d ) - 1, HTML_%s },\n", name, count, name, count, var )
+  }
+  data = ""
+  ++count
+}
+
+function base64( file,    alphabet, cmd, line, n, i, k, b, f, v, out )
+{
+  alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+
+  n = 0
+  cmd = "od -An -v -tu1 " file
+  while( (cmd | getline line) > 0 )
+  {
+    k = split( line, f, " " )
+    for( i = 1; i <= k; ++i ) b[n++] = f[i] + 0
+  }
+  close( cmd )
+
+  out = ""
+  for( i = 0; i < n; i += 3 )
+  {
+    v = b[i] * 65536 + (i + 1 < n ? b[i + 1] : 0) * 256 + (i + 2 < n ? b[i + 2] : 0)
+
+    out = out substr( alphabet, int( v / 262144 ) % 64 + 1, 1 ) \
+              substr( alphabet, int( v / 4096 ) % 64 + 1, 1 )
+    out = out ((i + 1 < n) ? substr( alphabet, int( v / 64 ) % 64 + 1, 1 ) : "=")
+    out = out ((i + 2 < n) ? substr( alphabet, v % 64 + 1, 1 ) : "=")
+
+    # keep the generated source readable:
+    if( length( out ) >= 76 ) { text( out ); out = "" }
+  }
+  text( out )
+}
+
+function template_line( s,    indent, file, line, token, head )
+{
+  if( s ~ /^[ \t]*@INCLUDE:[^@]+@[ \t]*$/ )
+  {
+    indent = s; sub( /@.*$/, "", indent )
+    file = s; sub( /^[ \t]*@INCLUDE:/, "", file ); sub( /@[ \t]*$/, "", file )
+    file = dir "/" file
+
+    while( (getline line < file) > 0 )
+      template_line( (line == "") ? "" : indent line )
+    close( file )
+    return
+  }
+
+  if( s ~ /^[ \t]*@[A-Z_]+@[ \t]*$/ )
+  {
+    gsub( /[ \t@]/, "", s )
+    segment( s )
+    return
+  }
+
+  while( match( s, /@[A-Z_0-9]+(:[^@]+)?@/ ) )
+  {
+    token = substr( s, RSTART + 1, RLENGTH - 2 )
+    head  = substr( s, 1, RSTART - 1 )
+    s     = substr( s, RSTART + RLENGTH )
+
+    text( c_escape( head ) )
+
+    if( token ~ /^BASE64:/ )
+      base64( dir "/" substr( token, 8 ) )
+    else
+      segment( token )
+  }
+  text( c_escape( s ) "\\n" )
+}
+
+BEGIN {
+  if( name == "" ) name = "html"
+  data = ""; entries = ""; count = 0
+
+  printf( "/* Generated by html2c.awk from HTML template. Do not edit. */\n\n" )
+}
+
+{
+  template_line( $0 )
+}
+
+END {
+  segment( "NONE" )
+  printf( "static const struct html_segment %s[] =\n{\n%s};\n", name, entries )
+}
@@ -0,0 +1,501 @@
+var margin = {top: 20, right: 120, bottom: 20, left: 220},
+    width = @SVG_WIDTH@ - margin.right - margin.left,
+    height = @SVG_HEIGHT@ - margin.top - margin.bottom;
+
+var i = 0,
+    duration = 750,
+    root = 0;
+
+var treemap = d3.tree()
+    .size([height, width]);
+
+var svg = d3.select(document.getElementById( 'tree_view' )).append("svg")
+    .attr("width", width + margin.right + margin.left)
+    .attr("height", height + margin.top + margin.bottom)
+    .append("g")
+    .attr("transform", "translate(" + margin.left + "," + margin.top + ")");
+
+var div = d3.select(document.getElementById( 'front_wrapper' )).append("div")
+    .attr("class", "tree-tooltip")
+    .style("display", "none")
+    .style("opacity", 0);
+
+
+@IF_GRAPH@
+var graph;
+
+/* Creates collapsed tree nodes for requires of graph node: */
+function populate(d) {
+  if( d.children || d._children || d.data.node === undefined ) return;
+  var reqs = graph.nodes[d.data.node].requires;
+  if( reqs ) d._children = graph_nodes(d, reqs);
+}
+
+function graph_nodes(parent, list) {
+  return list.map(function(k) {
+    var d = d3.hierarchy({ name: graph.nodes[k].name, node: k });
+    d.parent = parent;
+    d.depth = parent.depth + 1;
+    return d;
+  });
+}
+
+load_json( '@JSON_TREE_FILE@', function(response) {
+  graph = JSON.parse(response);
+
+  /* The tree grows from graph on demand: */
+  root = d3.hierarchy({ name: graph.name, distro: graph.distro });
+  root.children = graph_nodes(root, graph.children);
+
+  root.x0 = height / 2;
+  root.y0 = 0;
+
+  document.getElementById('spinner').remove();
+  root.children.forEach(populate);
+  update(root);
+});
+@ENDIF@
+@IF_TREE@
+load_json( '@JSON_TREE_FILE@', function(response) {
+  var treeData = JSON.parse(response);
+
+  /* Assigns parent, children, height, depth: */
+  root = d3.hierarchy(treeData, function(d) { return d.children; });
+
+  root.x0 = height / 2;
+  root.y0 = 0;
+
+  function collapse(d) {
+    if( d.children ) {
+      d._children = d.children;
+      d._children.forEach(collapse);
+      d.children = null;
+    }
+  }
+
+  document.getElementById('spinner').remove();
+  root.children.forEach(collapse);
+  update(root);
+});
+@ENDIF@
+@IF_CHUNKS@
+var index,
+    chunks = [],
+    search_keys = [],
+    hovered = null;
+
+function package_id(k) {
+  var p = index.packages[k];
+  if( p.group !== undefined ) return p.group + ':' + p.name + '-' + p.version;
+  return p.name + '-' + p.version;
+}
+
+function package_requires(k) {
+  return index.packages[k].requires || [];
+}
+
+function escape_html(s) {
+  return String(s).replace(/&/g, '&amp;').replace(/</g, '&lt;').replace(/>/g, '&gt;').replace(/"/g, '&quot;');
+}
+
+/* Loads chunks of the list of packages and calls back when all of them are ready: */
+function load_chunks(list, callback) {
+  var wait = 1;
+
+  function ready() { if( --wait == 0 ) callback(); }
+
+  list.forEach(function(k) {
+    if( chunks[k] !== undefined ) return;
+    ++wait;
+    load_json( index.chunks + '/' + k + '.json', function(response) {
+      chunks[k] = JSON.parse(response);
+      ready();
+    });
+  });
+  ready();
+}
+
+/* Creates tree nodes for packages of the list (the index is enough, chunks are not loaded): */
+function chunk_nodes(parent, list) {
+  if( !list.length ) return null;
+  return list.map(function(k) {
+    var d = d3.hierarchy({ name: package_id(k), node: k });
+    d.parent = parent;
+    d.depth = parent.depth + 1;
+    /* nodes of requires are created on expand: */
+    if( package_requires(k).length ) d._children = true;
+    return d;
+  });
+}
+
+function expand(d) {
+  d.children = chunk_nodes(d, package_requires(d.data.node));
+  d._children = null;
+}
+
+/* Shows the tree of package K or the whole tree if K is undefined: */
+function show_tree(k) {
+  var list;
+
+  svg.selectAll('g.node').remove();
+  svg.selectAll('path.link').remove();
+
+  if( k === undefined ) {
+    root = d3.hierarchy({ name: index.name, distro: index.distro });
+    list = index.children;
+  } else {
+    root = d3.hierarchy({ name: package_id(k), node: k, distro: index.distro });
+    list = package_requires(k);
+  }
+  root.x0 = height / 2;
+  root.y0 = 0;
+
+  root.children = chunk_nodes(root, list);
+  update(root);
+}
+
+/* Shows the details of package K, only the chunk of K is loaded: */
+function show_details(k) {
+  load_chunks([k], function() {
+    var pkg = chunks[k], reqs = package_requires(k);
+    var content = '<div class="details-close">&#215;</div>' +
+                  '<div class="tooltip-header">' + escape_html(package_id(k)) + '</div>' +
+                  '<div class="details-text">' + escape_html(pkg.package_description) + '</div>';
+
+    if( reqs.length ) {
+      content += '<div class="details-title">requires:</div>' +
+                 '<div class="details-list">' +
+                 reqs.map(function(r) {
+                   return '<a href="#" data-node="' + r + '">' + escape_html(package_id(r)) + '</a>';
+                 }).join('<br>') +
+                 '</div>';
+    }
+    content += '<div class="details-title">files: ' + pkg.files.length + '</div>' +
+               '<div class="details-files">' + escape_html(pkg.files.join('\n')) + '</div>';
+
+    $('#details').html(content).show();
+  });
+}
+
+function select(k) {
+  show_tree(k);
+  show_details(k);
+}
+
+/* Search over the index only, chunks are not loaded: */
+function search(query) {
+  var result = [];
+
+  query = query.trim().toLowerCase();
+  if( !query.length ) return result;
+
+  for( var k = 0; k < search_keys.length && result.length < 64; ++k ) {
+    if( search_keys[k].indexOf(query) >= 0 ) result.push(k);
+  }
+  return result;
+}
+
+load_json( '@JSON_TREE_FILE@', function(response) {
+  index = JSON.parse(response);
+  search_keys = index.packages.map(function(p, k) { return package_id(k).toLowerCase(); });
+
+  document.getElementById('spinner').remove();
+  show_tree();
+});
+
+$('#search').on('input', function() {
+  var list = search($(this).val());
+
+  $('#search_results')
+    .html(list.map(function(k) {
+      return '<a href="#" data-node="' + k + '">' + escape_html(package_id(k)) + '</a>';
+    }).join(''))
+    .toggle(list.length > 0);
+});
+
+$('#search_results, #details').on('click', 'a', function(e) {
+  e.preventDefault();
+  $('#search_results').hide();
+  select(+$(this).data('node'));
+});
+
+$('#details').on('click', '.details-close', function() { $('#details').hide(); });
+
+$('.tree-hw-title')
+  .css('cursor', 'pointer')
+  .click(function() { $('#details').hide(); show_tree(); });
+@ENDIF@
+
+
+function update(source) {
+
+  var tree = treemap( root );
+
+  /* Compute the new tree layout. */
+  var nodes = tree.descendants(),
+      links = tree.descendants().slice(1);
+
+  /* Normalize for fixed-depth. */
+  nodes.forEach(function(d) { d.y = d.depth * 220; });
+
+  /* Update the nodes . . . */
+  var node = svg.selectAll("g.node")
+    .data(nodes, function(d) { return d.id || (d.id = ++i); });
+
+  /* Enter any new nodes at the parent's previous position. */
+  var nodeEnter = node.enter().append("g")
+    .attr("class", "node")
+    .attr("transform", function(d) { return "translate(" + source.y0 + "," + source.x0 + ")"; })
+    .on("click", click)
+    .on("mouseover", function tooltip(d) {
+@IF_CHUNKS@
+      /* the data of package is taken from the chunk which is loaded on demand: */
+      hovered = d;
+      if( d.data.node !== undefined && chunks[d.data.node] === undefined ) {
+        var node = this, event = d3.event;
+
+        load_chunks([d.data.node], function() {
+          if( hovered === d ) d3.customEvent(event, tooltip, node, [d]);
+        });
+        return;
+      }
+@ENDIF@
+      div.transition()
+        .duration(200)
+        .style("opacity", .92);
+      {
+        var content = '<div class="tooltip-header-not-packaged">' + 'void' + '</div>';
+
+        if( d.name === "void" ) {
+          /* draw div.tree-tooltip to get actual size */
+          div.html( content )
+            .style("left", (d3.event.pageX + document.getElementById( 'front_wrapper' ).scrollLeft + 12) + "px")
+            .style("top",  (d3.event.pageY + document.getElementById( 'front_wrapper' ).scrollTop  + 12) + "px");
+        }
+        else
+        {
+          /* find package in the pkgs array: */
+@IF_CHUNKS@
+          var pkg = chunks[d.data.node];
+@ELSE@
+          var pkg = pkgs.find(obj => { return obj.id === d.data.name; });
+@ENDIF@
+
+          if( pkg === undefined )
+          {
+            content = '<div class="tooltip-header-not-packaged">' + 'not packaged collection' + '</div>';
+            /* draw div.tree-tooltip to get actual size */
+            div.html( content )
+              .style("left", (d3.event.pageX + document.getElementById( 'front_wrapper' ).scrollLeft + 12) + "px")
+              .style("top",  (d3.event.pageY + document.getElementById( 'front_wrapper' ).scrollTop  + 12) + "px");
+          }
+          else
+          {
+            content  = '<div class="tooltip-header">' + pkg.name + '</div>' +
+                        '<div class="tooltip-description">' + pkg.description + '</div>' +
+                         '<div class="tooltip-content">' +
+                         '               group: ' + pkg.group + '\n' +
+                         '        architecture: ' + pkg.arch + '\n' +
+                         '            hardware: ' + pkg.hardware + '\n';
+            if( pkg.flavour !== undefined )
+            {
+              content += '             <span class="flavour">edition</span>: ' + pkg.flavour + '\n';
+            }
+              content += '             license: ' + pkg.license + '\n' +
+                         '      bug report url: ' + root.data.distro[2] + '\n' +
+                         '        distribution: ' + root.data.distro[0] + '-' + root.data.distro[1] + '\n' +
+                         '     package tarball: ' + pkg.name + '-' + pkg.version + '-' + pkg.arch + '-' + root.data.distro[0] + '-' + root.data.distro[1] + '.'+ '@TARBALL_SUFFIX@' + '\n' +
+                         '   uncompressed size: ' + pkg.uncompressed_size + '\n' +
+                         '     number of files: ' + pkg.total_files + '\n' +
+                         '</div>' +
+                        '</div>' +
+                       '</div>';
+
+            /* draw div.tree-tooltip to get actual size */
+            div.html( content )
+              .style("left", (d3.event.pageX + document.getElementById( 'front_wrapper' ).scrollLeft + 12) + "px")
+              .style("top",  (d3.event.pageY + document.getElementById( 'front_wrapper' ).scrollTop  + 12) + "px");
+          }
+        }
+
+        /* draw div.tree-tooltip at actual position */
+
+        var cW = $( window ).width();
+        var cH = $( window ).height();
+        var cX = d3.event.pageX;
+        var cY = d3.event.pageY;
+        var tW = $('div.tree-tooltip').width();
+        var tH = $('div.tree-tooltip').height();
+        var oX;
+        var oY;
+        var dX = ( cW - cX ) - ( tW + 12 );
+        var dY = ( cH - cY ) - ( tH + 12 );
+
+        /* shift left to according to width=16 of browser vertical scroll bar */
+        if( dX <= 24 ) { dX = 24 - dX; }
+        else           { dX = 0;       }
+
+        /* shift top to according to width=16 of browser horizontal scroll bar */
+        if( dY <= 24 ) { dY = 24 - dY; }
+        else           { dY = 0;       }
+
+        if( ( cW - cX ) < ( tW + 12 ) ) { oX = - 12 - tW; } else { oX = 12 - dX; }
+        if( ( cH - cY ) < ( tH + 12 ) ) { oY = - 12 - tH; } else { oY = 12 - dY; }
+
+        if( (( cW - cX ) < ( tW + 12 )) && (cX < ( tW + 12 )) )
+        {
+          /* in this case we have to center tooltip */
+          oX = - (tW + 12) / 2 + (cW/2 - cX);
+        }
+
+        div.html( content )
+          .style("left", (d3.event.pageX + document.getElementById( 'front_wrapper' ).scrollLeft + oX) + "px")
+          .style("top",  (d3.event.pageY + document.getElementById( 'front_wrapper' ).scrollTop +  oY) + "px")
+          .style("display","block");
+      }
+    })
+    .on("mouseout", function(d) {
+@IF_CHUNKS@
+      hovered = null;
+@ENDIF@
+      div.transition()
+        .duration(500)
+        .style("opacity", 0);
+    });
+
+  nodeEnter.append("circle")
+    .attr('class', 'node')
+  /* Additional attributes (see the 'style' section) */
+    .attr("stroke", "#5d5d5d")
+    .attr("stroke-width", "1.0")
+  /* End of additional attributes */
+    .attr("r", 1e-6)
+    .style("fill", function(d) { return d._children ? "#abd8d4" : "#fff"; });
+
+  nodeEnter.append("text")
+    .attr("x", function(d) { return d.children || d._children ? -10 : 10; })
+    .attr("dy", "-.35em")
+    .attr("text-anchor", function(d) { return d.children || d._children ? "end" : "start"; })
+    .text(function(d) { return (d.data.name.indexOf(":",0) > 0 ) ? d.data.name.substr(d.data.name.indexOf(":",0) + 1) : d.data.name; })
+    .style("fill-opacity", 1);
+
+  /* Update */
+  var nodeUpdate = nodeEnter.merge(node);
+
+  /* Transition nodes to their new position. */
+  nodeUpdate.transition()
+    .duration(duration)
+    .attr("transform", function(d) { return "translate(" + d.y + "," + d.x + ")"; });
+
+  nodeUpdate.select("circle.node")
+    .attr("r", 4.5)
+    .style("fill", function(d) {
+      if( d._children )
+      {
+        return "#abd8d4";
+      }
+      else
+      {
+        if( d.children == undefined )
+        {
+          if( d.name == "void" )
+          {
+            return "#c9c9c9";
+          }
+          else
+          {
+            return "#fff";
+          }
+        }
+        else
+        {
+          return "#d2ebd8";
+        }
+      }
+    })
+    .attr('cursor', 'pointer');
+
+  /* Transition exiting nodes to the parent's new position. */
+  var nodeExit = node.exit().transition()
+    .duration(duration)
+    .attr("transform", function(d) { return "translate(" + source.y + "," + source.x + ")"; })
+    .remove();
+
+  nodeExit.select("circle")
+    .attr("r", 1e-6);
+
+  nodeExit.select("text")
+    .style("fill-opacity", 1e-6);
+
+  /* Update the links . . . */
+  var link = svg.selectAll('path.link')
+    .data(links, function(d) { return d.id; });
+
+  /* Enter any new links at the parent's previous position. */
+  var linkEnter = link.enter().insert('path', 'g')
+    .attr("class", "link")
+    .attr("d", function(d) {
+      var o = {x: source.x0, y: source.y0};
+      return diagonal(o, o);
+    });
+
+  /* Update */
+  var linkUpdate = linkEnter.merge(link);
+
+  /* Transition links to their new position. */
+  linkUpdate.transition()
+    .duration(duration)
+  /* Additional attributes (see the 'style' section) */
+    .style("fill", "none")
+    .attr("stroke", "DarkGray")
+    .attr("stroke-width", "1.5")
+  /* End of additional attributes */
+    .attr("d", function(d){ return diagonal(d, d.parent) });
+
+  /* Transition exiting nodes to the parent's new position. */
+  var linkExit = link.exit().transition()
+    .duration(duration)
+    .attr("d", function(d) {
+      var o = {x: source.x, y: source.y};
+      return diagonal(o, o);
+    })
+    .remove();
+
+  /* Stash the old positions for transition. */
+  nodes.forEach(function(d) {
+    d.x0 = d.x;
+    d.y0 = d.y;
+  });
+
+  /* Creates a curved (diagonal) path from parent to the child nodes. */
+  function diagonal(s, d) {
+    path = `M ${s.y} ${s.x}
+            C ${(s.y + d.y) / 2} ${s.x},
+              ${(s.y + d.y) / 2} ${d.x},
+              ${d.y} ${d.x}`;
+    return path;
+  }
+
+  /* Toggle children on click. */
+  function click(d) {
+@IF_CHUNKS@
+    if( d.data.node !== undefined ) show_details(d.data.node);
+    if( d._children === true ) {
+      expand(d);
+      update(d);
+      return;
+    }
+@ENDIF@
+    if (d.children) {
+      d._children = d.children;
+      d.children = null;
+    } else {
+      d.children = d._children;
+      d._children = null;
+@IF_GRAPH@
+      if (d.children) d.children.forEach(populate);
+@ENDIF@
+    }
+    update(d);
+  }
+}
@@ -61,6 +61,8 @@
 
 #include <cmpvers.h>
 #include <dlist.h>
+#include <pkgdb.h>
+#include <tarball.h>
 
 #if defined( HAVE_DIALOG )
 #include <dialog-ui.h>
@@ -127,7 +129,34 @@ static struct dlist *dirs  = NULL;
 static struct dlist *files = NULL;
 static struct dlist *links = NULL;
 
+/*****************************************************************
+  Package STREAM:
+  ==============
+    Only service files are extracted into TMPDIR by the first
+    pass; nothing is written into the root until the package is
+    checked and the installation is confirmed.
+
+    The package is decompressed once only if all service files
+    are placed at the beginning of the package (make-package -s):
+    the stream is paused at the first payload member and the
+    payload is written into the root by uncompress_package().
+
+    With the default layout the service files follow the payload,
+    so the first pass decompresses the whole package to reach them
+    and the payload is decompressed again by the second pass. The
+    GPG2 signature is verified over the first pass stream only in
+    this case; if the stream is paused, gpg2 reads the package file
+    once more because the signature has to be checked before the
+    payload is written.
+ */
+static struct tarball        *package  = NULL; /* paused package stream   */
+static struct tarball_member *paused   = NULL; /* the first payload member */
+#if defined( HAVE_GPG2 )
+static int                    digest   = -1;   /* gpg2 status over stream  */
+#endif
+
 static void free_list( struct dlist *list );
+static void free_package_stream( void );
 
 
 #define FREE_PKGINFO_VARIABLES() \
@@ -165,6 +194,8 @@ void free_resources()
 
   if( selfdir )       { free( selfdir );       selfdir       = NULL; }
 
+  free_package_stream();
+
   FREE_PKGINFO_VARIABLES();
 }
 
@@ -481,7 +512,7 @@ static void _rm_tmpdir( const char *dirpath )
     strcat( path, "/" );
     strcat( path, entry->d_name );
 
-    if( stat( path, &entry_sb ) == 0 )
+    if( lstat( path, &entry_sb ) == 0 )
     {
       if( S_ISDIR(entry_sb.st_mode) )
       {
@@ -584,12 +615,10 @@ static void set_signal_handlers()
 static enum _input_type check_input_file( char *uncompress, const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   if( uncompress )
   {
     *uncompress = '\0';
@@ -600,8 +629,6 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -620,47 +647,14 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     close( fd ); return IFMT_LOG;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    if( uncompress ) { *uncompress = 'x'; }
-    close( fd ); return IFMT_PKG;
-  }
+  close( fd );
 
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    if( uncompress ) { *uncompress = 'j'; }
-    close( fd ); return IFMT_PKG;
-  }
+  /* GZ, BZ2, XZ or TAR */
+  if( (compression = tarball_compression( fname )) == TARBALL_UNKNOWN ) return IFMT_UNKNOWN;
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
-  {
-    if( uncompress ) { *uncompress = 'J'; }
-    close( fd ); return IFMT_PKG;
-  }
-
-  if( pkglog_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return IFMT_PKG;
-    }
-  }
+  if( uncompress ) { *uncompress = tarball_tar_option( compression ); }
 
-  close( fd ); return IFMT_UNKNOWN;
+  return IFMT_PKG;
 }
 
 
@@ -1185,6 +1179,153 @@ static void read_input_pkginfo( const char *pkginfo_fname )
 }
 
 
+/***************************************************************
+  Package STREAM functions:
+ */
+#if defined( HAVE_GPG2 )
+static FILE *gpg_pipe = NULL;
+
+static void __gpg_write( const void *buf, size_t size, void *user_data )
+{
+  (void)fwrite( buf, 1, size, (FILE *)user_data );
+}
+
+/*********************************************************
+  The signature is verified over the same compressed data
+  which is read by the package stream:
+ */
+static void __gpg_open( void )
+{
+  struct stat st;
+  char   cmd[PATH_MAX];
+  int    len;
+
+  if( !gpgck || !asc_fname || stat( (const char *)asc_fname, &st ) == -1 ) return;
+
+  len = snprintf( &cmd[0], PATH_MAX, "gpg2 --verify %s - > /dev/null 2>&1", asc_fname );
+  if( len <= 0 || len >= PATH_MAX - 1 ) return;
+
+  if( (gpg_pipe = popen( (const char *)&cmd[0], "w" )) )
+    tarball_set_raw_func( package, __gpg_write, (void *)gpg_pipe );
+}
+
+static void __gpg_close( int complete )
+{
+  int rc;
+
+  if( !gpg_pipe ) return;
+
+  if( package ) tarball_set_raw_func( package, NULL, NULL );
+
+  rc = pclose( gpg_pipe ); gpg_pipe = NULL;
+
+  if( complete ) digest = ( rc != -1 && WIFEXITED(rc) ) ? WEXITSTATUS(rc) : 1;
+}
+#endif
+
+static void free_package_stream( void )
+{
+#if defined( HAVE_GPG2 )
+  __gpg_close( 0 );
+#endif
+  if( package ) { tarball_close( package ); package = NULL; paused = NULL; }
+}
+
+/*********************************************************
+  Reads service files of the package into DIR by the first
+  pass. Returns 0 on success, or -1 if the package cannot
+  be read by built-in TAR reader:
+ */
+static int read_package_stream( const char *dir )
+{
+  const char *service[] = {
+    ".DESCRIPTION", ".FILELIST", ".INSTALL", ".PKGINFO", ".REQUIRES", ".RESTORELINKS", NULL
+  };
+  struct tarball_member *member = NULL;
+  int    rc, i, found = 0, all = (1 << (sizeof( service ) / sizeof( service[0] ) - 1)) - 1;
+
+  if( !(package = tarball_open( (const char *)pkg_fname )) ) return -1;
+
+#if defined( HAVE_GPG2 )
+  __gpg_open();
+#endif
+
+  while( (rc = tarball_next( package, &member )) > 0 )
+  {
+    if( !index( member->name, '/' ) && tarball_service_file( (const char *)member->name ) )
+    {
+      if( tarball_extract( package, dir ) != 0 ) { rc = -1; break; }
+
+      for( i = 0; service[i]; ++i )
+        if( !strcmp( member->name, service[i] ) ) found |= 1 << i;
+      continue;
+    }
+    if( tarball_service_file( (const char *)member->name ) ) continue;
+
+    if( found == all )
+    {
+      /* no service file can follow; the payload is read by uncompress_package(): */
+#if defined( HAVE_GPG2 )
+      __gpg_close( 0 );
+#endif
+      paused = member;
+      return 0;
+    }
+    /* payload members are skipped by tarball_next() */
+  }
+
+  if( rc == 0 )
+  {
+#if defined( HAVE_GPG2 )
+    /* the rest of compressed file is needed for signature only: */
+    if( gpg_pipe ) (void)tarball_skip_rest( package );
+    __gpg_close( 1 );
+#endif
+    tarball_close( package ); package = NULL;
+
+    return 0;
+  }
+
+  free_package_stream();
+
+  return -1;
+}
+
+/*********************************************************
+  Writes the rest of paused package stream into the root:
+ */
+static int __stream_payload( void )
+{
+  struct tarball_member *member = paused;
+  int    rc = 1;
+
+  while( rc > 0 )
+  {
+    if( !tarball_service_file( (const char *)member->name ) &&
+        tarball_extract( package, (const char *)root ) != 0 ) { rc = -1; break; }
+
+    rc = tarball_next( package, &member );
+  }
+  if( tarball_finish( package ) != 0 ) rc = -1;
+  tarball_close( package ); package = NULL; paused = NULL;
+
+  return ( rc < 0 ) ? 2 : 0;
+}
+
+/*********************************************************
+  Returns the status of payload extraction or -1 if the
+  package has to be extracted by tar(1) pipeline:
+ */
+static int extract_payload( void )
+{
+  if( package ) return __stream_payload();
+
+  return tarball_extract_package( (const char *)pkg_fname, (const char *)root );
+}
+/*
+  End of Package STREAM functions.
+ ***************************************************************/
+
 static void read_service_files( void )
 {
   struct stat st;
@@ -1227,20 +1368,39 @@ static void read_service_files( void )
     if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
     bzero( (void *)cmd, PATH_MAX );
 
-    len = snprintf( &cmd[0], PATH_MAX,
-                    "%s/pkginfo -d %s"
-                    " -o pkginfo,description,requires,restore-links,install-script,filelist"
-                    " %s > /dev/null 2>&1",
-                    selfdir, tmp, fname );
-    if( len == 0 || len == PATH_MAX - 1 )
+    if( read_package_stream( (const char *)tmp ) == 0 )
     {
-      FATAL_ERROR( "Cannot get PKGINFO from %s file", basename( (char *)fname ) );
+      const char *required[] = { ".PKGINFO", ".FILELIST", ".INSTALL", NULL };
+      struct stat sb;
+      int         i;
+
+      /* these files are strongly required as for pkginfo utility: */
+      for( i = 0; required[i]; ++i )
+      {
+        (void)snprintf( &cmd[0], PATH_MAX, "%s/%s", tmp, required[i] );
+        if( stat( (const char *)&cmd[0], &sb ) == -1 )
+        {
+          FATAL_ERROR( "Cannot get PKGINFO from '%s' file", basename( (char *)fname ) );
+        }
+      }
     }
-    p = sys_exec_command( cmd );
-    rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
-    if( rc != 0 )
+    else
     {
-      FATAL_ERROR( "Cannot get PKGINFO from '%s' file", basename( (char *)fname ) );
+      len = snprintf( &cmd[0], PATH_MAX,
+                      "%s/pkginfo -d %s"
+                      " -o pkginfo,description,requires,restore-links,install-script,filelist"
+                      " %s > /dev/null 2>&1",
+                      selfdir, tmp, fname );
+      if( len == 0 || len == PATH_MAX - 1 )
+      {
+        FATAL_ERROR( "Cannot get PKGINFO from %s file", basename( (char *)fname ) );
+      }
+      p = sys_exec_command( cmd );
+      rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
+      if( rc != 0 )
+      {
+        FATAL_ERROR( "Cannot get PKGINFO from '%s' file", basename( (char *)fname ) );
+      }
     }
 
     (void)strcat( tmp, "/.PKGINFO" );
@@ -1637,6 +1797,30 @@ static void check_package( void )
 }
 
 
+static void check_requires_status( int rc )
+{
+  if( rc != 0 )
+  {
+    if( install_mode != CONSOLE )
+    {
+#if defined( HAVE_DIALOG )
+      info_pkg_box( "Install:", pkgname, pkgver, strprio( priority, 0 ),
+                    "\nPackage requires other packages to be installed.\n", 5, 0, 0 );
+#else
+      fprintf( stdout, "\nPackage '%s-%s' requires other packages to be installed.\n\n", pkgname, pkgver );
+#endif
+    }
+    else
+    {
+      fprintf( stdout, "\nPackage '%s-%s' requires other packages to be installed.\n\n", pkgname, pkgver );
+    }
+
+    if( tmpdir ) { _rm_tmpdir( (const char *)tmpdir ); free( tmpdir ); }
+    free_resources();
+    exit( rc );
+  }
+}
+
 static void check_requires( void )
 {
   pid_t p = (pid_t) -1;
@@ -1645,6 +1829,17 @@ static void check_requires( void )
   int   len = 0;
   char *cmd = NULL;
 
+  /*************************************************************
+    Check requires in-process against the set of installed
+    packages loaded from the index of Setup Database. If the
+    index cannot be used we run the check-requires utility:
+   */
+  if( (rc = pkgdb_requires_status( (const char *)pkgs_path, (const char *)pkglog_fname )) >= 0 )
+  {
+    check_requires_status( rc );
+    return;
+  }
+
   cmd = (char *)malloc( (size_t)PATH_MAX );
   if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
   bzero( (void *)cmd, PATH_MAX );
@@ -1661,26 +1856,7 @@ static void check_requires( void )
 
   free( cmd );
 
-  if( rc != 0 )
-  {
-    if( install_mode != CONSOLE )
-    {
-#if defined( HAVE_DIALOG )
-      info_pkg_box( "Install:", pkgname, pkgver, strprio( priority, 0 ),
-                    "\nPackage requires other packages to be installed.\n", 5, 0, 0 );
-#else
-      fprintf( stdout, "\nPackage '%s-%s' requires other packages to be installed.\n\n", pkgname, pkgver );
-#endif
-    }
-    else
-    {
-      fprintf( stdout, "\nPackage '%s-%s' requires other packages to be installed.\n\n", pkgname, pkgver );
-    }
-
-    if( tmpdir ) { _rm_tmpdir( (const char *)tmpdir ); free( tmpdir ); }
-    free_resources();
-    exit( rc );
-  }
+  check_requires_status( rc );
 }
 
 /********************************************************
@@ -1731,6 +1907,9 @@ static void read_filelist( void )
   char *ln   = NULL;
   char *line = NULL, *tmp = NULL;
 
+  struct dlist_head dhead = DLIST_HEAD_INIT,
+                    fhead = DLIST_HEAD_INIT;
+
   tmp = (char *)malloc( (size_t)PATH_MAX );
   if( !tmp ) { FATAL_ERROR( "Cannot allocate memory" ); }
   bzero( (void *)tmp, PATH_MAX );
@@ -1752,6 +1931,9 @@ static void read_filelist( void )
   if( !line ) { FATAL_ERROR( "Cannot allocate memory" ); }
   bzero( (void *)line, PATH_MAX );
 
+  dlist_head_attach( &dhead, dirs );
+  dlist_head_attach( &fhead, files );
+
   while( (ln = fgets( line, PATH_MAX, fp )) )
   {
     ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
@@ -1761,16 +1943,19 @@ static void read_filelist( void )
     {
       *(ln + strlen(ln) - 1) = '\0';
       (void)sprintf( &tmp[0], "%s%s", (const char *)root, (const char *)ln );
-      dirs = dlist_append( dirs, strdup( (const char *)&tmp[0] ) );
+      dlist_head_append( &dhead, strdup( (const char *)&tmp[0] ) );
     }
     else
     {
       (void)sprintf( &tmp[0], "%s%s", (const char *)root, (const char *)ln );
-      files = dlist_append( files, strdup( (const char *)&tmp[0] ) );
+      dlist_head_append( &fhead, strdup( (const char *)&tmp[0] ) );
     }
 
   } /* End of while( file list entry ) */
 
+  dirs  = dlist_head_detach( &dhead );
+  files = dlist_head_detach( &fhead );
+
   fclose( fp );
 
   free( line );
@@ -2212,6 +2397,8 @@ static void uncompress_package( void )
 
   char decompressor[64];
 
+  if( (rc = extract_payload()) >= 0 ) goto done;
+
   (void)fill_decompressor( (char *)&decompressor[0], uncompress );
 
   cmd = (char *)malloc( (size_t)PATH_MAX );
@@ -2237,6 +2424,7 @@ static void uncompress_package( void )
 
   free( cmd );
 
+done:
   if( rc != 0 )
   {
     exit_status = 44;
@@ -2509,6 +2697,24 @@ static void finalize_installation( void )
     }
   }
 
+  /******************************************
+    Update the index of the Setup Database:
+   */
+  bzero( (void *)tmp, PATH_MAX );
+  {
+    const char *pkglog = (const char *)&tmp[0];
+
+    if( group )
+      (void)sprintf( &tmp[0], "%s/%s", group, basename( (char *)pkglog_fname ) );
+    else
+      (void)sprintf( &tmp[0], "%s", basename( (char *)pkglog_fname ) );
+
+    if( pkgdb_update( (const char *)pkgs_path, &pkglog, 1, 1 ) != 0 )
+    {
+      WARNING( "Cannot update the index of Setup Database" );
+    }
+  }
+
   free( tmp );
 }
 
@@ -2529,21 +2735,29 @@ static void verify_gpg_signature( void )
    */
   if( stat( (const char *)asc_fname, &st ) == -1 ) return;
 
-  cmd = (char *)malloc( (size_t)PATH_MAX );
-  if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
-  bzero( (void *)cmd, PATH_MAX );
-
-  len = snprintf( &cmd[0], PATH_MAX,
-                  "gpg2 --verify %s %s > /dev/null 2>&1",
-                  asc_fname, pkg_fname );
-  if( len == 0 || len == PATH_MAX - 1 )
+  if( digest >= 0 )
   {
-    FATAL_ERROR( "Cannot verify GPG2 signature of '%s-%s' package", pkgname, pkgver );
+    /* the signature is already verified over the package stream: */
+    rc = digest;
   }
-  p = sys_exec_command( cmd );
-  rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
+  else
+  {
+    cmd = (char *)malloc( (size_t)PATH_MAX );
+    if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)cmd, PATH_MAX );
 
-  free( cmd );
+    len = snprintf( &cmd[0], PATH_MAX,
+                    "gpg2 --verify %s %s > /dev/null 2>&1",
+                    asc_fname, pkg_fname );
+    if( len == 0 || len == PATH_MAX - 1 )
+    {
+      FATAL_ERROR( "Cannot verify GPG2 signature of '%s-%s' package", pkgname, pkgver );
+    }
+    p = sys_exec_command( cmd );
+    rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
+
+    free( cmd );
+  }
 
   if( rc != 0 )
   {
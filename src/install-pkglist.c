@@ -59,6 +59,8 @@
 #include <msglog.h>
 #include <system.h>
 #include <dlist.h>
+#include <pkgdb.h>
+#include <tarball.h>
 
 #if defined( HAVE_DIALOG )
 #include <dialog-ui.h>
@@ -75,6 +77,9 @@ char *root = NULL, *srcdir = NULL, *pkglist_fname = NULL,
      *tmpdir = NULL, *curdir = NULL;
 
 int   rqck = 0, gpgck = 0, progress = 0, parallel = 0, error_pkgs_list = 0, ncpus = 0;
+int   levels = 1; /* all packages in the PKGLIST have installation levels */
+int   dependencies = 1; /* all packages in the PKGLIST have list of requires */
+int   jobs = 0; /* number of parallel installations; zero means ncpus*2 */
 
 int   exit_status = EXIT_SUCCESS; /* errors counter */
 char *selfdir     = NULL;
@@ -103,6 +108,15 @@ enum _procedure
   UPDATE       /* 'update'  */
 };
 
+enum _job_state
+{
+  JOB_WAITING = 0,
+  JOB_RUNNING,
+  JOB_DONE,
+  JOB_FAILED,
+  JOB_SKIPPED
+};
+
 enum _priority
 {
   REQUIRED = 0, /* synonims: REQUIRED    | required    | REQ | req */
@@ -129,6 +143,17 @@ struct package
 
   enum  _procedure procedure; /* install procedure     */
   enum  _priority  priority;  /* install user priority */
+  int              level;     /* installation level or zero if not defined */
+  char            *required;  /* comma separated list of required packages */
+
+  /* parallel installation: */
+  struct dlist    *dependents; /* packages which require this package        */
+  int              depended;   /* number of not installed required packages  */
+  enum _job_state  state;
+  pid_t            pid;
+  double           start, time; /* start time and duration in seconds        */
+  double           path;        /* duration of the longest chain of requires */
+  struct package  *critical;    /* the last installed package of this chain  */
 };
 
 enum _priority install_priority = OPTIONAL; /* by default allow all packages exept 'SKIP' */
@@ -136,6 +161,8 @@ enum _priority install_priority = OPTIONAL; /* by default allow all packages exe
 struct dlist *requires = NULL; /* list of pkg structs     */
 struct dlist *packages = NULL; /* list of package structs */
 
+struct pkgdb_set *installed = NULL; /* installed packages (--check-requires) */
+
 static void free_requires( void );
 static void free_packages( void );
 
@@ -174,6 +201,8 @@ void free_resources()
   if( packages ) free_packages();
   if( pkgrcl )   free_pkgrcl();
 
+  if( installed ) { pkgdb_set_free( installed ); installed = NULL; }
+
   if( curdir )         { free( curdir );         curdir         = NULL; }
   if( selfdir )        { free( selfdir );        selfdir        = NULL; }
 }
@@ -195,6 +224,14 @@ void usage()
   fprintf( stdout, "  -v,--version                  Display the version of %s utility.\n", program );
 
   fprintf( stdout, "  -c,--check-requires           Check the list of requires before install.\n" );
+  fprintf( stdout, "                                The installed packages are loaded once from\n" );
+  fprintf( stdout, "                                the Setup Database index and each package is\n" );
+  fprintf( stdout, "                                checked before install. The requires are taken\n" );
+  fprintf( stdout, "                                from the PKGLIST (see make-pkglist --levels)\n" );
+  fprintf( stdout, "                                or, if the PKGLIST has no requires, read from\n" );
+  fprintf( stdout, "                                .REQUIRES file of each package. In parallel\n" );
+  fprintf( stdout, "                                mode the packages are checked only if the\n" );
+  fprintf( stdout, "                                PKGLIST has requires or installation levels.\n" );
   fprintf( stdout, "  -g,--gpg-verify               Verify GPG2 signature. The signature must be\n" );
   fprintf( stdout, "                                saved in a file whose name is the same as the\n" );
   fprintf( stdout, "                                package file name, but with the extension '.asc'\n" );
@@ -206,6 +243,13 @@ void usage()
 #endif
   fprintf( stdout, "  --parallel                    Parallel installation (dangerous; required the\n" );
   fprintf( stdout, "                                checking of DB integrity after installation).\n" );
+  fprintf( stdout, "                                If the PKGLIST contains requires of packages\n" );
+  fprintf( stdout, "                                (see make-pkglist --levels) then the package\n" );
+  fprintf( stdout, "                                is installed only after required packages,\n" );
+  fprintf( stdout, "                                and the packages which require not installed\n" );
+  fprintf( stdout, "                                packages are skipped.\n" );
+  fprintf( stdout, "  -j,--jobs=<N>                 Number of parallel installations (default is\n" );
+  fprintf( stdout, "                                twice the number of CPUs).\n" );
   fprintf( stdout, "  --errlist                     Print the list of not installed packages to the\n" );
   fprintf( stdout, "                                stderr in following format:\n" );
   fprintf( stdout, "                                    group/name:version:status\n" );
@@ -543,12 +587,10 @@ static void set_signal_handlers()
 static enum _input_type check_package_file( char *uncompress, const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   if( uncompress )
   {
     *uncompress = '\0';
@@ -559,8 +601,6 @@ static enum _input_type check_package_file( char *uncompress, const char *fname
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -579,56 +619,23 @@ static enum _input_type check_package_file( char *uncompress, const char *fname
     close( fd ); return IFMT_LOG;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    if( uncompress ) { *uncompress = 'x'; }
-    close( fd ); return IFMT_PKG;
-  }
-
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    if( uncompress ) { *uncompress = 'j'; }
-    close( fd ); return IFMT_PKG;
-  }
+  close( fd );
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
-  {
-    if( uncompress ) { *uncompress = 'J'; }
-    close( fd ); return IFMT_PKG;
-  }
+  /* GZ, BZ2, XZ or TAR */
+  if( (compression = tarball_compression( fname )) == TARBALL_UNKNOWN ) return IFMT_UNKNOWN;
 
-  if( pkglog_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return IFMT_PKG;
-    }
-  }
+  if( uncompress ) { *uncompress = tarball_tar_option( compression ); }
 
-  close( fd ); return IFMT_UNKNOWN;
+  return IFMT_PKG;
 }
 
 
 void get_args( int argc, char *argv[] )
 {
 #if defined( HAVE_DIALOG )
-  const char* short_options = "hvcgimp:r:s:";
+  const char* short_options = "hvcgimj:p:r:s:";
 #else
-  const char* short_options = "hvcgp:r:s:";
+  const char* short_options = "hvcgj:p:r:s:";
 #endif
 
 #define PROGRESS 812
@@ -648,6 +655,7 @@ void get_args( int argc, char *argv[] )
     { "parallel",       no_argument,       NULL, PARALLEL },
     { "errlist",        no_argument,       NULL, _ERRLIST },
     { "progress",       no_argument,       NULL, PROGRESS },
+    { "jobs",           required_argument, NULL, 'j' },
     { "priority",       required_argument, NULL, 'p' },
     { "root",           required_argument, NULL, 'r' },
     { "source",         required_argument, NULL, 's' },
@@ -710,6 +718,23 @@ void get_args( int argc, char *argv[] )
         progress = 1;
         break;
       }
+      case 'j':
+      {
+        char *end = NULL;
+
+        if( optarg != NULL )
+        {
+          jobs = (int)strtol( (const char *)optarg, &end, 10 );
+          if( *end != '\0' || jobs < 1 )
+          {
+            FATAL_ERROR( "Invalid --jobs '%s' value", optarg );
+          }
+        }
+        else
+          /* option is present but without value */
+          usage();
+        break;
+      }
 
       case 'p':
       {
@@ -1063,6 +1088,9 @@ static void package_free( struct package *package )
 
     if( package->description ) { free( package->description ); package->description   = NULL; }
     if( package->tarball )     { free( package->tarball );     package->tarball   = NULL; }
+    if( package->required )    { free( package->required );    package->required  = NULL; }
+
+    if( package->dependents ) { dlist_free( package->dependents, NULL ); package->dependents = NULL; }
 
     free( package );
   }
@@ -1268,7 +1296,7 @@ static void read_pkglist_file( const char *fname )
   while( (ln = fgets( line, PATH_MAX, fp )) )
   {
     char *p = NULL;
-    char *name = NULL, *vers = NULL, *desc = NULL, *ball = NULL, *proc = NULL, *prio = NULL;
+    char *name = NULL, *vers = NULL, *desc = NULL, *ball = NULL, *proc = NULL, *prio = NULL, *levl = NULL, *reqs = NULL;
 
     ++lnum;
 
@@ -1309,6 +1337,9 @@ static void read_pkglist_file( const char *fname )
     if( (p = index( (const char *)desc, ':' )) ) { *p = '\0'; ball = ++p; desc = trim( desc ); } else continue;
     if( (p = index( (const char *)ball, ':' )) ) { *p = '\0'; proc = ++p; ball = trim( ball ); } else continue;
     if( (p = index( (const char *)proc, ':' )) ) { *p = '\0'; prio = ++p; proc = trim( proc ); } else continue;
+    if( (p = index( (const char *)prio, ':' )) ) { *p = '\0'; levl = ++p; }
+    if( levl && (p = index( (const char *)levl, ':' )) ) { *p = '\0'; reqs = ++p; if( *reqs ) reqs = trim( reqs ); }
+    if( levl ) levl = trim( levl );
     prio = trim( prio );
 
     if( name && vers && desc && ball && proc && prio )
@@ -1376,6 +1407,27 @@ static void read_pkglist_file( const char *fname )
 
       package->priority = priority;
 
+      /*********************
+        Installation level:
+       */
+      if( levl && *levl )
+      {
+        char *end = NULL;
+
+        package->level = (int)strtol( (const char *)levl, &end, 10 );
+        if( *end != '\0' || package->level < 1 )
+        {
+          FATAL_ERROR( "%s: %d: Invalid '%s' installation level value", basename( pkglist_fname ), lnum, levl );
+        }
+      }
+      else
+      {
+        levels = 0;
+      }
+
+      if( reqs ) package->required = strdup( (const char *)reqs );
+      else       dependencies = 0;
+
       /********************
         Install procedure:
        */
@@ -1416,20 +1468,248 @@ static void read_pkglist_file( const char *fname )
 }
 
 
+/*********************************************
+  Requires check functions:
+  ------------------------
+    The set of installed packages is loaded once
+    and updated when each package is installed,
+    so the packages of the list are checked in
+    memory without running check-requires.
+ */
+static void load_installed( void )
+{
+  char *pkgs_path = NULL;
+
+  pkgs_path = (char *)malloc( (size_t)PATH_MAX );
+  if( !pkgs_path ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  /* root is always have the trailing slash '/': */
+  (void)snprintf( pkgs_path, PATH_MAX, "%s%s", root, PACKAGES_PATH );
+  installed = pkgdb_set_load( (const char *)pkgs_path );
+
+  free( pkgs_path );
+}
+
+static void __print_missing( const char *group, const char *name, const char *version, void *user_data )
+{
+  int *counter = (int *)user_data;
+
+  if( !(*counter)++ ) fprintf( stdout, "\nNot installed required packages:\n\n" );
+
+  if( group )
+    fprintf( stdout, "  %s/%s=%s\n", group, name, version );
+  else
+    fprintf( stdout, "  %s=%s\n", name, version );
+}
+
 static void check_requires( void )
 {
-  if( requires )
+  const char  **triples = NULL;
+  struct dlist *list = NULL;
+  int           n = 0, missing = 0, printed = 0;
+
+  load_installed();
+
+  if( !requires ) return;
+
+  if( installed )
+  {
+    triples = (const char **)malloc( dlist_length( requires ) * 3 * sizeof(char *) );
+    if( !triples ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+    for( list = requires; list; list = dlist_next( list ), ++n )
+    {
+      struct pkg *pkg = (struct pkg *)list->data;
+
+      triples[n*3]     = pkg->group;
+      triples[n*3 + 1] = pkg->name;
+      triples[n*3 + 2] = pkg->version;
+    }
+
+    missing = pkgdb_check_requires( installed, NULL, NULL, triples, (uint32_t)n, __print_missing, (void *)&printed );
+    free( triples );
+
+    if( !missing ) return;
+
+    exit_status = 1;
+
+    fprintf( stdout, "\nThe input '%s' requires %d not installed packages.\n\n", basename( pkglist_fname ), missing );
+  }
+  else
   {
     exit_status = 1;
 
     fprintf( stdout, "\nThe input '%s' has the list of %d required packages.\n\n", basename( pkglist_fname ), dlist_length( requires ) );
+  }
+
+  if( tmpdir ) { _rm_tmpdir( (const char *)tmpdir ); free( tmpdir ); }
+  free_resources();
+  exit( exit_status );
+}
+
+/*******************************************************
+  read_package_requires() - reads the .REQUIRES file of
+                            the package tarball into the
+                            list of required packages
+                            {group/name=version | name=version}
+                            (the same as the eighth field
+                            of the PKGLIST).
+ */
+static void read_package_requires( struct package *package )
+{
+  const char * const names[] = { ".REQUIRES", NULL };
+  const char * const service[] = {
+    ".PKGINFO", ".REQUIRES", ".DESCRIPTION", ".RESTORELINKS", ".INSTALL", ".FILELIST", NULL
+  };
+
+  FILE   *fp = NULL;
+  char   *fname = NULL, *line = NULL, *ln = NULL, *reqs = NULL;
+  size_t  len = 0, size = 0;
+
+  fname = (char *)malloc( (size_t)PATH_MAX );
+  if( !fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  /* built-in TAR reader; tar(1) is used if the compression is not supported: */
+  if( tarball_extract_members( (const char *)package->tarball, (const char *)tmpdir, names, service ) < 0 )
+  {
+    pid_t p = (pid_t) -1;
+
+    (void)snprintf( fname, PATH_MAX, "tar -C %s -xf %s .REQUIRES > /dev/null 2>&1", tmpdir, package->tarball );
+    p = sys_exec_command( fname );
+    (void)sys_wait_command( p, (char *)NULL, PATH_MAX );
+  }
+
+  (void)sprintf( fname, "%s/.REQUIRES", tmpdir );
+
+  reqs = strdup( "" );
+  if( !reqs ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  /* a package without .REQUIRES has no requires: */
+  if( (fp = fopen( (const char *)fname, "r" )) )
+  {
+    line = (char *)malloc( (size_t)PATH_MAX );
+    if( !line ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+    while( (ln = fgets( line, PATH_MAX, fp )) )
+    {
+      size_t n;
 
-    if( tmpdir ) { _rm_tmpdir( (const char *)tmpdir ); free( tmpdir ); }
-    free_resources();
-    exit( exit_status );
+      ln = trim( ln );
+      if( !*ln || *ln == '#' || !index( ln, '=' ) ) continue;
+
+      n = strlen( ln );
+      if( len + n + 2 > size )
+      {
+        size = ( len + n + 2 ) * 2;
+        reqs = (char *)realloc( (void *)reqs, size );
+        if( !reqs ) { FATAL_ERROR( "Cannot allocate memory" ); }
+      }
+      if( len ) reqs[len++] = ',';
+      memcpy( (void *)&reqs[len], (const void *)ln, n + 1 );
+      len += n;
+    }
+
+    free( line );
+    fclose( fp );
+    (void)unlink( (const char *)fname );
   }
+
+  free( fname );
+
+  package->required = reqs;
 }
 
+/*******************************************************
+  __required_triples() - splits the list of required
+                         packages into (group, name,
+                         version) triples. The BUF holds
+                         the strings and should be freed
+                         with the returned array.
+ */
+static const char **__required_triples( struct package *package, char **buf, uint32_t *n )
+{
+  const char **triples = NULL;
+  char        *p = NULL, *q = NULL;
+  uint32_t     size = 1;
+
+  *buf = NULL; *n = 0;
+
+  if( !package->required || !*package->required ) return triples;
+
+  *buf = strdup( (const char *)package->required );
+  if( !*buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( p = *buf; *p; ++p ) if( *p == ',' ) ++size;
+
+  triples = (const char **)malloc( size * 3 * sizeof(char *) );
+  if( !triples ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( p = *buf; p; p = q )
+  {
+    char *name = NULL, *version = NULL;
+
+    if( (q = index( p, ',' )) ) *q++ = '\0';
+    if( !*p ) continue;
+
+    if( (version = index( p, '=' )) ) *version++ = '\0';
+
+    if( (name = index( p, '/' )) ) { *name++ = '\0'; triples[*n*3] = p;    triples[*n*3 + 1] = name; }
+    else                           {                  triples[*n*3] = NULL; triples[*n*3 + 1] = p;    }
+    triples[*n*3 + 2] = version;
+
+    ++(*n);
+  }
+
+  return triples;
+}
+
+/*
+  Returns 0 if all packages required by PACKAGE are installed. As in
+  install-package and check-requires a required package is satisfied
+  if it is installed in any version:
+ */
+static int check_package_requires( struct package *package )
+{
+  const char **triples = NULL;
+  char        *buf = NULL;
+  uint32_t     n = 0;
+  int          ret = 0;
+
+  if( !installed ) return ret;
+
+  /* the PKGLIST has no requires (made without --levels): */
+  if( !package->required ) read_package_requires( package );
+
+  triples = __required_triples( package, &buf, &n );
+
+  ret = pkgdb_check_requires( installed, (const char *)package->group, (const char *)package->name,
+                              (const char * const *)triples, n, NULL, NULL );
+
+  if( triples ) free( triples );
+  if( buf )     free( buf );
+
+  return ret;
+}
+
+static void add_installed( struct package *package )
+{
+  const char **triples = NULL;
+  char        *buf = NULL;
+  uint32_t     n = 0;
+
+  if( !installed ) return;
+
+  triples = __required_triples( package, &buf, &n );
+
+  pkgdb_set_add( installed, package->group, package->name, package->version, triples, n );
+
+  if( triples ) free( triples );
+  if( buf )     free( buf );
+}
+/*
+  End of requires check functions.
+ *********************************************/
+
 #if defined( HAVE_DIALOG )
 static DIALOG_LISTITEM *alloc_select_items( void )
 {
@@ -1675,6 +1955,7 @@ static void install_package( struct package *package )
     if( package->group )
       pkgrc->group = strdup( (const char *)package->group );
     pkgrc->pid     = sys_exec_command( cmd );
+    package->pid   = pkgrc->pid;
 
     add_pkgrc( pkgrc );
     ++__child;
@@ -1684,12 +1965,18 @@ static void install_package( struct package *package )
     pid_t p = (pid_t) -1;
     int  rc = 0;
 
+    if( check_package_requires( package ) )
+    {
+      FATAL_ERROR( "Required packages of '%s-%s' package are not installed", package->name, package->version );
+    }
+
     p = sys_exec_command( cmd );
     rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
     if( rc != 0 && rc != 31 )
     {
       FATAL_ERROR( "Cannot install '%s-%s' package", package->name, package->version );
     }
+    add_installed( package );
     ++__successful;
   }
 
@@ -1727,36 +2014,399 @@ static void serial_install_packages( void )
 }
 
 
+/*********************************************
+  Parallel installation scheduler:
+  -------------------------------
+    Packages are installed as a DAG: the package
+    starts only when all required packages listed
+    in the PKGLIST are installed successfully.
+    Dependents of failed packages are skipped.
+
+    If the PKGLIST has no requires but has levels
+    then packages are installed level by level,
+    otherwise in the list order (old PKGLISTs).
+ */
+#define SKIPPED_STATUS  252 /* required package is not installed */
+
+static int *unfinished = NULL; /* number of not finished packages of each level */
+static int  gate_level = 0, max_level = 0;
+
+static double __time( void )
+{
+  struct timeval tv;
+
+  gettimeofday( &tv, NULL );
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
+static int __compare_levels( const void *a, const void *b )
+{
+  struct package *pkg1 = (struct package *)a;
+  struct package *pkg2 = (struct package *)b;
+
+  return pkg1->level - pkg2->level;
+}
+
+static int __compare_keys( const void *a, const void *b )
+{
+  int ret = 0;
+
+  struct package *pkg1 = *(struct package **)a;
+  struct package *pkg2 = *(struct package **)b;
+
+  if( pkg1->group && pkg2->group ) ret = strcmp( pkg1->group, pkg2->group );
+  else if( pkg1->group )           ret =  1;
+  else if( pkg2->group )           ret = -1;
+
+  if( !ret ) ret = strcmp( pkg1->name, pkg2->name );
+
+  return ret;
+}
+
+/*
+  PKGLIST may contain several entries of the same package (for example,
+  INSTALL and then UPDATE, or the same group/name at two versions). Such
+  entries are processed in list order, so the sort keeps the list position
+  of equal keys and a requirement is resolved to the first entry.
+ */
+struct package_entry
+{
+  struct package *package;
+  int             order;    /* position in the PKGLIST */
+};
+
+static int __compare_entries( const void *a, const void *b )
+{
+  const struct package_entry *e1 = (const struct package_entry *)a;
+  const struct package_entry *e2 = (const struct package_entry *)b;
+
+  int ret = __compare_keys( (const void *)&e1->package, (const void *)&e2->package );
+
+  if( !ret ) ret = e1->order - e2->order;
+
+  return ret;
+}
+
+static struct package *first_entry( struct package_entry *array, int num, struct package *key )
+{
+  int lo = 0, hi = num;
+
+  while( lo < hi )
+  {
+    int mid = lo + (hi - lo) / 2;
+
+    if( __compare_keys( (const void *)&array[mid].package, (const void *)&key ) < 0 ) lo = mid + 1;
+    else                                                                            hi = mid;
+  }
+
+  if( lo < num && !__compare_keys( (const void *)&array[lo].package, (const void *)&key ) )
+    return array[lo].package;
+
+  return NULL;
+}
+
+static void add_dependent( struct package *required, struct package *package )
+{
+  required->dependents = dlist_append( required->dependents, (void *)package );
+  ++package->depended;
+}
+
+static void build_dependencies( void )
+{
+  struct package_entry *array = NULL;
+  struct dlist         *list  = NULL;
+  int                   i, j, num = dlist_length( packages );
+
+  if( !num ) return;
+
+  array = (struct package_entry *)malloc( (size_t)num * sizeof(struct package_entry) );
+  if( !array ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( i = 0, list = packages; list; ++i, list = dlist_next( list ) )
+  {
+    array[i].package = (struct package *)list->data;
+    array[i].order   = i;
+  }
+  qsort( (void *)array, (size_t)num, sizeof(struct package_entry), __compare_entries );
+
+  /* each entry waits for all earlier entries of the same package: */
+  for( i = 0; i < num; ++i )
+  {
+    for( j = i + 1; j < num; ++j )
+    {
+      if( __compare_keys( (const void *)&array[i].package, (const void *)&array[j].package ) ) break;
+      add_dependent( array[i].package, array[j].package );
+    }
+  }
+
+  for( list = packages; list; list = dlist_next( list ) )
+  {
+    struct package *package = (struct package *)list->data;
+    char           *reqs = NULL, *req = NULL, *save = NULL;
+
+    if( !package->required || !*package->required ) continue;
+
+    reqs = strdup( (const char *)package->required );
+    if( !reqs ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+    for( req = strtok_r( reqs, ",", &save ); req; req = strtok_r( NULL, ",", &save ) )
+    {
+      struct package key, *found = NULL;
+      char *p = NULL;
+
+      bzero( (void *)&key, sizeof(struct package) );
+
+      req = trim( req );
+      if( (p = index( (const char *)req, '=' )) ) { *p = '\0'; }
+      if( (p = index( (const char *)req, '/' )) ) { *p = '\0'; key.group = req; key.name = ++p; }
+      else                                       { key.name = req; }
+
+      /*
+        required packages skipped by --priority or by user are not waited for;
+        the entries of the same package are already ordered above:
+       */
+      found = first_entry( array, num, &key );
+      if( found && __compare_keys( (const void *)&found, (const void *)&package ) )
+        add_dependent( found, package );
+    }
+
+    free( reqs );
+  }
+
+  free( array );
+}
+
+static void init_level_gate( void )
+{
+  struct dlist *list = NULL;
+
+  /* The sort is stable, the order of packages within the level is kept: */
+  packages = dlist_sort( packages, __compare_levels );
+
+  list = dlist_last( packages );
+  max_level = ( list ) ? ((struct package *)list->data)->level : 0;
+
+  unfinished = (int *)calloc( (size_t)max_level + 2, sizeof(int) );
+  if( !unfinished ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( list = packages; list; list = dlist_next( list ) )
+    ++unfinished[((struct package *)list->data)->level];
+
+  gate_level = 1;
+}
+
+static void finish_level( struct package *package )
+{
+  if( !unfinished ) return;
+
+  --unfinished[package->level];
+  while( gate_level <= max_level && !unfinished[gate_level] ) ++gate_level;
+}
+
+static void skip_package( struct package *package )
+{
+  struct pkgrc *pkgrc = pkgrc_alloc();
+  struct dlist *list  = NULL;
+
+  package->state = JOB_SKIPPED;
+
+  pkgrc->name    = strdup( (const char *)package->name );
+  pkgrc->version = strdup( (const char *)package->version );
+  if( package->group )
+    pkgrc->group = strdup( (const char *)package->group );
+  pkgrc->status  = SKIPPED_STATUS;
+
+  add_pkgrc( pkgrc );
+  ++exit_status;
+  ++__terminated;
+
+  finish_level( package );
+
+  for( list = package->dependents; list; list = dlist_next( list ) )
+  {
+    struct package *dependent = (struct package *)list->data;
+    if( dependent->state == JOB_WAITING ) skip_package( dependent );
+  }
+}
+
+static struct dlist *finish_package( struct package *package, int status, struct dlist *ready )
+{
+  struct pkgrc *pkgrc = find_pkgrc( pkgrcl, package->pid );
+  int           rc    = 0;
+
+  package->time = __time() - package->start;
+
+  if( WIFEXITED( status ) )        rc = (int)WEXITSTATUS( status );
+  else if( WIFSIGNALED( status ) ) rc = 253;
+  else                             rc = 254;
+
+  if( pkgrc ) pkgrc->status = rc;
+
+  if( rc ) ++exit_status;
+  else     ++__successful;
+  ++__terminated;
+
+  finish_level( package );
+
+  /* 31 - package is already installed: */
+  if( rc == 0 || rc == 31 )
+  {
+    struct dlist *list = NULL;
+
+    package->state = JOB_DONE;
+    package->path  = package->time + ( (package->critical) ? package->critical->path : 0.0 );
+
+    add_installed( package );
+
+    for( list = package->dependents; list; list = dlist_next( list ) )
+    {
+      struct package *dependent = (struct package *)list->data;
+
+      if( !dependent->critical || dependent->critical->path < package->path ) dependent->critical = package;
+      if( --dependent->depended == 0 ) ready = dlist_append( ready, (void *)dependent );
+    }
+  }
+  else
+  {
+    struct dlist *list = NULL;
+
+    package->state = JOB_FAILED;
+
+    for( list = package->dependents; list; list = dlist_next( list ) )
+    {
+      struct package *dependent = (struct package *)list->data;
+      if( dependent->state == JOB_WAITING ) skip_package( dependent );
+    }
+  }
+
+  return ready;
+}
+
 static void *install_process( void *args )
 {
-  struct dlist *list = packages, *next = NULL;
+  struct dlist *ready = NULL, *running = NULL, *list = NULL;
 
-  int nstreams = ncpus * 2; /* two concurents for CPU */
+  int nstreams = ( jobs > 0 ) ? jobs : ncpus * 2; /* two concurents for CPU */
 
-  while( list )
+  if( dependencies )  build_dependencies();
+  else if( levels )   init_level_gate();
+
+  for( list = packages; list; list = dlist_next( list ) )
+  {
+    struct package *package = (struct package *)list->data;
+    if( !package->depended ) ready = dlist_append( ready, (void *)package );
+  }
+
+  while( ready || running )
   {
     struct package *package = NULL;
+    pid_t           pid;
+    int             status;
 
-    next = dlist_next( list );
-    package = (struct package *)list->data;
-    if( package )
+    /* start ready packages on available CPUs: */
+    while( ready && dlist_length( running ) < nstreams )
     {
+      package = (struct package *)ready->data;
+
+      /* wait for all packages of previous installation levels: */
+      if( unfinished && package->level > gate_level ) break;
+
+      ready = dlist_remove( ready, (const void *)package );
+
+      /*
+        Required packages are finished only if the scheduler keeps
+        the order of installation (by requires or by levels):
+       */
+      if( (dependencies || levels) && check_package_requires( package ) ) { skip_package( package ); continue; }
+
+      package->state = JOB_RUNNING;
+      package->start = __time();
       install_package( package );
+
+      running = dlist_append( running, (void *)package );
     }
-    list = next;
 
-    /* wait for available CPU: */
-    while( (__child - __terminated) > nstreams ) usleep( WAIT_USEC_FOR_CHILD );
+    if( !running ) break;
+
+    pid = waitpid( -1, &status, 0 );
+    if( pid == -1 )
+    {
+      if( errno == EINTR ) continue;
+      break;
+    }
+
+    for( list = running, package = NULL; list; list = dlist_next( list ) )
+    {
+      if( ((struct package *)list->data)->pid == pid ) { package = (struct package *)list->data; break; }
+    }
+    if( !package ) continue;
+
+    running = dlist_remove( running, (const void *)package );
+    ready   = finish_package( package, status, ready );
   }
 
+  /* packages with circular requires are never released: */
+  for( list = packages; list; list = dlist_next( list ) )
+  {
+    struct package *package = (struct package *)list->data;
+    if( package->state == JOB_WAITING ) skip_package( package );
+  }
+
+  dlist_free( ready, NULL );
+  dlist_free( running, NULL );
+
+  if( unfinished ) { free( unfinished ); unfinished = NULL; }
+
+  __done = 1;
+
   return NULL;
 }
 
+static void print_critical_path( void )
+{
+  struct package *last = NULL, *package = NULL;
+  struct dlist   *list = NULL, *path = NULL;
+
+  for( list = packages; list; list = dlist_next( list ) )
+  {
+    package = (struct package *)list->data;
+    if( package->state == JOB_DONE && (!last || last->path < package->path) ) last = package;
+  }
+  if( !last ) return;
+
+  for( package = last; package; package = package->critical ) path = dlist_prepend( path, (void *)package );
+
+  fprintf( stdout, "Critical path: %d packages, %.1f seconds:\n", dlist_length( path ), last->path );
+  for( list = path; list; list = dlist_next( list ) )
+  {
+    package = (struct package *)list->data;
+
+    if( package->group )
+      fprintf( stdout, "  %s/%s-%s (%.1f s)\n", package->group, package->name, package->version, package->time );
+    else
+      fprintf( stdout, "  %s-%s (%.1f s)\n", package->name, package->version, package->time );
+  }
+  fprintf( stdout, "\n" );
+
+  dlist_free( path, NULL );
+}
+/*
+  End of parallel installation scheduler.
+ */
+
 static void parallel_install_packages( void )
 {
   pthread_t install_process_id;
   int       status;
 
+  struct sigaction sa;
+
+  /* Children are collected by the scheduler thread using waitpid(2): */
+  memset( &sa, 0, sizeof( sa ) );
+  sa.sa_handler = SIG_DFL;
+  sigemptyset( &sa.sa_mask );
+  sigaction( SIGCHLD, &sa, NULL );
+
   /* Start the parallel installation process: */
   status = pthread_create( &install_process_id, NULL, install_process, NULL );
   if( status != 0 )
@@ -1988,6 +2638,7 @@ int main( int argc, char *argv[] )
     else
     {
       fprintf( stdout, "\nSuccessfully installed %d%% of %d specified packages.\n\n", percent, __all );
+      if( dependencies ) print_critical_path();
     }
 
     cleanup_pkgrcl();  /* remove successfully installed packages from return codes list */
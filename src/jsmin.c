@@ -21,23 +21,32 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>  /* bzero(3) */
 #include <libgen.h>   /* basename(3) */
 
 #include <msglog.h>
 
 #include <jsmin.h>
 
-static FILE *ifile;
-static FILE *ofile;
+enum _jsmin_state
+{
+  JSMIN_CODE = 0,
+  JSMIN_SLASH,         /* '/' is read, comment may start */
+  JSMIN_LINE_COMMENT,
+  JSMIN_BLOCK_COMMENT,
+  JSMIN_BLOCK_STAR,    /* '*' is read in the block comment */
+  JSMIN_STRING,
+  JSMIN_ESCAPE         /* '\' is read in the string literal */
+};
 
-static const char *input_fname = NULL;
 
-static void error( const char *fname, char *s )
+static void error( struct jsmin *jsmin, char *s )
 {
-  if( fname )
-    ERROR( "JSMIN: %s: %s", basename( (char *)fname ), s );
+  if( jsmin->name )
+    ERROR( "JSMIN: %s: %s", basename( (char *)jsmin->name ), s );
   else
     ERROR( "JSMIN: %s", s );
+  ++jsmin->errors;
 }
 
 static int is_alpha_or_num( int c )
@@ -46,281 +55,323 @@ static int is_alpha_or_num( int c )
           (c >= 'A' && c <= 'Z') || c == '_' || c == '$' || c == '\\' || c > 126 );
 }
 
-static int  a;
-static int  b;
-static int  lookahead = EOF;
-static int  x = EOF;
-static int  y = EOF;
 
-/*
-  get - return the next character from stdin. Watch out for lookahead. If
-        the character is a control character, translate it to a space or
-        linefeed.
- */
-static int get()
+static void flush( struct jsmin *jsmin )
 {
-  int c = lookahead;
-  lookahead = EOF;
-  if( c == EOF )
+  if( jsmin->output && jsmin->len )
   {
-    c = getc( ifile );
+    (void)fwrite( (const void *)jsmin->data, 1, jsmin->len, jsmin->output );
+    jsmin->len = 0;
   }
-  if( c >= ' ' || c == '\n' || c == EOF )
+}
+
+/* makes room in the full output buffer: */
+static void reserve( struct jsmin *jsmin )
+{
+  if( jsmin->output )
   {
-    return c;
+    flush( jsmin );
   }
-  if( c == '\r' )
+  else
   {
-    return '\n';
+    jsmin->size *= 2;
+    jsmin->data = (char *)realloc( (void *)jsmin->data, jsmin->size );
+    if( !jsmin->data ) { FATAL_ERROR( "Cannot allocate memory" ); }
   }
-  return ' ';
 }
 
+static void put( struct jsmin *jsmin, int c )
+{
+  if( jsmin->len + 1 >= jsmin->size ) reserve( jsmin );
+  jsmin->data[jsmin->len++] = (char)c;
+}
 
-/*
-  peek - get the next character without getting it.
- */
-static int peek()
+static void put_block( struct jsmin *jsmin, const unsigned char *s, size_t len )
 {
-  lookahead = get();
-  return lookahead;
+  while( len )
+  {
+    size_t n = jsmin->size - jsmin->len - 1; /* keep the place of terminating zero */
+
+    if( !n ) { reserve( jsmin ); continue; }
+    if( n > len ) n = len;
+
+    memcpy( (void *)&jsmin->data[jsmin->len], (const void *)s, n );
+    jsmin->len += n; s += n; len -= n;
+  }
 }
 
 
 /*
-  next - get the next character, excluding comments. peek() is used to see
-         if a '/' is followed by a '/' or '*'.
+  action - do something with the current character A and the next
+           character B. What you do is determined by the argument:
+           1   Output A. Copy B to A.
+           2   Copy B to A. (Delete A).
+           3   Delete B.
+  If the new A starts a string, the string is copied to the output
+  by code() until the closing quote which becomes the new A.
  */
-static int next()
+static void action( struct jsmin *jsmin, int b )
 {
-  int c = get();
-  if ( c == '/' )
+  int a = jsmin->a, d;
+
+  jsmin->y = jsmin->x;
+  jsmin->x = b;
+
+  switch( a )
   {
-    switch( peek() )
-    {
-      case '/':
-        for( ;; )
-        {
-          c = get();
-          if( c <= '\n' )
-          {
-            break;
-          }
-        }
-        break;
-      case '*':
-        get();
-        while( c != ' ' )
-        {
-          switch( get() )
+    case ' ':
+      d = is_alpha_or_num( b ) ? 1 : 2;
+      break;
+    case '\n':
+      switch( b )
+      {
+        case '{': case '[': case '(':
+        case '+': case '-': case '!':
+        case '~':
+          d = 1;
+          break;
+        case ' ':
+          d = 3;
+          break;
+        default:
+          d = is_alpha_or_num( b ) ? 1 : 2;
+      }
+      break;
+    default:
+      switch( b )
+      {
+        case ' ':
+          d = is_alpha_or_num( a ) ? 1 : 3;
+          break;
+        case '\n':
+          switch( a )
           {
-            case '*':
-              if( peek() == '/' )
-              {
-                get();
-                c = ' ';
-              }
+            case '}':  case ']': case ')':
+            case '+':  case '-': case '"':
+            case '\'': case '`':
+              d = 1;
               break;
-            case EOF:
-              error( input_fname, "Unterminated comment" );
-              return EOF;
+            default:
+              d = is_alpha_or_num( a ) ? 1 : 3;
           }
-        }
-        break;
+          break;
+        default:
+          d = 1;
+          break;
+      }
+  }
+
+  if( d == 3 ) return;
+
+  if( d == 1 )
+  {
+    /* line feeds are never printed */
+    if( a != '\n' ) put( jsmin, a );
+    if( (jsmin->y == '\n' || jsmin->y == ' ') &&
+        (a == '+' || a == '-' || a == '*' || a == '/') &&
+        (b == '+' || b == '-' || b == '*' || b == '/')    )
+    {
+      put( jsmin, jsmin->y );
     }
   }
-  y = x;
-  x = c;
-  return c;
+
+  jsmin->a = b;
+  if( b == '\'' || b == '"' || b == '`' )
+  {
+    put( jsmin, b );
+    jsmin->quote = b;
+    jsmin->state = JSMIN_STRING;
+  }
 }
 
 
 /*
-  action - do something! What you do is determined by the argument:
-           1   Output A. Copy B to A. Get the next B.
-           2   Copy B to A. Get the next B. (Delete A).
-           3   Get the next B. (Delete B).
-  action treats a string as a single character. Wow!
-  action recognizes a regular expression if it is preceded by ( or , or =.
+  code - process the next character of input, excluding comments.
  */
-static void action( int d )
+static void code( struct jsmin *jsmin, int c )
 {
-  switch( d )
+  switch( jsmin->state )
   {
-    case 1:
-      /* skip first carriage return */
-      if( a != '\n' ) putc( a, ofile );
-      if( (y == '\n' || y == ' ') &&
-          (a == '+' || a == '-' || a == '*' || a == '/') &&
-          (b == '+' || b == '-' || b == '*' || b == '/')    )
+    case JSMIN_CODE:
+      if( c == '/' ) jsmin->state = JSMIN_SLASH;
+      else           action( jsmin, c );
+      break;
+
+    case JSMIN_SLASH:
+      if( c == '/' )      { jsmin->state = JSMIN_LINE_COMMENT;  }
+      else if( c == '*' ) { jsmin->state = JSMIN_BLOCK_COMMENT; }
+      else
       {
-        putc( y, ofile );
+        jsmin->state = JSMIN_CODE;
+        action( jsmin, '/' );
+        code( jsmin, c );
       }
-    case 2:
-      a = b;
-      if( a == '\'' || a == '"' || a == '`' )
+      break;
+
+    case JSMIN_LINE_COMMENT:
+      if( c == '\n' )
       {
-        for( ;; )
-        {
-          putc( a, ofile );
-          a = get();
-          if( a == b )
-          {
-            break;
-          }
-          if( a == '\\' )
-          {
-            putc( a, ofile );
-            a = get();
-          }
-          if( a == EOF )
-          {
-            error( input_fname, "Unterminated string literal" );
-            return;
-          }
-        }
+        jsmin->state = JSMIN_CODE;
+        action( jsmin, c );
       }
-    case 3:
-      b = next();
-      if( b == '/' &&
-          ( a == '(' || a == ',' || a == '=' || a == ':' ||
-            a == '[' || a == '!' || a == '&' || a == '|' ||
-            a == '?' || a == '+' || a == '-' || a == '~' ||
-            a == '*' || a == '/' || a == '{' || a == '\n' ) )
+      break;
+
+    case JSMIN_BLOCK_COMMENT:
+      if( c == '*' ) jsmin->state = JSMIN_BLOCK_STAR;
+      break;
+
+    case JSMIN_BLOCK_STAR:
+      if( c == '/' )
       {
-        putc( a, ofile );
-        if( a == '/' || a == '*' )
-        {
-          putc( ' ', ofile );
-        }
-        putc( b, ofile );
-        for( ;; )
-        {
-          a = get();
-          if( a == '[' )
-          {
-            for( ;; )
-            {
-              putc( a, ofile );
-              a = get();
-              if( a == ']' )
-              {
-                break;
-              }
-              if( a == '\\' )
-              {
-                putc( a, ofile );
-                a = get();
-              }
-              if( a == EOF )
-              {
-                error( input_fname, "Unterminated set in Regular Expression literal" );
-                return;
-              }
-            }
-          }
-          else if( a == '/' )
-          {
-            switch( peek() )
-            {
-              case '/':
-              case '*':
-                error( input_fname, "Unterminated set in Regular Expression literal" );
-                return;
-            }
-            break;
-          }
-          else if( a =='\\' )
-          {
-            putc( a, ofile );
-            a = get();
-          }
-          if( a == EOF )
-          {
-            error( input_fname, "Unterminated Regular Expression literal" );
-            return;
-          }
-          putc( a, ofile );
-        }
-      b = next();
-    }
+        /* the comment is replaced by space */
+        jsmin->state = JSMIN_CODE;
+        action( jsmin, ' ' );
+      }
+      else if( c != '*' )
+      {
+        jsmin->state = JSMIN_BLOCK_COMMENT;
+      }
+      break;
+
+    case JSMIN_STRING:
+      if( c == jsmin->quote )
+      {
+        /* closing quote is printed as A */
+        jsmin->state = JSMIN_CODE;
+        jsmin->a = c;
+      }
+      else
+      {
+        if( c == '\\' ) jsmin->state = JSMIN_ESCAPE;
+        put( jsmin, c );
+      }
+      break;
+
+    case JSMIN_ESCAPE:
+      jsmin->state = JSMIN_STRING;
+      put( jsmin, c );
+      break;
   }
 }
 
 
-/*
-  jsmin - Copy the input to the output, deleting the characters which are
-          insignificant to JavaScript. Comments will be removed. Tabs will be
-          replaced with spaces. Carriage returns will be replaced with linefeeds.
-          Most spaces and linefeeds will be removed.
-*/
-static void jsmin()
+void jsmin_init( struct jsmin *jsmin, FILE *output, const char *name )
 {
-  if( peek() == 0xEF ) { get(); get(); get(); }
-  a = '\n';
-  action( 3 );
+  if( !jsmin ) return;
+
+  bzero( (void *)jsmin, sizeof(struct jsmin) );
+
+  jsmin->a      = '\n';
+  jsmin->x      = EOF;
+  jsmin->y      = EOF;
+  jsmin->state  = JSMIN_CODE;
+  jsmin->output = output;
+  jsmin->name   = name;
 
-  while( a != EOF )
+  jsmin->size = JSMIN_BUFFER_SIZE;
+  jsmin->data = (char *)malloc( jsmin->size );
+  if( !jsmin->data ) { FATAL_ERROR( "Cannot allocate memory" ); }
+}
+
+void jsmin_write( struct jsmin *jsmin, const char *buf, size_t len )
+{
+  const unsigned char *p = (const unsigned char *)buf, *e = p + len;
+
+  if( !jsmin || !buf ) return;
+
+  /* skip UTF-8 BOM: */
+  while( jsmin->bom < 3 && p < e )
+  {
+    if( jsmin->bom == 0 && *p != 0xef ) { jsmin->bom = 3; break; }
+    ++jsmin->bom; ++p;
+  }
+
+  for( ; p < e; ++p )
   {
-    switch( a )
+    int c = *p;
+
+    if( jsmin->state == JSMIN_STRING )
     {
-      case ' ':
-        action(is_alpha_or_num(b) ? 1 : 2);
-        break;
-      case '\n':
-        switch( b )
-        {
-          case '{': case '[': case '(':
-          case '+': case '-': case '!':
-          case '~':
-            action( 1 );
-            break;
-          case ' ':
-            action( 3 );
-            break;
-          default:
-            action( is_alpha_or_num(b) ? 1 : 2 );
-        }
-        break;
-      default:
-        switch( b )
-        {
-          case ' ':
-            action( is_alpha_or_num(a) ? 1 : 3 );
-            break;
-          case '\n':
-            switch( a )
-            {
-              case '}':  case ']': case ')':
-              case '+':  case '-': case '"':
-              case '\'': case '`':
-                action( 1 );
-                break;
-              default:
-                action( is_alpha_or_num(a) ? 1 : 3 );
-            }
-            break;
-          default:
-            action( 1 );
-            break;
-        }
+      /* copy the plain characters of string literal at once */
+      const unsigned char *s = p;
+
+      while( s < e && *s >= ' ' && *s != jsmin->quote && *s != '\\' ) ++s;
+      if( s != p )
+      {
+        put_block( jsmin, p, (size_t)(s - p) );
+        if( s == e ) break;
+        p = s; c = *p;
+      }
     }
+
+    /* control characters are translated to spaces or line feeds */
+    if( c < ' ' && c != '\n' ) c = ( c == '\r' ) ? '\n' : ' ';
+
+    code( jsmin, c );
+  }
+}
+
+int jsmin_finish( struct jsmin *jsmin )
+{
+  if( !jsmin ) return -1;
+
+  switch( jsmin->state )
+  {
+    case JSMIN_SLASH:
+      jsmin->state = JSMIN_CODE;
+      action( jsmin, '/' );
+      break;
+    case JSMIN_BLOCK_COMMENT:
+    case JSMIN_BLOCK_STAR:
+      error( jsmin, "Unterminated comment" );
+      break;
+    case JSMIN_STRING:
+    case JSMIN_ESCAPE:
+      error( jsmin, "Unterminated string literal" );
+      break;
+    default:
+      break;
+  }
+
+  if( jsmin->state != JSMIN_STRING && jsmin->state != JSMIN_ESCAPE &&
+      jsmin->a != '\n' && jsmin->a != ' ' )
+  {
+    put( jsmin, jsmin->a );
   }
-  /* lats carriage return */
-  putc( '\n', ofile );
+  jsmin->a = EOF;
+
+  /* last carriage return */
+  put( jsmin, '\n' );
+
+  flush( jsmin );
+  jsmin->data[jsmin->len] = '\0';
+
+  return ( jsmin->errors ) ? -1 : 0;
+}
+
+void jsmin_free( struct jsmin *jsmin )
+{
+  if( !jsmin ) return;
+
+  if( jsmin->data ) { free( jsmin->data ); jsmin->data = NULL; }
+  jsmin->len = jsmin->size = 0;
 }
 
 
 int minimize_json( const char *ifname, const char *ofname )
 {
+  FILE  *ifile, *ofile;
+  char  *buf;
+  size_t len;
+
+  struct jsmin jsmin;
+
   int status, ret = -1;
 
   if( !ifname || !ofname ) return ret;
 
   status = exit_status; exit_status = 0;
 
-  input_fname = ifname;
-
   ret = 0;
 
   ifile = fopen( ifname, "r" );
@@ -335,14 +386,25 @@ int minimize_json( const char *ifname, const char *ofname )
   if( ofile == NULL )
   {
     ERROR( "JSMIN: Can't open '%s' file", ofname );
+    fclose( ifile );
     exit_status = status + exit_status;
     return ret;
   }
 
-  jsmin();
+  buf = (char *)malloc( (size_t)JSMIN_BUFFER_SIZE );
+  if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  jsmin_init( &jsmin, ofile, ifname );
+  while( (len = fread( (void *)buf, 1, (size_t)JSMIN_BUFFER_SIZE, ifile )) > 0 )
+  {
+    jsmin_write( &jsmin, (const char *)buf, len );
+  }
+  (void)jsmin_finish( &jsmin );
+  jsmin_free( &jsmin );
+  free( buf );
 
-  fclose( ifile ); ifile = NULL;
-  fflush( ofile ); fclose( ofile ); ofile = NULL;
+  fclose( ifile );
+  fflush( ofile ); fclose( ofile );
 
   if( exit_status == 0 )
   {
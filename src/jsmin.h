@@ -24,6 +24,57 @@ extern "C" {
 #endif
 
 
+#include <stddef.h>
+#include <stdio.h>
+
+
+/***************************************************************
+  JSON minimizer:
+  ==============
+
+    Removes comments, spaces and line feeds which are insignificant
+    to JSON. The input is passed by blocks of any size; the state of
+    minimizer is kept between calls, so a document can be minimized
+    while it is being written (for example, by the JSON writer, see
+    json_init_jsmin()):
+
+      struct jsmin jsmin;
+
+      jsmin_init( &jsmin, output, NULL );
+      while( (len = fread( buf, 1, sizeof(buf), input )) > 0 )
+        jsmin_write( &jsmin, buf, len );
+      if( jsmin_finish( &jsmin ) < 0 ) { ... }
+      jsmin_free( &jsmin );
+
+    If the OUTPUT file is NULL the result is collected in memory:
+    jsmin.data (terminated by zero) of jsmin.len bytes is valid up
+    to jsmin_free(). The NAME is used in error messages only.
+
+    Regular expression literals of JavaScript are not recognized.
+ */
+#define JSMIN_BUFFER_SIZE  (64 * 1024)
+
+struct jsmin
+{
+  int     a;      /* the character to be output */
+  int     x, y;   /* the last two characters passed to action() */
+  int     state;
+  int     quote;  /* quote character of current string literal */
+  int     bom;    /* number of processed bytes of UTF-8 BOM */
+  int     errors;
+
+  FILE   *output;
+  char   *data;
+  size_t  len, size;
+
+  const char *name;
+};
+
+extern void jsmin_init( struct jsmin *jsmin, FILE *output, const char *name );
+extern void jsmin_write( struct jsmin *jsmin, const char *buf, size_t len );
+extern  int jsmin_finish( struct jsmin *jsmin );
+extern void jsmin_free( struct jsmin *jsmin );
+
 extern int minimize_json( const char *ifname, const char *ofname );
 
 
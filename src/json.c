@@ -0,0 +1,259 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <strings.h>  /* bzero(3) */
+
+#include <msglog.h>
+
+#include <json.h>
+
+
+static const char spaces[] = "                                                                "
+                             "                                                                ";
+
+#define SPACES_LENGTH  ( sizeof( spaces ) - 1 )
+
+
+static void __output_init( struct json_output *out, FILE *fp, struct jsmin *jsmin )
+{
+  out->fp    = fp;
+  out->jsmin = jsmin;
+  out->len   = 0;
+  out->buf   = NULL;
+
+  if( !fp && !jsmin ) return;
+
+  out->buf = (char *)malloc( (size_t)JSON_BUFFER_SIZE );
+  if( !out->buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+}
+
+static void __output_send( struct json_output *out, const char *s, size_t len )
+{
+  if( out->jsmin )
+    jsmin_write( out->jsmin, s, len );
+  else
+    (void)fwrite( (const void *)s, 1, len, out->fp );
+}
+
+static void __output_flush( struct json_output *out )
+{
+  if( out->len )
+  {
+    __output_send( out, (const char *)out->buf, out->len );
+    out->len = 0;
+  }
+}
+
+static void __output_write( struct json_output *out, const char *s, size_t len )
+{
+  if( !out->buf ) return;
+
+  if( out->len + len > JSON_BUFFER_SIZE )
+  {
+    __output_flush( out );
+    if( len > JSON_BUFFER_SIZE )
+    {
+      __output_send( out, s, len );
+      return;
+    }
+  }
+  memcpy( (void *)&out->buf[out->len], (const void *)s, len );
+  out->len += len;
+}
+
+static void __output_free( struct json_output *out )
+{
+  if( !out->buf ) return;
+
+  __output_flush( out );
+  free( out->buf );
+  out->buf   = NULL;
+  out->fp    = NULL;
+  out->jsmin = NULL;
+}
+
+
+void json_init( struct json *json, FILE *pretty, FILE *compact )
+{
+  if( !json ) return;
+
+  bzero( (void *)json, sizeof(struct json) );
+
+  __output_init( &json->pretty,  pretty,  NULL );
+  __output_init( &json->compact, compact, NULL );
+}
+
+void json_init_jsmin( struct json *json, FILE *pretty, struct jsmin *compact )
+{
+  if( !json ) return;
+
+  bzero( (void *)json, sizeof(struct json) );
+
+  __output_init( &json->pretty,  pretty, NULL );
+  __output_init( &json->compact, NULL,   compact );
+}
+
+void json_free( struct json *json )
+{
+  if( !json ) return;
+
+  /* minimize_json() ends the output by line feed: */
+  __output_write( &json->compact, "\n", 1 );
+
+  __output_free( &json->pretty );
+  __output_free( &json->compact );
+
+  if( json->scratch ) { free( json->scratch ); json->scratch = NULL; }
+  json->size = 0;
+}
+
+
+static void __write( struct json *json, const char *s, size_t len )
+{
+  __output_write( &json->pretty,  s, len );
+  __output_write( &json->compact, s, len );
+}
+
+void json_text( struct json *json, const char *text )
+{
+  const char *p, *e;
+  int   quoted = 0;
+
+  if( !json || !text ) return;
+
+  __output_write( &json->pretty, text, strlen( text ) );
+
+  if( !json->compact.buf ) return;
+
+  for( p = e = text; *e; ++e )
+  {
+    if( *e == '"' ) quoted = !quoted;
+    if( !quoted && (*e == ' ' || *e == '\n') )
+    {
+      if( e != p ) __output_write( &json->compact, p, (size_t)(e - p) );
+      p = e + 1;
+    }
+  }
+  if( e != p ) __output_write( &json->compact, p, (size_t)(e - p) );
+}
+
+void json_indent( struct json *json, int depth )
+{
+  if( !json || !json->pretty.buf ) return;
+
+  while( depth > 0 )
+  {
+    size_t len = ( (size_t)depth < SPACES_LENGTH ) ? (size_t)depth : SPACES_LENGTH;
+
+    __output_write( &json->pretty, spaces, len );
+    depth -= (int)len;
+  }
+}
+
+
+static void __escape( struct json *json, const char *s )
+{
+  const char *p = s;
+
+  while( *p )
+  {
+    const char *e = p;
+    char        esc[8];
+
+    while( *e && *e != '"' && *e != '\\' && (unsigned char)*e >= ' ' ) ++e;
+    if( e != p ) __write( json, p, (size_t)(e - p) );
+    if( !*e ) break;
+
+    switch( *e )
+    {
+      case '"':  __write( json, "\\\"", 2 ); break;
+      case '\\': __write( json, "\\\\", 2 ); break;
+      case '\n': __write( json, "\\n",  2 ); break;
+      case '\t': __write( json, "\\t",  2 ); break;
+      case '\r': __write( json, "\\r",  2 ); break;
+      default:
+        (void)sprintf( esc, "\\u%04x", (unsigned char)*e );
+        __write( json, esc, 6 );
+        break;
+    }
+    p = e + 1;
+  }
+}
+
+void json_string( struct json *json, const char *s )
+{
+  if( !json ) return;
+
+  __write( json, "\"", 1 );
+  if( s ) __escape( json, s );
+  __write( json, "\"", 1 );
+}
+
+
+static const char *__vformat( struct json *json, const char *format, va_list ap )
+{
+  va_list aq;
+  int     len;
+
+  va_copy( aq, ap );
+  len = vsnprintf( json->scratch, json->size, format, aq );
+  va_end( aq );
+
+  if( len < 0 ) return "";
+
+  if( (size_t)len >= json->size )
+  {
+    json->size = (size_t)len + 1 > (size_t)PATH_MAX ? (size_t)len + 1 : (size_t)PATH_MAX;
+    json->scratch = (char *)realloc( (void *)json->scratch, json->size );
+    if( !json->scratch ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+    (void)vsnprintf( json->scratch, json->size, format, ap );
+  }
+
+  return (const char *)json->scratch;
+}
+
+void json_stringf( struct json *json, const char *format, ... )
+{
+  va_list ap;
+
+  if( !json || !format ) return;
+
+  va_start( ap, format );
+  json_string( json, __vformat( json, format, ap ) );
+  va_end( ap );
+}
+
+void json_printf( struct json *json, const char *format, ... )
+{
+  va_list     ap;
+  const char *s;
+
+  if( !json || !format ) return;
+
+  va_start( ap, format );
+  s = __vformat( json, format, ap );
+  __write( json, s, strlen( s ) );
+  va_end( ap );
+}
@@ -0,0 +1,100 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#ifndef _JSON_H_
+#define _JSON_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <jsmin.h>
+
+
+/***************************************************************
+  JSON writer:
+  ===========
+
+    Streaming JSON emitter with large output buffers. The same
+    document can be written into two files at once: the PRETTY
+    one is formatted by the caller and the COMPACT one gets the
+    same text without insignificant spaces and line feeds  (as
+    the minimize_json() does), so the .min.json file is created
+    without second pass over the .json file:
+
+      struct json json;
+
+      json_init( &json, pretty_fp, compact_fp );
+
+      json_text( &json, "{\n" );
+      json_indent( &json, 1 );
+      json_text( &json, "\"name\": " );
+      json_string( &json, name );
+      json_text( &json, "\n}\n" );
+
+      json_free( &json );
+
+    Any of the files may be NULL. The json_text() outputs layout
+    and punctuation: spaces and line feeds outside of quotes are
+    removed from the COMPACT output. The json_string() adds the
+    quotes and escapes the value. The json_free() flushes buffers
+    and ends the COMPACT output by line feed.
+
+    The json_init_jsmin() passes the COMPACT output to the JSMIN
+    minimizer instead of file  (for example, to get the minimized
+    document in memory). The caller finishes JSMIN after json_free().
+ */
+#define JSON_BUFFER_SIZE  (256 * 1024) /* size of output buffers */
+
+struct json_output
+{
+  FILE         *fp;
+  struct jsmin *jsmin;
+
+  char   *buf;
+  size_t  len;
+};
+
+struct json
+{
+  struct json_output pretty;
+  struct json_output compact;
+
+  char   *scratch; /* formatted values */
+  size_t  size;
+};
+
+extern void json_init( struct json *json, FILE *pretty, FILE *compact );
+extern void json_init_jsmin( struct json *json, FILE *pretty, struct jsmin *compact );
+extern void json_free( struct json *json );
+
+extern void json_text( struct json *json, const char *text );
+extern void json_indent( struct json *json, int depth );
+
+extern void json_string( struct json *json, const char *s );
+extern void json_stringf( struct json *json, const char *format, ... );
+extern void json_printf( struct json *json, const char *format, ... );
+
+
+#ifdef __cplusplus
+}  /* ... extern "C" */
+#endif
+
+#endif /* _JSON_H_ */
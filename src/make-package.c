@@ -79,6 +79,7 @@ char *selfdir     = NULL;
 
 int   mkgroupdir  = 0;
 int   linkadd     = 1;
+int   service_first = 0;
 
 static char           *pkgname = NULL,
                        *pkgver = NULL,
@@ -92,7 +93,7 @@ static char           *pkgname = NULL,
             *uncompressed_size = NULL,
                   *total_files = NULL;
 
-struct dlist *filelist = NULL;
+struct dlist_head filelist = DLIST_HEAD_INIT;
 
 static void create_file_list( void );
 static void free_file_list( void );
@@ -116,7 +117,7 @@ void free_resources()
   if( srcdir )        { free( srcdir );        srcdir        = NULL; }
   if( destination )   { free( destination );   destination   = NULL; }
   if( flavour )       { free( flavour );       flavour       = NULL; }
-  if( filelist )      { free_file_list();      filelist      = NULL; }
+  free_file_list();
 
 #if defined( HAVE_GPG2 )
   if( passphrase )    { free( passphrase );    passphrase    = NULL; }
@@ -154,6 +155,9 @@ void usage()
   fprintf( stdout, "  -l,--linkadd={y|n}         Create .RESTORELINKS scrypt (default yes).\n" );
   fprintf( stdout, "  -f,--flavour=<subdir>      The name of additional subdirectory in the\n" );
   fprintf( stdout, "                             GROUP directory to save target PACKAGE.\n" );
+  fprintf( stdout, "  -s,--service-first         Place service files at the beginning of the\n" );
+  fprintf( stdout, "                             PACKAGE archive to allow utilities read them\n" );
+  fprintf( stdout, "                             without uncompressing whole package.\n" );
   fprintf( stdout, "\n" );
 #if defined( HAVE_GPG2 )
   fprintf( stdout, "OpenPGP options:\n" );
@@ -440,9 +444,9 @@ static void set_signal_handlers()
 void get_args( int argc, char *argv[] )
 {
 #if defined( HAVE_GPG2 )
-  const char* short_options = "hvmd:l:f:p:k:Jjz";
+  const char* short_options = "hvmd:l:f:sp:k:Jjz";
 #else
-  const char* short_options = "hvmd:l:f:Jjz";
+  const char* short_options = "hvmd:l:f:sJjz";
 #endif
 
   const struct option long_options[] =
@@ -453,6 +457,7 @@ void get_args( int argc, char *argv[] )
     { "mkgroupdir",  no_argument,       NULL, 'm' },
     { "linkadd",     required_argument, NULL, 'l' },
     { "flavour",     required_argument, NULL, 'f' },
+    { "service-first", no_argument,     NULL, 's' },
 #if defined( HAVE_GPG2 )
     { "passphrase",  required_argument, NULL, 'p' },
     { "key-id",      required_argument, NULL, 'k' },
@@ -498,6 +503,11 @@ void get_args( int argc, char *argv[] )
         mkgroupdir = 1;
         break;
       }
+      case 's':
+      {
+        service_first = 1;
+        break;
+      }
 
       case 'J':
       {
@@ -999,7 +1009,7 @@ static int _compare_fnames( const void *a, const void *b )
 static void _push_file( const char *name )
 {
   char *fname = (char *)name + strlen( srcdir ) + 1;
-  filelist = dlist_append( filelist, (void *)strdup( fname ) );
+  dlist_head_append( &filelist, (void *)strdup( fname ) );
 }
 
 static void _push_dir( const char *name )
@@ -1011,7 +1021,7 @@ static void _push_dir( const char *name )
   if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
   (void)sprintf( &buf[0], "%s/", dname );
 
-  filelist = dlist_append( filelist, (void *)strdup( (const char *)&buf[0] ) );
+  dlist_head_append( &filelist, (void *)strdup( (const char *)&buf[0] ) );
   free( buf );
 }
 
@@ -1135,7 +1145,7 @@ static void create_file_list( void )
   _list_files( (const char *)srcdir );
   stop_restorelinks_file();
 
-  if( filelist )
+  if( dlist_head_length( &filelist ) )
   {
     FILE *flist = NULL;
     char *tmp   = NULL;
@@ -1199,8 +1209,8 @@ static void create_file_list( void )
 
     free( tmp );
 
-    filelist = dlist_sort( filelist, _compare_fnames );
-    dlist_foreach( filelist, _print_filelist_entry, flist );
+    dlist_head_sort( &filelist, _compare_fnames );
+    dlist_head_foreach( &filelist, _print_filelist_entry, flist );
 
     fflush( flist );
     fclose( flist );
@@ -1213,7 +1223,7 @@ static void create_file_list( void )
 
 static void free_file_list( void )
 {
-  if( filelist ) { dlist_free( filelist, _free_filelist_entry ); filelist = NULL; }
+  dlist_head_free( &filelist, _free_filelist_entry );
 }
 /*
   End of file list functions.
@@ -1528,7 +1538,7 @@ static void create_package( void )
   pid_t p = (pid_t) -1;
   int   rc, len = 0;
 
-  char *tmp = NULL, *cwd = NULL, *dst = NULL, *cmd = NULL;
+  char *tmp = NULL, *cwd = NULL, *dst = NULL, *cmd = NULL, *srv = NULL;
 
 #define tar_suffix ".tar"
 #define sha_suffix ".sha"
@@ -1556,6 +1566,10 @@ static void create_package( void )
   if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
   bzero( (void *)cmd, PATH_MAX );
 
+  srv = (char *)malloc( PATH_MAX );
+  if( !srv ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  bzero( (void *)srv, PATH_MAX );
+
   /* absolute current directory path: */
   if( getcwd( cwd, (size_t)PATH_MAX ) == NULL )
   {
@@ -1607,23 +1621,18 @@ static void create_package( void )
               "sed 's,\\.PKGINFO,,'      | "
               "sed 's,\\.REQUIRES,,'     | "
               "sed 's,\\.RESTORELINKS,,' | "
-              "tar --no-recursion %s %s -T - -cvf %s/%s-%s-%s-%s-%s%s",
-    ACLS, XATTRS, dst, pkgname, pkgver, arch, distroname, distrover, tar_suffix );
+              "tar --no-recursion %s %s -T - %s %s/%s-%s-%s-%s-%s%s",
+    ACLS, XATTRS, ( service_first ) ? "--append -f" : "-cvf",
+    dst, pkgname, pkgver, arch, distroname, distrover, tar_suffix );
   if( len == 0 || len == PATH_MAX - 1 )
   {
     FATAL_ERROR( "Cannot push package files into tarball" );
   }
-  p = sys_exec_command( cmd );
-  rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
-  if( rc != 0 )
-  {
-    FATAL_ERROR( "Cannot push package files into tarball" );
-  }
 
   /**********************************
     push service files into tarball:
    */
-  len = snprintf( (char *)&cmd[0], PATH_MAX,
+  len = snprintf( (char *)&srv[0], PATH_MAX,
     "find ./ -type f \\( -name '.DESCRIPTION' -o "
                         "-name '.FILELIST'    -o "
                         "-name '.INSTALL'     -o "
@@ -1631,17 +1640,35 @@ static void create_package( void )
                         "-name '.REQUIRES'    -o "
                         "-name '.RESTORELINKS' \\) | "
               "sed 's,^\\./,,' | "
-              "tar --no-recursion %s %s -T - --append -f %s/%s-%s-%s-%s-%s%s",
-    ACLS, XATTRS, dst, pkgname, pkgver, arch, distroname, distrover, tar_suffix );
+              "tar --no-recursion %s %s -T - %s %s/%s-%s-%s-%s-%s%s",
+    ACLS, XATTRS, ( service_first ) ? "-cvf" : "--append -f",
+    dst, pkgname, pkgver, arch, distroname, distrover, tar_suffix );
   if( len == 0 || len == PATH_MAX - 1 )
   {
     FATAL_ERROR( "Cannot push service files into tarball" );
   }
-  p = sys_exec_command( cmd );
-  rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
-  if( rc != 0 )
+
+  /*************************************************************
+    By default service files are appended after package files.
+    If service files are placed first, readers of the package
+    uncompress only the beginning of archive to get them:
+   */
   {
-    FATAL_ERROR( "Cannot push service files into tarball" );
+    const char *first  = ( service_first ) ? srv : cmd;
+    const char *second = ( service_first ) ? cmd : srv;
+
+    p = sys_exec_command( (char *)first );
+    rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
+    if( rc != 0 )
+    {
+      FATAL_ERROR( "Cannot push %s files into tarball", ( service_first ) ? "service" : "package" );
+    }
+    p = sys_exec_command( (char *)second );
+    rc = sys_wait_command( p, (char *)NULL, PATH_MAX );
+    if( rc != 0 )
+    {
+      FATAL_ERROR( "Cannot push %s files into tarball", ( service_first ) ? "package" : "service" );
+    }
   }
 
   /**********************************
@@ -1744,6 +1771,7 @@ static void create_package( void )
                       DISTRO_CAPTION,
                         destination, pkgname, pkgver, arch, distroname, distrover, txz_suffix );
 
+  free( srv );
   free( cmd );
   free( dst );
   free( cwd );
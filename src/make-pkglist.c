@@ -20,6 +20,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <sys/sysinfo.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <dirent.h>
@@ -58,6 +59,7 @@
 #include <system.h>
 
 #include <dlist.h>
+#include <tarball.h>
 #include <pkglist.h>
 
 #define PROGRAM_NAME "make-pkglist"
@@ -67,14 +69,15 @@
 
 char *program = PROGRAM_NAME;
 char *srcdir = NULL, *pkglist_fname = NULL,
-     *tmpdir = NULL;
+     *tmpdir = NULL, *cachedir = NULL;
 
 struct pkg *srcpkg = NULL;
 
 int   exit_status = EXIT_SUCCESS; /* errors counter */
 char *selfdir     = NULL;
 
-int __done = 0, __child = 0;
+int __child = 0;
+int jobs = 0; /* number of parallel pkglog processes; zero means ncpus */
 
 enum _output_format {
   OFMT_LIST = 0,
@@ -105,6 +108,17 @@ static void read_exclude_list( const char *optarg );
   End of exclude declarstions.
  ***************************************************************/
 
+/***************************************************************
+  Cache declarations:
+ */
+static int cache_hits = 0; /* PKGLOGs taken from cache */
+
+static void cache_init( void );
+static void free_cache_entries( void );
+/*
+  End of cache declarations.
+ ***************************************************************/
+
 
 void free_resources()
 {
@@ -112,8 +126,10 @@ void free_resources()
   if( srcdir )         { free( srcdir );         srcdir         = NULL; }
   if( srcpkg )         { pkg_free( srcpkg );     srcpkg         = NULL; }
   if( pkglist_fname )  { free( pkglist_fname );  pkglist_fname  = NULL; }
+  if( cachedir )       { free( cachedir );       cachedir       = NULL; }
 
   free_exclude();
+  free_cache_entries();
 
   free_tarballs();
   free_packages();
@@ -147,10 +163,26 @@ void usage()
 
   fprintf( stdout, "  -m,--minimize                 Create .min.json files. Applicable\n" );
   fprintf( stdout, "                                for JSON output format.\n" );
+  fprintf( stdout, "  -g,--graph                    Print Requires Tree as a graph where each\n" );
+  fprintf( stdout, "                                package is present once. Applicable for\n" );
+  fprintf( stdout, "                                JSON output format.\n" );
+  fprintf( stdout, "  -k,--chunks                   Replace Requires Tree by small index and\n" );
+  fprintf( stdout, "                                the directory of per-package JSON files\n" );
+  fprintf( stdout, "                                loaded by HTML viewer on demand. Applicable\n" );
+  fprintf( stdout, "                                for JSON output format.\n" );
+  fprintf( stdout, "  -l,--levels                   Add installation levels and requires of\n" );
+  fprintf( stdout, "                                packages to the LIST output format.\n" );
 
   fprintf( stdout, "  -p,--prioriy=<PRIORITY>       Default install priority: REQ|REC|OPT|SKP.\n" );
   fprintf( stdout, "  -w,--hardware=<HARDWARE>      Optional Hardware Name used\n" );
   fprintf( stdout, "                                for JSON output format.\n" );
+  fprintf( stdout, "  -j,--jobs=<N>                 Number of parallel pkglog processes (default\n" );
+  fprintf( stdout, "                                is the number of CPUs).\n" );
+  fprintf( stdout, "  -c,--cache=<DIR>              Directory to keep PKGLOGs of PACKAGEs between\n" );
+  fprintf( stdout, "                                runs. The PKGLOG is extracted again only if\n" );
+  fprintf( stdout, "                                size or mtime of the PACKAGE is changed.\n" );
+  fprintf( stdout, "                                PKGLOGs of removed PACKAGEs are removed from\n" );
+  fprintf( stdout, "                                the cache if DIR is empty at the first run.\n" );
   fprintf( stdout, "\n" );
   fprintf( stdout, "Parameter:\n" );
   fprintf( stdout, "  <pkglist>                     Output PKGLIST file name or a target\n"  );
@@ -389,48 +421,6 @@ void sigint( int signum )
   free_resources();
 }
 
-void sigchld( int signum )
-{
-  pid_t  pid = 0;
-  int    status;
-
-  (void)signum;
-
-  while( (pid = waitpid( -1, &status, WNOHANG )) > 0 )
-  {
-    ; /* One of children with 'pid' is terminated */
-
-    if( WIFEXITED( status ) )
-    {
-      if( (int) WEXITSTATUS (status) > 0 )
-      {
-        ++exit_status; /* printf( "Child %d returned non zero status: %d\n", pid, (int)WEXITSTATUS (status) ); */
-      }
-      else
-      {
-        ; /* printf( "Child %d terminated with status: %d\n", pid, (int)WEXITSTATUS (status) ); */
-      }
-    }
-    else if( WIFSIGNALED( status ) )
-    {
-      ++exit_status; /* printf( "Child %d terminated on signal: %d\n", pid,  WTERMSIG( status ) ); */
-    }
-    else
-    {
-      ++exit_status; /* printf( "Child %d terminated on unknown reason\n", pid ); */
-    }
-
-  }
-
-  if( pid == -1 && errno == ECHILD )
-  {
-    /* No child processes: */
-    __done = 1;
-  }
-  return;
-}
-
-
 static void set_signal_handlers()
 {
   struct sigaction  sa;
@@ -446,31 +436,23 @@ static void set_signal_handlers()
   sigaction( SIGTERM, &sa, NULL );
   sigaction( SIGINT, &sa,  NULL );
 
-  /* System V fork+wait does not work if SIGCHLD is ignored */
-  memset( &sa, 0, sizeof( sa ) );
-  sa.sa_handler = sigchld;         /* CHLD */
-  sa.sa_flags = SA_RESTART;
-  sigemptyset( &set );
-  sigaddset( &set, SIGCHLD );
-  sa.sa_mask = set;
-  sigaction( SIGCHLD, &sa, NULL );
-
   memset( &sa, 0, sizeof( sa ) );  /* ignore SIGPIPE */
   sa.sa_handler = SIG_IGN;
   sa.sa_flags = 0;
   sigaction( SIGPIPE, &sa, NULL );
+
+  /* System V fork+wait does not work if SIGCHLD is ignored */
+  signal( SIGCHLD, SIG_DFL );
 }
 
 
 static enum _input_type check_input_file( char *uncompress, const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   if( uncompress )
   {
     *uncompress = '\0';
@@ -481,8 +463,6 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -501,65 +481,37 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     close( fd ); return IFMT_LOG;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    if( uncompress ) { *uncompress = 'x'; }
-    close( fd ); return IFMT_PKG;
-  }
-
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    if( uncompress ) { *uncompress = 'j'; }
-    close( fd ); return IFMT_PKG;
-  }
+  close( fd );
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
-  {
-    if( uncompress ) { *uncompress = 'J'; }
-    close( fd ); return IFMT_PKG;
-  }
+  /* GZ, BZ2, XZ or TAR */
+  if( (compression = tarball_compression( fname )) == TARBALL_UNKNOWN ) return IFMT_UNKNOWN;
 
-  if( pkglog_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return IFMT_PKG;
-    }
-  }
+  if( uncompress ) { *uncompress = tarball_tar_option( compression ); }
 
-  close( fd ); return IFMT_UNKNOWN;
+  return IFMT_PKG;
 }
 
 
 void get_args( int argc, char *argv[] )
 {
-  const char* short_options = "hvme:s:o:i:p:w:";
+  const char* short_options = "hvmgkle:s:o:i:p:w:j:c:";
 
   const struct option long_options[] =
   {
     { "help",        no_argument,       NULL, 'h' },
     { "version",     no_argument,       NULL, 'v' },
     { "minimize",    no_argument,       NULL, 'm' },
+    { "graph",       no_argument,       NULL, 'g' },
+    { "chunks",      no_argument,       NULL, 'k' },
+    { "levels",      no_argument,       NULL, 'l' },
     { "exclude",     required_argument, NULL, 'e' },
     { "source",      required_argument, NULL, 's' },
     { "oformat",     required_argument, NULL, 'o' },
     { "iformat",     required_argument, NULL, 'i' },
     { "priority",    required_argument, NULL, 'p' },
     { "hardware",    required_argument, NULL, 'w' },
+    { "jobs",        required_argument, NULL, 'j' },
+    { "cache",       required_argument, NULL, 'c' },
     { NULL,          0,                 NULL,  0  }
   };
 
@@ -585,6 +537,38 @@ void get_args( int argc, char *argv[] )
         minimize = 1;
         break;
       }
+      case 'g':
+      {
+        graph = 1;
+        break;
+      }
+      case 'k':
+      {
+        chunks = 1;
+        break;
+      }
+      case 'l':
+      {
+        levels = 1;
+        break;
+      }
+      case 'j':
+      {
+        char *end = NULL;
+
+        if( optarg != NULL )
+        {
+          jobs = (int)strtol( (const char *)optarg, &end, 10 );
+          if( *end != '\0' || jobs < 1 )
+          {
+            FATAL_ERROR( "Invalid --jobs '%s' value", optarg );
+          }
+        }
+        else
+          /* option is present but without value */
+          usage();
+        break;
+      }
 
       case 'e':
       {
@@ -660,6 +644,23 @@ void get_args( int argc, char *argv[] )
         }
         break;
       }
+      case 'c':
+      {
+        if( optarg != NULL )
+        {
+          if( _mkdir_p( optarg, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
+          {
+            FATAL_ERROR( "Cannot create '%s' cache directory", optarg );
+          }
+          cachedir = strdup( optarg );
+          remove_trailing_slash( cachedir );
+          cache_init();
+        }
+        else
+          /* option is present but without value */
+          usage();
+        break;
+      }
       case 'w':
       {
         char *hw = (char *)alloca( strlen( optarg ) + 1 );
@@ -853,1452 +854,856 @@ static void read_exclude_list( const char *optarg )
 
 
 /***************************************************************
-  Extract functions:
+  Cache functions:
+  ===============
+    PKGLOGs extracted from tarballs are saved in the cache
+    directory as <cache>/[group/]<tarball>/<PKGLOG> together
+    with the .key file which holds the size and mtime of the
+    tarball. Unchanged tarballs are not read again. Entries of
+    tarballs which are not found by the current run are removed.
+
+    The root of cache is marked by CACHE_MARKER file which is
+    created only in an empty directory. Stale entries are pruned
+    only under the marked root and only directories which hold
+    the .key file are removed; symbolic links are not followed.
  */
-static void _extract_pkglog( const char *group, const char *fname )
-{
-  enum _input_type  type = IFMT_UNKNOWN;
-  char              uncompress = '\0';
-
-  type = check_input_file( &uncompress, fname );
-
-  if( type == IFMT_PKG )
-  {
-    int   len = 0;
-    char *tmp= NULL, *cmd = NULL, *tgz = NULL;
-
-    tmp = (char *)malloc( (size_t)PATH_MAX );
-    if( !tmp ) { FATAL_ERROR( "Cannot allocate memory" ); }
-    bzero( (void *)tmp, PATH_MAX );
+#define CACHE_MARKER  ".make-pkglist-cache"
 
-    if( group ) { (void)sprintf( &tmp[0], "%s/%s", tmpdir, group ); }
-    else        { (void)sprintf( &tmp[0], "%s", tmpdir ); }
+static char   **entries = NULL; /* visited cache entries */
+static size_t   nentries = 0, esize = 0;
+static int      cache_marked = 0;
 
-    if( _mkdir_p( tmp, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
-    {
-      ERROR( "Cannot save PKGLOG from '%s' file", basename( (char *)fname ) );
-      free( tmp );
-      return;
-    }
+static int __dir_is_empty( const char *dirpath )
+{
+  DIR           *dir;
+  struct dirent *de;
+  int            empty = 1;
 
-    cmd = (char *)malloc( (size_t)PATH_MAX );
-    if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
-    bzero( (void *)cmd, PATH_MAX );
+  if( (dir = opendir( dirpath )) == NULL ) return 0;
 
-    len = snprintf( &cmd[0], PATH_MAX, "%s/pkglog -d %s %s > /dev/null 2>&1", selfdir, tmp, fname );
-    if( len == 0 || len == PATH_MAX - 1 )
-    {
-      FATAL_ERROR( "Cannot get PKGLOG from %s file", basename( (char *)fname ) );
-    }
-    (void)sys_exec_command( cmd );
-    ++__child;
+  while( (de = readdir( dir )) != NULL )
+  {
+    if( ! strcmp( de->d_name, "." ) || ! strcmp( de->d_name, ".." ) ) continue;
+    empty = 0; break;
+  }
 
-    tgz = (char *)malloc( (size_t)PATH_MAX );
-    if( !tgz ) { FATAL_ERROR( "Cannot allocate memory" ); }
-    bzero( (void *)tgz, PATH_MAX );
-    (void)sprintf( &tgz[0], "%s/%s", group, basename( (char *)fname ) );
-    add_tarball( (char *)&tgz[0] );
+  closedir( dir );
 
-    free( tmp );
-    free( cmd );
-    free( tgz );
-  }
+  return empty;
 }
 
-static void _search_packages( const char *dirpath, const char *grp )
+static void cache_init( void )
 {
-  DIR    *dir;
-  char   *path;
-  size_t  len;
+  char        fname[PATH_MAX];
+  struct stat st;
+  int         fd;
 
-  struct stat    path_sb, entry_sb;
-  struct dirent *entry;
+  (void)snprintf( &fname[0], PATH_MAX, "%s/%s", cachedir, CACHE_MARKER );
 
-  if( stat( dirpath, &path_sb ) == -1 )
+  if( lstat( (const char *)&fname[0], &st ) == 0 )
   {
-    FATAL_ERROR( "%s: Cannot stat Setup Database or destination directory", dirpath );
+    cache_marked = S_ISREG(st.st_mode);
   }
-
-  if( S_ISDIR(path_sb.st_mode) == 0 )
+  else if( __dir_is_empty( (const char *)cachedir ) &&
+           (fd = open( (const char *)&fname[0], O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH )) != -1 )
   {
-    FATAL_ERROR( "%s: Setup Database or destination is not a directory", dirpath );
+    close( fd );
+    cache_marked = 1;
   }
 
-  if( (dir = opendir(dirpath) ) == NULL )
+  if( !cache_marked )
   {
-    FATAL_ERROR( "Canot access %s directory: %s", dirpath, strerror( errno ) );
+    WARNING( "The '%s' directory is not a cache created by %s: stale entries will not be removed", cachedir, program );
   }
+}
 
-  len = strlen( dirpath );
+static void free_cache_entries( void )
+{
+  size_t i;
 
-  while( (entry = readdir( dir )) != NULL)
+  for( i = 0; i < nentries; ++i ) free( entries[i] );
+  if( entries ) free( entries );
+
+  entries = NULL; nentries = esize = 0;
+}
+
+static void cache_visit( const char *entry )
+{
+  if( nentries == esize )
   {
-    /* skip entries '.' and '..' */
-    if( ! strcmp( entry->d_name, "." ) || ! strcmp( entry->d_name, ".." ) ) continue;
+    esize   = ( esize ) ? esize * 2 : 1024;
+    entries = (char **)realloc( (void *)entries, esize * sizeof(char *) );
+    if( !entries ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  }
 
-    /* determinate a full name of an entry */
-    path = alloca( len + strlen( entry->d_name ) + 2 );
+  entries[nentries] = strdup( entry );
+  if( !entries[nentries] ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  ++nentries;
+}
 
-    strcpy( path, dirpath );
-    strcat( path, "/" );
-    strcat( path, entry->d_name );
+static int __compare_entries( const void *a, const void *b )
+{
+  return strcmp( *(char * const *)a, *(char * const *)b );
+}
 
-    if( stat( path, &entry_sb ) == 0 )
-    {
-      if( S_ISREG(entry_sb.st_mode) )
-      {
-        _extract_pkglog( grp, (const char *)path );
-      }
-      if( S_ISDIR(entry_sb.st_mode) && grp == NULL )
-      {
-        _search_packages( (const char *)path, (const char *)entry->d_name );
-      }
-    }
-    /* else { stat() returns error code; errno is set; and we have to continue the loop } */
-  }
+static int __cache_visited( const char *entry )
+{
+  return ( bsearch( (const void *)&entry, (const void *)entries, nentries,
+                    sizeof(char *), __compare_entries ) != NULL );
+}
 
-  closedir( dir );
+/* Tarball entries hold the .key file; other directories are groups: */
+static int __cache_entry( const char *path )
+{
+  char        fname[PATH_MAX];
+  struct stat st;
+
+  (void)snprintf( &fname[0], PATH_MAX, "%s/.key", path );
+
+  return ( lstat( (const char *)&fname[0], &st ) == 0 && S_ISREG(st.st_mode) );
 }
 
-/**************************************************************
-  extract_pkglogs() - returns number of extracted PKGLOGS
-                      or 0 if no packages found in the srcdir.
-                      The exit_status has been set.
+/*
+  Removes the files of cache ENTRY and the ENTRY itself. The entry holds
+  PKGLOGs only: nested directories are kept and symlinks are unlinked
+  without following them.
  */
-int extract_pkglogs( void )
+static void __cache_remove_entry( const char *entry )
 {
-  int ret = 0;
+  DIR           *dir;
+  struct dirent *de;
+  char          *path = NULL;
 
-  __done = 0; __child = 0;
+  if( (dir = opendir( entry )) == NULL ) return;
 
-  _search_packages( (const char *)srcdir, NULL );
+  path = (char *)malloc( (size_t)PATH_MAX );
+  if( !path ) { FATAL_ERROR( "Cannot allocate memory" ); }
 
-  if( __child > 0 )
+  while( (de = readdir( dir )) != NULL )
   {
-    while( !__done ) usleep( 1 );
-    ret = __child;
+    struct stat st;
+
+    if( ! strcmp( de->d_name, "." ) || ! strcmp( de->d_name, ".." ) ) continue;
+
+    (void)snprintf( path, PATH_MAX, "%s/%s", entry, de->d_name );
+
+    if( lstat( (const char *)path, &st ) == -1 || S_ISDIR(st.st_mode) ) continue;
+    (void)unlink( (const char *)path );
   }
 
-  __done = 0; __child = 0;
+  free( path );
+  closedir( dir );
 
-  return ret;
+  (void)rmdir( entry );
 }
-/*
-  End of Extract functions.
- ***************************************************************/
 
-
-/***************************************************************
-  Copy functions:
- */
-static void _copy_pkglog( const char *group, const char *fname )
+static void __cache_prune_dir( const char *dirpath, int group )
 {
-  enum _input_type  type = IFMT_UNKNOWN;
-  char              uncompress = '\0';
+  DIR           *dir;
+  struct dirent *de;
+  char          *path = NULL;
 
-  type = check_input_file( &uncompress, fname );
+  if( (dir = opendir( dirpath )) == NULL ) return;
 
-  if( type == IFMT_LOG )
+  path = (char *)malloc( (size_t)PATH_MAX );
+  if( !path ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  while( (de = readdir( dir )) != NULL )
   {
-    int   len = 0;
-    char *tmp= NULL, *cmd = NULL;
+    struct stat st;
 
-    tmp = (char *)malloc( (size_t)PATH_MAX );
-    if( !tmp ) { FATAL_ERROR( "Cannot allocate memory" ); }
-    bzero( (void *)tmp, PATH_MAX );
+    if( ! strcmp( de->d_name, "." ) || ! strcmp( de->d_name, ".." ) ) continue;
 
-    if( group ) { (void)sprintf( &tmp[0], "%s/%s", tmpdir, group ); }
-    else        { (void)sprintf( &tmp[0], "%s", tmpdir ); }
+    (void)snprintf( path, PATH_MAX, "%s/%s", dirpath, de->d_name );
 
-    if( _mkdir_p( tmp, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
+    if( lstat( (const char *)path, &st ) == -1 || !S_ISDIR(st.st_mode) ) continue;
+    if( __cache_visited( (const char *)path ) ) continue;
+
+    if( __cache_entry( (const char *)path ) )
     {
-      ERROR( "Cannot copy '%s' PKGLOG file", basename( (char *)fname ) );
-      free( tmp );
-      return;
+      __cache_remove_entry( (const char *)path );
     }
-
-    cmd = (char *)malloc( (size_t)PATH_MAX );
-    if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
-    bzero( (void *)cmd, PATH_MAX );
-
-    len = snprintf( &cmd[0], PATH_MAX, "cp %s %s/ > /dev/null 2>&1", fname, tmp );
-    if( len == 0 || len == PATH_MAX - 1 )
+    else if( !group )
     {
-      FATAL_ERROR( "Cannot copy %s PKGLOG file", basename( (char *)fname ) );
+      __cache_prune_dir( (const char *)path, 1 );
+      (void)rmdir( (const char *)path ); /* removed if the group is empty */
     }
-    (void)sys_exec_command( cmd );
-    ++__child;
-
-    free( tmp );
-    free( cmd );
   }
+
+  free( path );
+  closedir( dir );
 }
 
-static void _search_pkglogs( const char *dirpath, const char *grp )
+static void cache_prune( void )
 {
-  DIR    *dir;
-  char   *path;
-  size_t  len;
+  if( !cachedir || !cache_marked ) return;
 
-  struct stat    path_sb, entry_sb;
-  struct dirent *entry;
+  if( nentries )
+    qsort( (void *)entries, nentries, sizeof(char *), __compare_entries );
 
-  if( stat( dirpath, &path_sb ) == -1 )
-  {
-    FATAL_ERROR( "%s: Cannot stat Setup Database or destination directory", dirpath );
-  }
+  __cache_prune_dir( (const char *)cachedir, 0 );
 
-  if( S_ISDIR(path_sb.st_mode) == 0 )
-  {
-    FATAL_ERROR( "%s: Setup Database or destination is not a directory", dirpath );
-  }
+  free_cache_entries();
+}
 
-  if( (dir = opendir(dirpath) ) == NULL )
-  {
-    FATAL_ERROR( "Canot access %s directory: %s", dirpath, strerror( errno ) );
-  }
-
-  len = strlen( dirpath );
-
-  while( (entry = readdir( dir )) != NULL)
-  {
-    /* skip entries '.' and '..' */
-    if( ! strcmp( entry->d_name, "." ) || ! strcmp( entry->d_name, ".." ) ) continue;
-
-    /* determinate a full name of an entry */
-    path = alloca( len + strlen( entry->d_name ) + 2 );
-
-    strcpy( path, dirpath );
-    strcat( path, "/" );
-    strcat( path, entry->d_name );
-
-    if( stat( path, &entry_sb ) == 0 )
-    {
-      if( S_ISREG(entry_sb.st_mode) )
-      {
-        _copy_pkglog( grp, (const char *)path );
-      }
-      if( S_ISDIR(entry_sb.st_mode) && grp == NULL )
-      {
-        _search_pkglogs( (const char *)path, (const char *)entry->d_name );
-      }
-    }
-    /* else { stat() returns error code; errno is set; and we have to continue the loop } */
-  }
 
-  closedir( dir );
+static void __cache_key( char *key, size_t size, const struct stat *st )
+{
+  (void)snprintf( key, size, "%s %lu %ld.%09ld\n", PROGRAM_VERSION,
+                  (unsigned long)st->st_size, (long)st->st_mtim.tv_sec, (long)st->st_mtim.tv_nsec );
 }
 
-/***********************************************************
-  copy_pkglogs() - returns number of copied PKGLOGS
-                   or 0 if no packages found in the srcdir.
-                   The exit_status has been set.
- */
-int copy_pkglogs( void )
+static int __copy_file( const char *src, const char *dst )
 {
-  int ret = 0;
-
-  __done = 0; __child = 0;
-
-  _search_pkglogs( (const char *)srcdir, NULL );
+  char    buf[16384];
+  ssize_t n;
+  int     in, out, ret = 0;
 
-  if( __child > 0 )
+  if( (in = open( src, O_RDONLY )) == -1 ) return -1;
+  if( (out = open( dst, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH )) == -1 )
   {
-    while( !__done ) usleep( 1 );
-    ret = __child;
+    close( in ); return -1;
   }
 
-  __done = 0; __child = 0;
+  while( (n = read( in, (void *)&buf[0], sizeof( buf ) )) > 0 )
+    if( write( out, (const void *)&buf[0], (size_t)n ) != n ) { ret = -1; break; }
+  if( n < 0 ) ret = -1;
+
+  close( in );
+  if( close( out ) == -1 ) ret = -1;
 
   return ret;
 }
-/*
-  Enf of Copy functions.
- ***************************************************************/
 
-
-/***********************************************************
-  Remove leading spaces and take non-space characters only:
-  (Especialy for pkginfo lines)
- */
-static char *skip_spaces( char *s )
+static int cache_valid( const char *entry, const char *key )
 {
-  char *q, *p = (char *)0;
-
-  if( !s || *s == '\0' ) return p;
-
-  p = s;
+  char  fname[PATH_MAX], buf[PATH_MAX];
+  FILE *fp;
+  int   ret = 0;
 
-  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
-  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
+  (void)snprintf( &fname[0], PATH_MAX, "%s/.key", entry );
 
-  if( *p == '\0' ) return (char *)0;
+  if( (fp = fopen( (const char *)&fname[0], "r" )) )
+  {
+    if( fgets( &buf[0], PATH_MAX, fp ) && !strcmp( (const char *)&buf[0], key ) ) ret = 1;
+    fclose( fp );
+  }
 
-  return( strdup( p ) );
+  return ret;
 }
 
-
-/*******************************
-  remove spaces at end of line:
- */
-static void skip_eol_spaces( char *s )
+static void cache_store( const char *entry, const char *key )
 {
-  char *p = (char *)0;
+  char  fname[PATH_MAX], tmp[PATH_MAX];
+  FILE *fp;
 
-  if( !s || *s == '\0' ) return;
+  (void)snprintf( &fname[0], PATH_MAX, "%s/.key", entry );
+  (void)snprintf( &tmp[0], PATH_MAX, "%s/.key.tmp", entry );
 
-  p = s + strlen( s ) - 1;
-  while( isspace( *p ) ) { *p-- = '\0'; }
+  if( (fp = fopen( (const char *)&tmp[0], "w" )) )
+  {
+    (void)fputs( key, fp );
+    if( fclose( fp ) == 0 ) (void)rename( (const char *)&tmp[0], (const char *)&fname[0] );
+  }
 }
 
-static size_t read_usize( char *s )
+/* Copies PKGLOGs of cache ENTRY into DIR; returns the number of copied files: */
+static int cache_load( const char *entry, const char *dir )
 {
-  size_t  size = 0;
-  size_t  mult = 1;
-  double  sz = 0.0;
-
-  char    suffix;
-  char   *q, *p = (char *)0;
-
-  if( !s || *s == '\0' ) return size;
-
-  p = s;
+  DIR           *dp;
+  struct dirent *de;
+  char           src[PATH_MAX], dst[PATH_MAX];
+  int            ret = 0;
 
-  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
-  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
+  if( (dp = opendir( entry )) == NULL ) return -1;
 
-  if( *p == '\0' ) return size;
-
-  --q;
-  suffix = *q;
-  switch( suffix )
-  {
-    /* by default size calculates in KiB - 1024 Bytes (du -s -h .) */
-    case 'G':
-    case 'g':
-      mult = 1024 * 1024;
-      *q = '\0';
-      break;
-    case 'M':
-    case 'm':
-      mult = 1024;
-      *q = '\0';
-      break;
-    case 'K':
-    case 'k':
-      *q = '\0';
-      break;
-    default:
-      break;
-  }
-
-  if( sscanf( p, "%lg", &sz ) != 1 ) return size;
-
-  return (size_t)round( sz * (double)mult );
-}
+  while( (de = readdir( dp )) != NULL )
+  {
+    if( de->d_name[0] == '.' ) continue; /* '.', '..', and '.key' */
 
-static int read_total_files( char *s )
-{
-  int   n = 0;
-  char *q, *p = (char *)0;
+    (void)snprintf( &src[0], PATH_MAX, "%s/%s", entry, de->d_name );
+    (void)snprintf( &dst[0], PATH_MAX, "%s/%s", dir, de->d_name );
 
-  if( !s || *s == '\0' ) return n;
+    if( __copy_file( (const char *)&src[0], (const char *)&dst[0] ) != 0 ) { ret = -1; break; }
+    ++ret;
+  }
 
-  p = s;
+  closedir( dp );
 
-  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
-  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
+  return ret;
+}
+/*
+  End of Cache functions.
+ ***************************************************************/
 
-  if( *p == '\0' ) return n;
 
-  if( sscanf( p, "%u", &n ) != 1 ) return 0;
+/***************************************************************
+  Worker POOL functions:
+  =====================
+    Commands are executed by at most JOBS child processes at
+    once. When all workers are busy the caller is blocked in
+    waitpid(2) until one of them is finished. Failed commands
+    are reported with the name of corresponding package.
+ */
+struct worker
+{
+  pid_t       pid;
+  char       *fname;
+  const char *errmsg;
 
-  return n;
-}
+  char       *entry, *dest, *key; /* cache entry of successful command */
+};
 
+static struct worker *pool = NULL;
+static int            pool_size = 0, pool_running = 0, pool_done = 0;
 
-static struct pkg *input_package( const char *pkginfo_fname )
+static void __pool_wait( void )
 {
-  char *ln      = NULL;
-  char *line    = NULL;
+  pid_t  pid;
+  int    status, i;
 
-  FILE *pkginfo = NULL;
+  while( (pid = waitpid( -1, &status, 0 )) == -1 && errno == EINTR ) ;
 
-  struct pkg *pkg = NULL;
-  char *pkgname = NULL, *pkgver = NULL, *group = NULL;
+  if( pid == -1 ) { pool_running = 0; return; } /* no child processes */
 
-  if( pkginfo_fname != NULL )
+  for( i = 0; i < pool_size; ++i )
   {
-    pkginfo = fopen( (const char *)pkginfo_fname, "r" );
-    if( !pkginfo )
+    struct worker *worker = &pool[i];
+
+    if( worker->pid != pid ) continue;
+
+    if( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 )
     {
-      FATAL_ERROR( "Cannot open %s file", pkginfo_fname );
+      ERROR( "%s: %s", basename( worker->fname ), worker->errmsg );
+      if( worker->entry ) _rm_tmpdir( (const char *)worker->entry );
+    }
+    else if( worker->entry )
+    {
+      cache_store( (const char *)worker->entry, (const char *)worker->key );
+      if( cache_load( (const char *)worker->entry, (const char *)worker->dest ) <= 0 )
+      {
+        ERROR( "Cannot save PKGLOG from '%s' file", basename( worker->fname ) );
+      }
     }
-  }
 
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
-  {
-    FATAL_ERROR( "Cannot allocate memory" );
+    free( worker->fname );
+    if( worker->entry ) free( worker->entry );
+    if( worker->dest )  free( worker->dest );
+    if( worker->key )   free( worker->key );
+    bzero( (void *)worker, sizeof( struct worker ) );
+    --pool_running; ++pool_done;
+    break;
   }
+}
 
-  while( (ln = fgets( line, PATH_MAX, pkginfo )) )
-  {
-    char *match = NULL;
+static struct worker *pool_exec( const char *cmd, const char *fname, const char *errmsg )
+{
+  int i;
 
-    ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-    skip_eol_spaces( ln );     /* remove spaces at end-of-line */
+  if( !pool )
+  {
+    pool_size = ( jobs > 0 ) ? jobs : get_nprocs();
+    if( pool_size < 1 ) pool_size = 1;
 
-    if( (match = strstr( ln, "pkgname" )) && match == ln ) {
-      char *p = index( match, '=' ) + 1;
-      if( p != NULL ) pkgname = skip_spaces( p );
-    }
-    if( (match = strstr( ln, "pkgver" )) && match == ln ) {
-      char *p = index( match, '=' ) + 1;
-      if( p != NULL ) pkgver = skip_spaces( p );
-    }
-    if( (match = strstr( ln, "group" )) && match == ln ) {
-      char *p = index( match, '=' ) + 1;
-      if( p != NULL ) group = skip_spaces( p );
-    }
+    pool = (struct worker *)malloc( (size_t)pool_size * sizeof( struct worker ) );
+    if( !pool ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)pool, (size_t)pool_size * sizeof( struct worker ) );
   }
 
-  free( line );
+  while( pool_running == pool_size ) __pool_wait();
 
-  if( pkgname && pkgver )
+  for( i = 0; i < pool_size; ++i )
   {
-    pkg = pkg_alloc();
-    if( pkg )
+    struct worker *worker = &pool[i];
+    pid_t          pid;
+
+    if( worker->pid ) continue;
+
+    if( (pid = sys_spawn_command( cmd )) == (pid_t) -1 )
     {
-      if( group )
-      {
-        pkg->group = group;
-      }
-      pkg->name    = pkgname;
-      pkg->version = pkgver;
+      /* the command is not started; the worker stays free: */
+      ERROR( "%s: %s: Cannot fork: %s", basename( (char *)fname ), errmsg, strerror( errno ) );
+      return NULL;
     }
 
+    worker->fname  = strdup( fname );
+    if( !worker->fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    worker->errmsg = errmsg;
+    worker->pid    = pid;
+    ++pool_running;
+    return worker;
   }
-  else
-  {
-    if( group )      free( group );
-    if( pkgname )    free( pkgname );
-    if( pkgver )     free( pkgver );
-
-    FATAL_ERROR( "Invalid input .PKGINFO file" );
-  }
-
-  fclose( pkginfo );
-
-  return( pkg );
+  return NULL;
 }
 
+/* Waits for all workers; returns the number of executed commands: */
+static int pool_wait_all( void )
+{
+  int ret;
 
+  while( pool_running ) __pool_wait();
 
-static void get_short_description( char *buf, const char *line )
-{
-  char *s, *p, *q;
+  if( pool ) { free( pool ); pool = NULL; pool_size = 0; }
 
-  if( buf ) { buf[0] = '\0'; s = buf; }
-  if( !line || line[0] == '\0' ) return;
+  ret = pool_done; pool_done = 0;
 
-  p = index( line, '(' );
-  q = index( line, ')' );
-  if( p && q && q > p )
-  {
-    ++p;
-    while( *p && p < q )
-    {
-      *s = *p;
-      ++p; ++s;
-    }
-    *s = '\0';
-  }
-  else
-  {
-    /*
-      If short description declaration is incorrect at first line
-      of description; then we take whole first line of description:
-     */
-    p = index( line, ':' ); ++p;
-    while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; }
-    strcpy( buf, p );
-  }
+  return ret;
 }
+/*
+  End of Worker POOL functions.
+ ***************************************************************/
 
 
-static int get_references_section( int *start, int *stop, unsigned int *cnt, FILE *log )
+/***************************************************************
+  Extract functions:
+ */
+static void _extract_pkglog( const char *group, const char *fname )
 {
-  int ret = -1, found = 0;
+  enum _input_type  type = IFMT_UNKNOWN;
+  char              uncompress = '\0';
 
-  if( !start || !stop || !cnt ) return ret;
+  type = check_input_file( &uncompress, fname );
 
-  if( log != NULL )
+  if( type == IFMT_PKG )
   {
-    char *ln   = NULL;
-    char *line = NULL;
+    int   len = 0;
+    char *tmp= NULL, *cmd = NULL, *tgz = NULL;
 
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
+    tmp = (char *)malloc( (size_t)PATH_MAX );
+    if( !tmp ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)tmp, PATH_MAX );
+
+    if( group ) { (void)sprintf( &tmp[0], "%s/%s", tmpdir, group ); }
+    else        { (void)sprintf( &tmp[0], "%s", tmpdir ); }
+
+    if( _mkdir_p( tmp, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
     {
-      FATAL_ERROR( "Cannot allocate memory" );
+      ERROR( "Cannot save PKGLOG from '%s' file", basename( (char *)fname ) );
+      free( tmp );
+      return;
     }
 
-    ++ret;
-    *start = 0; *stop = 0;
+    cmd = (char *)malloc( (size_t)PATH_MAX );
+    if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)cmd, PATH_MAX );
 
-    while( (ln = fgets( line, PATH_MAX, log )) )
+    if( cachedir )
     {
-      char *match = NULL;
+      struct stat st;
+      char *key = NULL, *entry = NULL;
 
-      if( (match = strstr( ln, "REFERENCE COUNTER:" )) && match == ln ) /* at start of line only */
+      key = (char *)malloc( (size_t)PATH_MAX );
+      if( !key ) { FATAL_ERROR( "Cannot allocate memory" ); }
+      bzero( (void *)key, PATH_MAX );
+
+      entry = (char *)malloc( (size_t)PATH_MAX );
+      if( !entry ) { FATAL_ERROR( "Cannot allocate memory" ); }
+      bzero( (void *)entry, PATH_MAX );
+
+      (void)strcpy( cmd, fname );
+      if( group ) { (void)sprintf( &entry[0], "%s/%s/%s", cachedir, group, basename( cmd ) ); }
+      else        { (void)sprintf( &entry[0], "%s/%s", cachedir, basename( cmd ) ); }
+
+      if( stat( fname, &st ) == 0 )
+        __cache_key( key, PATH_MAX, (const struct stat *)&st );
+
+      cache_visit( (const char *)entry );
+
+      if( cache_valid( (const char *)entry, (const char *)key ) &&
+          cache_load( (const char *)entry, (const char *)tmp ) > 0 )
+      {
+        /* the tarball is not changed since last run: */
+        free( key ); free( entry );
+        ++cache_hits;
+      }
+      else
       {
-        *start = ret + 1;
-        ++found;
+        struct worker *worker = NULL;
 
-        /* Get reference counter */
+        __cache_remove_entry( (const char *)entry );
+        if( _mkdir_p( entry, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
         {
-          unsigned int count;
-          int          rc;
-
-          ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-          skip_eol_spaces( ln );     /* remove spaces at end-of-line */
+          FATAL_ERROR( "Cannot create cache directory for '%s' file", basename( (char *)fname ) );
+        }
 
-          rc = sscanf( ln, "REFERENCE COUNTER: %u", &count );
-          if( rc == 1 && cnt != NULL )
-          {
-            *cnt = count;
-          }
+        len = snprintf( &cmd[0], PATH_MAX, "%s/pkglog -d %s %s > /dev/null 2>&1", selfdir, entry, fname );
+        if( len == 0 || len == PATH_MAX - 1 )
+        {
+          FATAL_ERROR( "Cannot get PKGLOG from %s file", basename( (char *)fname ) );
+        }
+        worker = pool_exec( (const char *)cmd, (const char *)fname, "Cannot get PKGLOG from package" );
+        if( worker )
+        {
+          worker->entry = entry;
+          worker->dest  = strdup( (const char *)tmp );
+          worker->key   = key;
+        }
+        else
+        {
+          __cache_remove_entry( (const char *)entry );
+          free( key ); free( entry );
         }
       }
-      if( (match = strstr( ln, "REQUIRES:" )) && match == ln )
+    }
+    else
+    {
+      len = snprintf( &cmd[0], PATH_MAX, "%s/pkglog -d %s %s > /dev/null 2>&1", selfdir, tmp, fname );
+      if( len == 0 || len == PATH_MAX - 1 )
       {
-        *stop = ret + 1;
-        ++found;
+        FATAL_ERROR( "Cannot get PKGLOG from %s file", basename( (char *)fname ) );
       }
-
-      ++ret;
+      (void)pool_exec( (const char *)cmd, (const char *)fname, "Cannot get PKGLOG from package" );
     }
 
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
+    tgz = (char *)malloc( (size_t)PATH_MAX );
+    if( !tgz ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)tgz, PATH_MAX );
+    (void)sprintf( &tgz[0], "%s/%s", group, basename( (char *)fname ) );
+    add_tarball( (char *)&tgz[0] );
 
-    fseek( log, 0, SEEK_SET );
+    free( tmp );
+    free( cmd );
+    free( tgz );
   }
-
-  return( ret );
 }
 
-static int get_requires_section( int *start, int *stop, FILE *log )
+static void _search_packages( const char *dirpath, const char *grp )
 {
-  int ret = -1, found = 0;
+  DIR    *dir;
+  char   *path;
+  size_t  len;
 
-  if( !start || !stop ) return ret;
+  struct stat    path_sb, entry_sb;
+  struct dirent *entry;
 
-  if( log != NULL )
+  if( stat( dirpath, &path_sb ) == -1 )
   {
-    char *ln   = NULL;
-    char *line = NULL;
+    FATAL_ERROR( "%s: Cannot stat Setup Database or destination directory", dirpath );
+  }
 
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
+  if( S_ISDIR(path_sb.st_mode) == 0 )
+  {
+    FATAL_ERROR( "%s: Setup Database or destination is not a directory", dirpath );
+  }
 
-    ++ret;
-    *start = 0; *stop = 0;
+  if( (dir = opendir(dirpath) ) == NULL )
+  {
+    FATAL_ERROR( "Canot access %s directory: %s", dirpath, strerror( errno ) );
+  }
 
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
+  len = strlen( dirpath );
 
-      if( (match = strstr( ln, "REQUIRES:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-      if( (match = strstr( ln, "PACKAGE DESCRIPTION:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-static int get_description_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "PACKAGE DESCRIPTION:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-      if( (match = strstr( ln, "RESTORE LINKS:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-static int get_restore_links_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "RESTORE LINKS:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-      if( (match = strstr( ln, "INSTALL SCRIPT:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-
-static int get_install_script_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "INSTALL SCRIPT:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-      if( (match = strstr( ln, "FILE LIST:" )) && match == ln )
-      {
-        *stop = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 2 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-
-static int get_file_list_section( int *start, int *stop, FILE *log )
-{
-  int ret = -1, found = 0;
-
-  if( !start || !stop ) return ret;
-
-  if( log != NULL )
-  {
-    char *ln   = NULL;
-    char *line = NULL;
-
-    line = (char *)malloc( (size_t)PATH_MAX );
-    if( !line )
-    {
-      FATAL_ERROR( "Cannot allocate memory" );
-    }
-
-    ++ret;
-    *start = 0; *stop = 0;
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      if( (match = strstr( ln, "FILE LIST:" )) && match == ln ) /* at start of line only */
-      {
-        *start = ret + 1;
-        ++found;
-      }
-
-      ++ret;
-    }
-
-    free( line );
-
-    ret = ( found == 1 ) ? 0 : 1; /* 0 - success; 1 - not found. */
-
-    fseek( log, 0, SEEK_SET );
-  }
-
-  return( ret );
-}
-
-
-int read_pkginfo( FILE *log, struct package *package )
-{
-  int ret = -1;
-
-  char *ln   = NULL;
-  char *line = NULL;
-
-  char           *pkgname_pattern = "PACKAGE NAME:",
-                  *pkgver_pattern = "PACKAGE VERSION:",
-                    *arch_pattern = "ARCH:",
-              *distroname_pattern = "DISTRO:",
-               *distrover_pattern = "DISTRO VERSION:",
-                   *group_pattern = "GROUP:",
-                     *url_pattern = "URL:",
-                 *license_pattern = "LICENSE:",
-       *uncompressed_size_pattern = "UNCOMPRESSED SIZE:",
-             *total_files_pattern = "TOTAL FILES:";
-
-
-  if( !log || !package ) return ret;
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
-  {
-    FATAL_ERROR( "Cannot allocate memory" );
-  }
-
-  ++ret;
-
-  while( (ln = fgets( line, PATH_MAX, log )) )
+  while( (entry = readdir( dir )) != NULL)
   {
-    char *match = NULL;
+    /* skip entries '.' and '..' */
+    if( ! strcmp( entry->d_name, "." ) || ! strcmp( entry->d_name, ".." ) ) continue;
 
-    ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-    skip_eol_spaces( ln );     /* remove spaces at end-of-line */
+    /* determinate a full name of an entry */
+    path = alloca( len + strlen( entry->d_name ) + 2 );
 
-    if( (match = strstr( ln, pkgname_pattern )) && match == ln ) /* at start of line only */
-    {
-      package->pkginfo->name = skip_spaces( ln + strlen( pkgname_pattern ) );
-    }
-    if( (match = strstr( ln, pkgver_pattern )) && match == ln )
-    {
-      package->pkginfo->version = skip_spaces( ln + strlen( pkgver_pattern ) );
-    }
-    if( (match = strstr( ln, arch_pattern )) && match == ln )
-    {
-      package->pkginfo->arch = skip_spaces( ln + strlen( arch_pattern ) );
-    }
-    if( (match = strstr( ln, distroname_pattern )) && match == ln )
-    {
-      package->pkginfo->distro_name = skip_spaces( ln + strlen( distroname_pattern ) );
-    }
-    if( (match = strstr( ln, distrover_pattern )) && match == ln )
-    {
-      package->pkginfo->distro_version = skip_spaces( ln + strlen( distrover_pattern ) );
-    }
-    if( (match = strstr( ln, group_pattern )) && match == ln )
-    {
-      package->pkginfo->group = skip_spaces( ln + strlen( group_pattern ) );
-    }
-    if( (match = strstr( ln, url_pattern )) && match == ln )
-    {
-      package->pkginfo->url = skip_spaces( ln + strlen( url_pattern ) );
-    }
-    if( (match = strstr( ln, license_pattern )) && match == ln )
-    {
-      package->pkginfo->license = skip_spaces( ln + strlen( license_pattern ) );
-    }
-    if( (match = strstr( ln, uncompressed_size_pattern )) && match == ln )
-    {
-      package->pkginfo->uncompressed_size = read_usize( ln + strlen( uncompressed_size_pattern ) );
-    }
-    if( (match = strstr( ln, total_files_pattern )) && match == ln )
-    {
-      package->pkginfo->total_files = read_total_files( ln + strlen( total_files_pattern ) );
-    }
+    strcpy( path, dirpath );
+    strcat( path, "/" );
+    strcat( path, entry->d_name );
 
-    if( (match = strstr( ln, "PACKAGE DESCRIPTION:" )) && match == ln )
+    if( stat( path, &entry_sb ) == 0 )
     {
-      char *buf = NULL;
-
-      buf = (char *)malloc( (size_t)PATH_MAX );
-      if( !buf )
-      {
-        FATAL_ERROR( "Cannot allocate memory" );
-      }
-
-      /* Get short_description from PACKAGE DESCRIPTION */
-      ln = fgets( line, PATH_MAX, log );
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol */
-
-      bzero( (void *)buf, PATH_MAX );
-      get_short_description( buf, (const char *)line );
-      if( buf[0] != '\0' )
+      if( S_ISREG(entry_sb.st_mode) )
       {
-        package->pkginfo->short_description = strdup( buf );
+        _extract_pkglog( grp, (const char *)path );
       }
-      free( buf );
-    }
-
-  } /* End of while() */
-
-  free( line );
-
-  if( package->pkginfo->name           == NULL ) ++ret;
-  if( package->pkginfo->version        == NULL ) ++ret;
-  if( package->pkginfo->arch           == NULL ) ++ret;
-  if( package->pkginfo->distro_name    == NULL ) ++ret;
-  if( package->pkginfo->distro_version == NULL ) ++ret;
-  /* group can be equal to NULL */
-
-  fseek( log, 0, SEEK_SET );
-
-  return( ret );
-}
-
-
-static unsigned int read_references( FILE *log, int start, unsigned int *cnt, struct package *package )
-{
-  char *ln   = NULL;
-  char *line = NULL;
-  char *p = NULL, *group = NULL, *name = NULL, *version = NULL;
-  int   n = 1;
-
-  unsigned int counter, pkgs = 0;
-
-  struct pkg *pkg = NULL;
-
-  if( !log || !cnt || *cnt == 0 || !package ) return pkgs;
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
-  {
-    FATAL_ERROR( "Cannot allocate memory" );
-  }
-
-  counter = *cnt;
-
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
-
-  n = 0;
-  while( (ln = fgets( line, PATH_MAX, log )) )
-  {
-    ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-    skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-    if( strstr( ln, "REQUIRES:" ) ) break; /* if cnt greater than real number of references */
-
-    if( n < counter )
-    {
-      if( (p = index( (const char *)ln, '=' )) )
+      if( S_ISDIR(entry_sb.st_mode) && grp == NULL )
       {
-        *p = '\0'; version = ++p;
-        if( (p = index( (const char *)ln, '/' )) )
-        {
-          *p = '\0'; name = ++p; group = (char *)&ln[0];
-        }
-        else
-        {
-          name  = (char *)&ln[0]; group = NULL;
-        }
-
-        pkg = pkg_alloc();
-
-        if( group ) pkg->group = strdup( group );
-        pkg->name    = strdup( name );
-        pkg->version = strdup( version );
-
-        add_reference( package, pkg );
-        ++pkgs;
+        _search_packages( (const char *)path, (const char *)entry->d_name );
       }
-      ++n;
     }
-    else
-      break;
+    /* else { stat() returns error code; errno is set; and we have to continue the loop } */
   }
 
-  free( line );
-
-  fseek( log, 0, SEEK_SET );
-
-  *cnt = pkgs;
-
-  return pkgs;
+  closedir( dir );
 }
 
-
-static unsigned int read_requires( FILE *log, int start, int stop, struct package *package )
+/**************************************************************
+  extract_pkglogs() - returns number of extracted PKGLOGS
+                      or 0 if no packages found in the srcdir.
+                      The exit_status has been set.
+ */
+int extract_pkglogs( void )
 {
-  char *ln   = NULL;
-  char *line = NULL;
-  char *p = NULL, *group = NULL, *name = NULL, *version = NULL;
-  int   n = 1;
-
-  unsigned int pkgs = 0;
-
-  struct pkg *pkg = NULL;
-
-  if( !log || !package ) return pkgs;
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
-  {
-    FATAL_ERROR( "Cannot allocate memory" );
-  }
-
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
-
-  if( start && start < stop )
-  {
-    ++n; /* skip section header */
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      if( strstr( ln, "PACKAGE DESCRIPTION:" ) ) break; /* if (stop - start - 1) greater than real number of requiress */
-
-      if( (n > start) && (n < stop) )
-      {
-        if( (p = index( (const char *)ln, '=' )) )
-        {
-          *p = '\0'; version = ++p;
-          if( (p = index( (const char *)ln, '/' )) )
-          {
-            *p = '\0'; name = ++p; group = (char *)&ln[0];
-          }
-          else
-          {
-            name  = (char *)&ln[0]; group = NULL;
-          }
-
-          pkg = pkg_alloc();
-
-          if( group ) pkg->group = strdup( group );
-          pkg->name    = strdup( name );
-          pkg->version = strdup( version );
+  int ret = 0;
 
-          add_required( package, pkg );
-          ++pkgs;
-        }
+  cache_hits = 0;
 
-      }
-      ++n;
-    }
+  _search_packages( (const char *)srcdir, NULL );
 
-  } /* End if( start && start < stop ) */
+  ret = pool_wait_all() + cache_hits;
 
-  free( line );
+  cache_hits = 0;
 
-  fseek( log, 0, SEEK_SET );
+  /* only after all entries of the current run are visited: */
+  if( !exit_status ) cache_prune();
 
-  return pkgs;
+  return ret;
 }
+/*
+  End of Extract functions.
+ ***************************************************************/
 
 
-static unsigned int read_description( FILE *log, int start, int stop, struct package *package )
+/***************************************************************
+  Copy functions:
+ */
+static void _copy_pkglog( const char *group, const char *fname )
 {
-  char *ln      = NULL;
-  char *line    = NULL;
-  char *pattern = NULL;
-  int   n = 1;
-
-  char  *tmp_fname = NULL;
-  FILE  *tmp = NULL;
-
-  unsigned int lines = 0;
-
-  if( !log || !package ) return lines;
-
-  tmp_fname = (char *)malloc( (size_t)PATH_MAX );
-  if( !tmp_fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  bzero( (void *)tmp_fname, PATH_MAX );
-  (void)sprintf( (char *)&tmp_fname[0], "%s/.DESCRIPTION", tmpdir );
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )    { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  pattern = (char *)malloc( (size_t)strlen( package->pkginfo->name ) + 2 );
-  if( !pattern ) { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  (void)sprintf( pattern, "%s:", package->pkginfo->name );
-
+  enum _input_type  type = IFMT_UNKNOWN;
+  char              uncompress = '\0';
 
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
+  type = check_input_file( &uncompress, fname );
 
-  if( start && start < stop )
+  if( type == IFMT_LOG )
   {
-    ++n; /* skip section header */
-
-    tmp = fopen( (const char *)&tmp_fname[0], "w" );
-    if( !tmp )
-    {
-      FATAL_ERROR( "Cannot create temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
-
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      char *match = NULL;
-
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      if( strstr( ln, "RESTORE LINKS:" ) ) break; /* if (stop - start - 1) greater than real number of lines */
-
-      if( (n > start) && (n < stop) )
-      {
-        /*
-          skip non-significant spaces at beginning of line
-          and print lines started with 'pkgname:'
-         */
-        if( (match = strstr( ln, pattern )) && lines < DESCRIPTION_NUMBER_OF_LINES )
-        {
-          int mlen   = strlen( match ), plen = strlen( pattern );
-          int length = ( mlen > plen )  ? (mlen - plen - 1) : 0 ;
-
-          if( length > DESCRIPTION_LENGTH_OF_LINE )
-          {
-            /* WARNING( "Package DESCRIPTION contains lines with length greater than %d characters", DESCRIPTION_LENGTH_OF_LINE ); */
-            match[plen + 1 + DESCRIPTION_LENGTH_OF_LINE] = '\0'; /* truncating description line  */
-            skip_eol_spaces( match );                            /* remove spaces at end-of-line */
-          }
-          fprintf( tmp, "%s\n", match );
-          ++lines;
-        }
-
-      }
-      ++n;
-    }
-
-    if( lines < (unsigned int)DESCRIPTION_NUMBER_OF_LINES )
-    {
-      /* WARNING( "Package DESCRIPTION contains less than %d lines", DESCRIPTION_NUMBER_OF_LINES ); */
-      while( lines < (unsigned int)DESCRIPTION_NUMBER_OF_LINES )
-      {
-        fprintf( tmp, "%s\n", pattern );
-        ++lines;
-      }
-    }
-
-    fflush( tmp );
-    fclose( tmp );
-
-  } /* End if( start && start < stop ) */
-
-  free( pattern );
-  free( line );
-
-  fseek( log, 0, SEEK_SET );
+    int   len = 0;
+    char *tmp= NULL, *cmd = NULL;
 
-  /* read temporary saved description */
-  {
-    struct stat sb;
-    size_t size = 0;
-    int    fd;
+    tmp = (char *)malloc( (size_t)PATH_MAX );
+    if( !tmp ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)tmp, PATH_MAX );
 
-    char  *desc = NULL;
+    if( group ) { (void)sprintf( &tmp[0], "%s/%s", tmpdir, group ); }
+    else        { (void)sprintf( &tmp[0], "%s", tmpdir ); }
 
-    if( stat( tmp_fname, &sb ) == -1 )
+    if( _mkdir_p( tmp, S_IRWXU | S_IRWXG | S_IRWXO ) != 0 )
     {
-      FATAL_ERROR( "Cannot stat temporary %s file", basename( (char *)&tmp_fname[0] ) );
+      ERROR( "Cannot copy '%s' PKGLOG file", basename( (char *)fname ) );
+      free( tmp );
+      return;
     }
-    size = (size_t)sb.st_size;
-
-    if( size )
-    {
-      ssize_t rc = 0;
-
-      desc = (char *)malloc( size + 1 );
-      if( !desc ) { FATAL_ERROR( "Cannot allocate memory" ); }
-      bzero( (void *)desc, size + 1 );
-
-      if( (fd = open( (const char *)&tmp_fname[0], O_RDONLY )) == -1 )
-      {
-        FATAL_ERROR( "Canot access temporary %s file: %s", basename( (char *)&tmp_fname[0] ), strerror( errno ) );
-      }
-
-      rc = read( fd, (void *)desc, size );
-      if( rc != (ssize_t)size ) { ERROR( "The %s file is not fully read", basename( (char *)&tmp_fname[0] ) ); }
 
-      package->description = desc;
+    cmd = (char *)malloc( (size_t)PATH_MAX );
+    if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)cmd, PATH_MAX );
 
-      close( fd );
+    len = snprintf( &cmd[0], PATH_MAX, "cp %s %s/ > /dev/null 2>&1", fname, tmp );
+    if( len == 0 || len == PATH_MAX - 1 )
+    {
+      FATAL_ERROR( "Cannot copy %s PKGLOG file", basename( (char *)fname ) );
     }
+    (void)pool_exec( (const char *)cmd, (const char *)fname, "Cannot copy PKGLOG file" );
 
+    free( tmp );
+    free( cmd );
   }
-
-  (void)unlink( tmp_fname );
-  free( tmp_fname );
-
-  return lines;
 }
 
-
-static unsigned int read_restore_links( FILE *log, int start, int stop, struct package *package )
+static void _search_pkglogs( const char *dirpath, const char *grp )
 {
-  char *ln      = NULL;
-  char *line    = NULL;
-  int   n = 1;
-
-  char  *tmp_fname = NULL;
-  FILE  *tmp = NULL;
-
-  unsigned int lines = 0;
+  DIR    *dir;
+  char   *path;
+  size_t  len;
 
-  if( !log || !package ) return lines;
+  struct stat    path_sb, entry_sb;
+  struct dirent *entry;
 
-  tmp_fname = (char *)malloc( (size_t)PATH_MAX );
-  if( !tmp_fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  if( stat( dirpath, &path_sb ) == -1 )
+  {
+    FATAL_ERROR( "%s: Cannot stat Setup Database or destination directory", dirpath );
+  }
 
-  bzero( (void *)tmp_fname, PATH_MAX );
-  (void)sprintf( (char *)&tmp_fname[0], "%s/.RESTORELINKS", tmpdir );
+  if( S_ISDIR(path_sb.st_mode) == 0 )
+  {
+    FATAL_ERROR( "%s: Setup Database or destination is not a directory", dirpath );
+  }
 
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )    { FATAL_ERROR( "Cannot allocate memory" ); }
+  if( (dir = opendir(dirpath) ) == NULL )
+  {
+    FATAL_ERROR( "Canot access %s directory: %s", dirpath, strerror( errno ) );
+  }
 
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
+  len = strlen( dirpath );
 
-  if( start && start < stop )
+  while( (entry = readdir( dir )) != NULL)
   {
-    ++n; /* skip section header */
-
-    tmp = fopen( (const char *)&tmp_fname[0], "w" );
-    if( !tmp )
-    {
-      FATAL_ERROR( "Cannot create temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
+    /* skip entries '.' and '..' */
+    if( ! strcmp( entry->d_name, "." ) || ! strcmp( entry->d_name, ".." ) ) continue;
 
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
+    /* determinate a full name of an entry */
+    path = alloca( len + strlen( entry->d_name ) + 2 );
 
-      if( strstr( ln, "INSTALL SCRIPT:" ) ) break; /* if (stop - start - 1) greater than real number of lines */
+    strcpy( path, dirpath );
+    strcat( path, "/" );
+    strcat( path, entry->d_name );
 
-      if( (n > start) && (n < stop) )
+    if( stat( path, &entry_sb ) == 0 )
+    {
+      if( S_ISREG(entry_sb.st_mode) )
+      {
+        _copy_pkglog( grp, (const char *)path );
+      }
+      if( S_ISDIR(entry_sb.st_mode) && grp == NULL )
       {
-        fprintf( tmp, "%s\n", ln );
-        ++lines;
+        _search_pkglogs( (const char *)path, (const char *)entry->d_name );
       }
-      ++n;
     }
+    /* else { stat() returns error code; errno is set; and we have to continue the loop } */
+  }
 
-    fflush( tmp );
-    fclose( tmp );
-
-  } /* End if( start && start < stop ) */
-
-  free( line );
+  closedir( dir );
+}
 
-  fseek( log, 0, SEEK_SET );
+/***********************************************************
+  copy_pkglogs() - returns number of copied PKGLOGS
+                   or 0 if no packages found in the srcdir.
+                   The exit_status has been set.
+ */
+int copy_pkglogs( void )
+{
+  _search_pkglogs( (const char *)srcdir, NULL );
 
-  /* read temporary saved description */
-  {
-    struct stat sb;
-    size_t size = 0;
-    int    fd;
+  return pool_wait_all();
+}
+/*
+  Enf of Copy functions.
+ ***************************************************************/
 
-    char  *links = NULL;
 
-    if( stat( tmp_fname, &sb ) == -1 )
-    {
-      FATAL_ERROR( "Cannot stat temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
-    size = (size_t)sb.st_size;
+/***********************************************************
+  Remove leading spaces and take non-space characters only:
+  (Especialy for pkginfo lines)
+ */
+static char *skip_spaces( char *s )
+{
+  char *q, *p = (char *)0;
 
-    if( size )
-    {
-      ssize_t rc = 0;
+  if( !s || *s == '\0' ) return p;
 
-      links = (char *)malloc( size + 1 );
-      if( !links ) { FATAL_ERROR( "Cannot allocate memory" ); }
-      bzero( (void *)links, size + 1 );
+  p = s;
 
-      if( (fd = open( (const char *)&tmp_fname[0], O_RDONLY )) == -1 )
-      {
-        FATAL_ERROR( "Canot access temporary %s file: %s", basename( (char *)&tmp_fname[0] ), strerror( errno ) );
-      }
+  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
+  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
 
-      rc = read( fd, (void *)links, size );
-      if( rc != (ssize_t)size ) { ERROR( "The %s file is not fully read", basename( (char *)&tmp_fname[0] ) ); }
+  if( *p == '\0' ) return (char *)0;
 
-      package->restore_links = links;
+  return( strdup( p ) );
+}
 
-      close( fd );
-    }
 
-  }
+/*******************************
+  remove spaces at end of line:
+ */
+static void skip_eol_spaces( char *s )
+{
+  char *p = (char *)0;
 
-  (void)unlink( tmp_fname );
-  free( tmp_fname );
+  if( !s || *s == '\0' ) return;
 
-  return lines;
+  p = s + strlen( s ) - 1;
+  while( isspace( *p ) ) { *p-- = '\0'; }
 }
 
-
-static unsigned int read_install_script( FILE *log, int start, int stop, struct package *package )
+static struct pkg *input_package( const char *pkginfo_fname )
 {
   char *ln      = NULL;
   char *line    = NULL;
-  int   n = 1;
-
-  char  *tmp_fname = NULL;
-  FILE  *tmp = NULL;
-
-  unsigned int lines = 0;
 
-  if( !log || !package ) return lines;
-
-  tmp_fname = (char *)malloc( (size_t)PATH_MAX );
-  if( !tmp_fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
-
-  bzero( (void *)tmp_fname, PATH_MAX );
-  (void)sprintf( (char *)&tmp_fname[0], "%s/.INSTALL", tmpdir );
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )    { FATAL_ERROR( "Cannot allocate memory" ); }
+  FILE *pkginfo = NULL;
 
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
+  struct pkg *pkg = NULL;
+  char *pkgname = NULL, *pkgver = NULL, *group = NULL;
 
-  if( start && start < stop )
+  if( pkginfo_fname != NULL )
   {
-    ++n; /* skip section header */
-
-    tmp = fopen( (const char *)&tmp_fname[0], "w" );
-    if( !tmp )
+    pkginfo = fopen( (const char *)pkginfo_fname, "r" );
+    if( !pkginfo )
     {
-      FATAL_ERROR( "Cannot create temporary %s file", basename( (char *)&tmp_fname[0] ) );
+      FATAL_ERROR( "Cannot open %s file", pkginfo_fname );
     }
+  }
 
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      if( strstr( ln, "FILE LIST:" ) ) break; /* if (stop - start - 1) greater than real number of lines */
+  line = (char *)malloc( (size_t)PATH_MAX );
+  if( !line )
+  {
+    FATAL_ERROR( "Cannot allocate memory" );
+  }
 
-      if( (n > start) && (n < stop) )
-      {
-        fprintf( tmp, "%s\n", ln );
-        ++lines;
-      }
-      ++n;
-    }
+  while( (ln = fgets( line, PATH_MAX, pkginfo )) )
+  {
+    char *match = NULL;
 
-    fflush( tmp );
-    fclose( tmp );
+    ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
+    skip_eol_spaces( ln );     /* remove spaces at end-of-line */
 
-  } /* End if( start && start < stop ) */
+    if( (match = strstr( ln, "pkgname" )) && match == ln ) {
+      char *p = index( match, '=' ) + 1;
+      if( p != NULL ) pkgname = skip_spaces( p );
+    }
+    if( (match = strstr( ln, "pkgver" )) && match == ln ) {
+      char *p = index( match, '=' ) + 1;
+      if( p != NULL ) pkgver = skip_spaces( p );
+    }
+    if( (match = strstr( ln, "group" )) && match == ln ) {
+      char *p = index( match, '=' ) + 1;
+      if( p != NULL ) group = skip_spaces( p );
+    }
+  }
 
   free( line );
 
-  fseek( log, 0, SEEK_SET );
-
-  /* read temporary saved description */
+  if( pkgname && pkgver )
   {
-    struct stat sb;
-    size_t size = 0;
-    int    fd;
-
-    char  *install = NULL;
-
-    if( stat( tmp_fname, &sb ) == -1 )
-    {
-      FATAL_ERROR( "Cannot stat temporary %s file", basename( (char *)&tmp_fname[0] ) );
-    }
-    size = (size_t)sb.st_size;
-
-    if( size )
+    pkg = pkg_alloc();
+    if( pkg )
     {
-      ssize_t rc = 0;
-
-      install = (char *)malloc( size + 1 );
-      if( !install ) { FATAL_ERROR( "Cannot allocate memory" ); }
-      bzero( (void *)install, size + 1 );
-
-      if( (fd = open( (const char *)&tmp_fname[0], O_RDONLY )) == -1 )
+      if( group )
       {
-        FATAL_ERROR( "Canot access temporary %s file: %s", basename( (char *)&tmp_fname[0] ), strerror( errno ) );
+        pkg->group = pkglist_intern( group );
       }
-
-      rc = read( fd, (void *)install, size );
-      if( rc != (ssize_t)size ) { ERROR( "The %s file is not fully read", basename( (char *)&tmp_fname[0] ) ); }
-
-      package->install_script = install;
-
-      close( fd );
+      pkg->name    = pkglist_intern( pkgname );
+      pkg->version = pkglist_intern( pkgver );
     }
 
   }
 
-  (void)unlink( tmp_fname );
-  free( tmp_fname );
-
-  return lines;
-}
-
-
-static unsigned int read_file_list( FILE *log, int start, struct package *package )
-{
-  char *ln   = NULL;
-  char *line = NULL;
-  int   n = 1;
-
-  unsigned int files = 0;
+  if( group )      free( group );
+  if( pkgname )    free( pkgname );
+  if( pkgver )     free( pkgver );
 
-  if( !log || !package ) return files;
-
-  line = (char *)malloc( (size_t)PATH_MAX );
-  if( !line )
+  if( !pkg )
   {
-    FATAL_ERROR( "Cannot allocate memory" );
+    FATAL_ERROR( "Invalid input .PKGINFO file" );
   }
 
-  while( (ln = fgets( line, PATH_MAX, log )) && (n < start) ) ++n;
-
-  if( start )
-  {
-    while( (ln = fgets( line, PATH_MAX, log )) )
-    {
-      ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
-      skip_eol_spaces( ln );     /* remove spaces at end-of-line */
-
-      add_file( package, (const char *)ln );
-      ++files;
-    }
-
-  } /* End if( start && start < stop ) */
-
-  free( line );
-
-  fseek( log, 0, SEEK_SET );
+  fclose( pkginfo );
 
-  return files;
+  return( pkg );
 }
 
 
+
 static void _read_pkglog( const char *group, const char *fname )
 {
-  FILE *log   = NULL;
   char *bname = NULL;
 
   if( fname != NULL )
-  {
-    log = fopen( (const char *)fname, "r" );
-    if( !log )
-    {
-      FATAL_ERROR( "Cannot open %s file", fname );
-    }
-    bname = (char *)fname + strlen( tmpdir ) + 1;
-  }
-
-  if( log != NULL )
   {
     struct package *package = NULL;
-    int             rc, start, stop;
-    unsigned int    counter;
+    int             rc;
+
+    bname = (char *)fname + strlen( tmpdir ) + 1;
 
     package = package_alloc();
 
-    if( read_pkginfo( log, package ) != 0 )
+    rc = read_pkglog( fname, package );
+    if( rc < 0 )
     {
-      ERROR( "%s: Invalid PKGLOG file", bname );
+      FATAL_ERROR( "Cannot open %s file", fname );
+    }
+    if( rc == PKGLOG_INVALID )
+    {
+      ERROR( "%s: %s", bname, pkglog_strerror( rc ) );
       package_free( package );
-      fclose( log );
       return;
     }
 
-    if( hardware ) package->hardware = strdup( hardware );
+    if( hardware ) package->hardware = pkglist_strdup( hardware );
     if( tarballs ) /* find tarball and allocate package->tarball */
     {
       struct pkginfo *info = package->pkginfo;
@@ -2324,7 +1729,7 @@ static void _read_pkglog( const char *group, const char *fname )
       tgz = find_tarball( (const char *)&buf[0] );
       if( tgz )
       {
-        package->tarball = strdup( tgz );
+        package->tarball = pkglist_strdup( tgz );
 
         bzero( (void *)&buf[0], PATH_MAX );
         (void)sprintf( buf, "%s/%s", srcdir, tgz );
@@ -2348,138 +1753,25 @@ static void _read_pkglog( const char *group, const char *fname )
       WARNING( "%s: Should be moved into '%s' subdir", tgz, package->pkginfo->group );
     }
 
-    /******************
-      read references:
-     */
-    rc = get_references_section( &start, &stop, &counter, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains REFERENCE COUNTER section", bname );
-      package_free( package );
-      fclose( log );
-      return;
-    }
-    if( counter > 0 )
-    {
-      unsigned int pkgs = counter;
-
-      if( read_references( log, start, &counter, package ) != pkgs )
-      {
-        ERROR( "%s: Invalid REFERENCE COUNTER section", bname );
-        package_free( package );
-        fclose( log );
-        return;
-      }
-    }
-
-    /******************
-      read requires:
-     */
-    rc = get_requires_section( &start, &stop, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains REQUIRES section", bname );
-      package_free( package );
-      fclose( log );
-      return;
-    }
-    if( (stop - start) > 1 )
-    {
-      unsigned int pkgs = (unsigned int)(stop - start - 1); /* -1 skips section header */
-
-      if( read_requires( log, start, stop, package ) != pkgs )
-      {
-        ERROR( "%s: Invalid REQUIRES section", bname );
-        package_free( package );
-        fclose( log );
-        return;
-      }
-    }
-
-    /*******************
-      read description:
-     */
-    rc = get_description_section( &start, &stop, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains PACKAGE DESCRIPTION section", bname );
-      package_free( package );
-      fclose( log );
-      return;
-    }
-    if( (stop - start) > 1 )
+    if( rc == PKGLOG_EMPTY_FILE_LIST )
     {
-      if( read_description( log, start, stop, package ) != (unsigned int)DESCRIPTION_NUMBER_OF_LINES )
+      /*
+        Packages that do not contain regular files are ignored.
+        For example, service package base/init-devices-1.2.3-s9xx-glibc-radix-1.1.txz
+       */
+      if( ! DO_NOT_PRINTOUT_INFO )
       {
-        ERROR( "%s: Invalid DESCRIPTION section", bname );
-        package_free( package );
-        fclose( log );
-        return;
+        INFO( "%s: %s", bname, pkglog_strerror( rc ) );
       }
-    }
-
-    /*********************
-      read restore links:
-     */
-    rc = get_restore_links_section( &start, &stop, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains RESTORE LINKS section", bname );
-      package_free( package );
-      fclose( log );
-      return;
-    }
-    if( (stop - start) > 1 )
-    {
-      (void)read_restore_links( log, start, stop, package );
-    }
-
-    /*********************
-      read install script:
-     */
-    rc = get_install_script_section( &start, &stop, log );
-    if( rc != 0 )
-    {
-      ERROR( "%s: PKGLOG doesn't contains INSTALL SCRIPT section", bname );
       package_free( package );
-      fclose( log );
       return;
     }
-    if( (stop - start) > 1 )
-    {
-      (void)read_install_script( log, start, stop, package );
-    }
-
-    /*****************
-      read file_list:
-     */
-    rc = get_file_list_section( &start, &stop, log );
-    if( rc != 0 )
+    if( rc != PKGLOG_OK )
     {
-      ERROR( "%s: PKGLOG doesn't contains FILE LIST section", bname );
+      ERROR( "%s: %s", bname, pkglog_strerror( rc ) );
       package_free( package );
-      fclose( log );
       return;
     }
-    if( start )
-    {
-      unsigned int files = read_file_list( log, start, package );
-      if( files == (unsigned int)0 )
-      {
-        /*
-          Packages that do not contain regular files are ignored.
-          For example, service package base/init-devices-1.2.3-s9xx-glibc-radix-1.1.txz
-         */
-        if( ! DO_NOT_PRINTOUT_INFO )
-        {
-          INFO( "%s: PKGLOG contains empty FILE LIST section", bname );
-        }
-        package_free( package );
-        fclose( log );
-        return;
-      }
-      package->pkginfo->total_files = (int)files;
-    }
 
     /* Skip excluded package: */
     {
@@ -2488,7 +1780,6 @@ static void _read_pkglog( const char *group, const char *fname )
       if( name && !strcmp( name, package->pkginfo->name ) )
       {
         package_free( package );
-        fclose( log );
         return;
       }
     }
@@ -2496,7 +1787,6 @@ static void _read_pkglog( const char *group, const char *fname )
     add_package( package );
 
     ++__child;
-    fclose( log );
   }
 }
 
@@ -26,6 +26,7 @@ extern "C" {
 
 extern char *hardware;
 extern int   minimize;
+extern int   levels;
 
 
 #ifdef __cplusplus
@@ -0,0 +1,1209 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>  /* index(3)    */
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/file.h> /* flock(2)    */
+#include <sys/mman.h> /* mmap(2)     */
+
+#include <msglog.h>
+#include <pkgdb.h>
+#include <pkglog-scan.h>
+
+
+/***************************************************************
+  Scan functions:
+ */
+struct pkgdb_entry
+{
+  char        *pkglog;  /* [group/]fname */
+  struct stat  st;
+};
+
+struct pkgdb_scan
+{
+  struct pkgdb_entry *entries;
+  uint32_t            count, size;
+};
+
+static void __scan_add( struct pkgdb_scan *scan, const char *group, const char *fname, struct stat *st )
+{
+  struct pkgdb_entry *entry = NULL;
+  size_t len = strlen( fname ) + ( (group) ? strlen( group ) + 1 : 0 ) + 1;
+
+  if( scan->count == scan->size )
+  {
+    scan->size    = ( scan->size ) ? scan->size * 2 : 256;
+    scan->entries = (struct pkgdb_entry *)realloc( scan->entries, scan->size * sizeof(struct pkgdb_entry) );
+    if( !scan->entries ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  }
+
+  entry = &scan->entries[scan->count++];
+
+  entry->pkglog = (char *)malloc( len );
+  if( !entry->pkglog ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  if( group ) (void)sprintf( entry->pkglog, "%s/%s", group, fname );
+  else        (void)sprintf( entry->pkglog, "%s", fname );
+
+  entry->st = *st;
+}
+
+static int __scan_dir( struct pkgdb_scan *scan, const char *dirpath, const char *group )
+{
+  DIR           *dir;
+  struct dirent *entry;
+  char          *path = NULL;
+  int            ret = 0;
+
+  if( (dir = opendir( dirpath )) == NULL ) return -1;
+
+  path = (char *)malloc( (size_t)PATH_MAX );
+  if( !path ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  while( (entry = readdir( dir )) != NULL )
+  {
+    struct stat st;
+
+    /* skip entries '.' and '..' */
+    if( ! strcmp( entry->d_name, "." ) || ! strcmp( entry->d_name, ".." ) ) continue;
+
+    (void)snprintf( path, PATH_MAX, "%s/%s", dirpath, entry->d_name );
+
+    if( stat( path, &st ) == 0 )
+    {
+      if( S_ISREG(st.st_mode) )
+      {
+        __scan_add( scan, group, entry->d_name, &st );
+      }
+      if( S_ISDIR(st.st_mode) && group == NULL )
+      {
+        if( __scan_dir( scan, (const char *)path, (const char *)entry->d_name ) != 0 ) { ret = -1; break; }
+      }
+    }
+  }
+
+  free( path );
+  closedir( dir );
+
+  return ret;
+}
+
+static int __compare_entries( const void *a, const void *b )
+{
+  return strcmp( ((const struct pkgdb_entry *)a)->pkglog, ((const struct pkgdb_entry *)b)->pkglog );
+}
+
+static void scan_free( struct pkgdb_scan *scan )
+{
+  uint32_t i;
+
+  for( i = 0; i < scan->count; ++i ) free( scan->entries[i].pkglog );
+  if( scan->entries ) free( scan->entries );
+
+  bzero( (void *)scan, sizeof(struct pkgdb_scan) );
+}
+
+static int scan_pkgs_path( struct pkgdb_scan *scan, const char *pkgs_path )
+{
+  bzero( (void *)scan, sizeof(struct pkgdb_scan) );
+
+  if( __scan_dir( scan, pkgs_path, NULL ) != 0 )
+  {
+    scan_free( scan );
+    return -1;
+  }
+
+  if( scan->count )
+    qsort( (void *)scan->entries, (size_t)scan->count, sizeof(struct pkgdb_entry), __compare_entries );
+
+  return 0;
+}
+
+static int __entry_is_changed( const struct pkgdb_entry *entry, const struct pkgdb_record *record )
+{
+  return ( record->size       != (uint64_t)entry->st.st_size      ||
+           record->mtime      != (int64_t)entry->st.st_mtim.tv_sec ||
+           record->mtime_nsec != (uint32_t)entry->st.st_mtim.tv_nsec );
+}
+/*
+  End of Scan functions.
+ ***************************************************************/
+
+
+/***************************************************************
+  Index MAP functions:
+ */
+static char *__index_fname( const char *pkgs_path )
+{
+  char *fname = NULL;
+  size_t len = strlen( pkgs_path );
+
+  fname = (char *)malloc( len + 5 );
+  if( !fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  (void)strcpy( fname, pkgs_path );
+  while( len > 1 && fname[len - 1] == '/' ) fname[--len] = '\0';
+  (void)strcat( fname, ".idx" );
+
+  return fname;
+}
+
+static struct pkgdb *__map( const char *fname )
+{
+  struct pkgdb *db = NULL;
+  struct stat   st;
+  size_t        size;
+  int           fd;
+
+  const struct pkgdb_header *header = NULL;
+
+  if( (fd = open( fname, O_RDONLY )) == -1 ) return db;
+
+  if( fstat( fd, &st ) == -1 || (size_t)st.st_size < sizeof(struct pkgdb_header) )
+  {
+    close( fd ); return db;
+  }
+
+  db = (struct pkgdb *)malloc( sizeof(struct pkgdb) );
+  if( !db ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  bzero( (void *)db, sizeof(struct pkgdb) );
+
+  db->size = (size_t)st.st_size;
+  db->map  = mmap( NULL, db->size, PROT_READ, MAP_SHARED, fd, 0 );
+  close( fd );
+
+  if( db->map == MAP_FAILED ) { free( db ); return NULL; }
+
+  header = (const struct pkgdb_header *)db->map;
+
+  size = sizeof(struct pkgdb_header) + (size_t)header->count     * sizeof(struct pkgdb_record)
+                                     + (size_t)header->nrequires * sizeof(struct pkgdb_requires)
+                                     + (size_t)header->strsize;
+
+  if( memcmp( header->magic, PKGDB_MAGIC, 8 ) || header->version != PKGDB_VERSION ||
+      size != db->size || !header->strsize )
+  {
+    pkgdb_close( db );
+    return NULL;
+  }
+
+  db->header   = header;
+  db->records  = (const struct pkgdb_record *)((const char *)db->map + sizeof(struct pkgdb_header));
+  db->requires = (const struct pkgdb_requires *)(db->records + header->count);
+  db->strings  = (const char *)(db->requires + header->nrequires);
+
+  return db;
+}
+
+void pkgdb_close( struct pkgdb *db )
+{
+  if( !db ) return;
+
+  if( db->allocated )                         free( db->map );
+  else if( db->map && db->map != MAP_FAILED ) (void)munmap( db->map, db->size );
+  free( db );
+}
+
+const char *pkgdb_string( const struct pkgdb *db, uint32_t offset )
+{
+  if( !offset || offset >= db->header->strsize ) return NULL;
+  return db->strings + offset;
+}
+
+static const struct pkgdb_record *__find_record( const struct pkgdb *db, const char *pkglog )
+{
+  uint32_t lo = 0, hi = db->header->count;
+
+  while( lo < hi )
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    int      cmp = strcmp( pkglog, pkgdb_string( db, db->records[mid].pkglog ) );
+
+    if( !cmp ) return &db->records[mid];
+    if( cmp < 0 ) hi = mid;
+    else          lo = mid + 1;
+  }
+  return NULL;
+}
+
+struct pkgdb *pkgdb_open( const char *pkgs_path )
+{
+  struct pkgdb      *db = NULL;
+  struct pkgdb_scan  scan;
+  char              *fname = NULL;
+  uint32_t           i;
+
+  if( !pkgs_path ) return db;
+
+  fname = __index_fname( pkgs_path );
+  db = __map( fname );
+  free( fname );
+
+  if( !db ) return db;
+
+  if( scan_pkgs_path( &scan, pkgs_path ) != 0 )
+  {
+    pkgdb_close( db );
+    return NULL;
+  }
+
+  /* The index is up to date only if it has the same set of unchanged files: */
+  if( scan.count != db->header->count )
+  {
+    scan_free( &scan );
+    pkgdb_close( db );
+    return NULL;
+  }
+
+  for( i = 0; i < scan.count; ++i )
+  {
+    const char *pkglog = pkgdb_string( db, db->records[i].pkglog );
+
+    if( !pkglog || strcmp( pkglog, scan.entries[i].pkglog ) || __entry_is_changed( &scan.entries[i], &db->records[i] ) )
+    {
+      scan_free( &scan );
+      pkgdb_close( db );
+      return NULL;
+    }
+  }
+
+  scan_free( &scan );
+
+  return db;
+}
+/*
+  End of Index MAP functions.
+ ***************************************************************/
+
+
+/***************************************************************
+  Index BUILD functions:
+ */
+struct pkgdb_builder
+{
+  struct pkgdb_record   *records;
+  uint32_t               count, rsize;
+
+  struct pkgdb_requires *requires;
+  uint32_t               nrequires, qsize;
+
+  char                  *strings;
+  uint32_t               strsize, ssize;
+};
+
+static uint32_t __add_string( struct pkgdb_builder *b, const char *s )
+{
+  uint32_t offset, len;
+
+  if( !s ) return 0;
+
+  len = (uint32_t)strlen( s ) + 1;
+
+  if( b->strsize + len > b->ssize )
+  {
+    while( b->strsize + len > b->ssize ) b->ssize = ( b->ssize ) ? b->ssize * 2 : 65536;
+    b->strings = (char *)realloc( b->strings, (size_t)b->ssize );
+    if( !b->strings ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  }
+
+  offset = b->strsize;
+  memcpy( (void *)(b->strings + offset), (const void *)s, (size_t)len );
+  b->strsize += len;
+
+  return offset;
+}
+
+static struct pkgdb_record *__add_record( struct pkgdb_builder *b )
+{
+  struct pkgdb_record *record = NULL;
+
+  if( b->count == b->rsize )
+  {
+    b->rsize   = ( b->rsize ) ? b->rsize * 2 : 256;
+    b->records = (struct pkgdb_record *)realloc( b->records, b->rsize * sizeof(struct pkgdb_record) );
+    if( !b->records ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  }
+
+  record = &b->records[b->count++];
+  bzero( (void *)record, sizeof(struct pkgdb_record) );
+
+  return record;
+}
+
+static void __add_requires( struct pkgdb_builder *b, struct pkgdb_record *record,
+                            const char *group, const char *name, const char *version )
+{
+  struct pkgdb_requires *requires = NULL;
+
+  if( b->nrequires == b->qsize )
+  {
+    b->qsize    = ( b->qsize ) ? b->qsize * 2 : 1024;
+    b->requires = (struct pkgdb_requires *)realloc( b->requires, b->qsize * sizeof(struct pkgdb_requires) );
+    if( !b->requires ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  }
+
+  if( !record->nrequires ) record->requires = b->nrequires;
+
+  requires = &b->requires[b->nrequires++];
+
+  requires->group   = __add_string( b, group );
+  requires->name    = __add_string( b, name );
+  requires->version = __add_string( b, version );
+
+  ++record->nrequires;
+}
+
+static void builder_free( struct pkgdb_builder *b )
+{
+  if( b->records )  free( b->records );
+  if( b->requires ) free( b->requires );
+  if( b->strings )  free( b->strings );
+
+  bzero( (void *)b, sizeof(struct pkgdb_builder) );
+}
+
+static char *__trim( char *s )
+{
+  char *p = s + strlen( s );
+
+  while( p > s && isspace( *(p - 1) ) ) *(--p) = '\0';
+  while( isspace( *s ) ) ++s;
+
+  return s;
+}
+
+/*
+  Reads the PKGINFO, REQUIRES and the number of files from the PKGLOG.
+  Lines are classified by pkglog-scan.c in the same way as read_pkglog()
+  of the package list does:
+ */
+static void __index_pkglog( struct pkgdb_builder *b, struct pkgdb_record *record, const char *fname )
+{
+  enum _pkglog_section section = SECTION_HEADER, header;
+
+  FILE *log  = NULL;
+  char *line = NULL, *ln = NULL, *value = NULL;
+  int   has_requires = 0, has_files = 0, has_description = 0, invalid = 0;
+
+  char *name = NULL, *version = NULL, *arch = NULL, *distro_name = NULL,
+       *distro_version = NULL, *group = NULL, *description = NULL;
+
+  if( !(log = fopen( fname, "r" )) ) return;
+
+  line = (char *)malloc( (size_t)PATH_MAX );
+  if( !line ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  while( (ln = fgets( line, PATH_MAX, log )) )
+  {
+    ln = __trim( ln );
+
+    if( section == SECTION_FILE_LIST )
+    {
+      if( *ln ) ++record->total_files;
+      continue;
+    }
+
+    if( (header = pkglog_section_header( ln )) != SECTION_HEADER )
+    {
+      section = header;
+      if( section == SECTION_REFERENCES )
+        record->references = (uint32_t)strtoul( ln + strlen( "REFERENCE COUNTER:" ), NULL, 10 );
+      else if( section == SECTION_REQUIRES )
+        has_requires = 1;
+      else if( section == SECTION_FILE_LIST )
+        has_files = 1;
+      continue;
+    }
+
+    switch( section )
+    {
+      case SECTION_HEADER:
+        switch( pkglog_header_field( ln, &value ) )
+        {
+          case FIELD_NAME:           if( !name )           name           = strdup( __trim( value ) ); break;
+          case FIELD_VERSION:        if( !version )        version        = strdup( __trim( value ) ); break;
+          case FIELD_ARCH:           if( !arch )           arch           = strdup( __trim( value ) ); break;
+          case FIELD_DISTRO_VERSION: if( !distro_version ) distro_version = strdup( __trim( value ) ); break;
+          case FIELD_DISTRO_NAME:    if( !distro_name )    distro_name    = strdup( __trim( value ) ); break;
+          case FIELD_GROUP:
+            value = __trim( value );
+            if( !group && *value ) group = strdup( value );
+            break;
+          default:
+            break;
+        }
+        break;
+
+      case SECTION_REQUIRES:
+        if( (value = index( ln, '=' )) )
+        {
+          char *p = NULL;
+
+          *value++ = '\0';
+          if( (p = index( ln, '/' )) ) { *p++ = '\0'; __add_requires( b, record, ln, p, value );   }
+          else                         {              __add_requires( b, record, NULL, ln, value ); }
+        }
+        else if( *ln ) invalid = 1;
+        break;
+
+      case SECTION_DESCRIPTION:
+        if( !has_description && *ln )
+        {
+          description = (char *)malloc( strlen( ln ) + 1 );
+          if( !description ) { FATAL_ERROR( "Cannot allocate memory" ); }
+          pkglog_short_description( description, (const char *)ln );
+          has_description = 1;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  free( line );
+  fclose( log );
+
+  /* only valid PKGLOGs are indexed as packages: */
+  if( name && version && has_requires && has_files && !invalid )
+  {
+    record->name              = __add_string( b, name );
+    record->version           = __add_string( b, version );
+    record->arch              = __add_string( b, arch );
+    record->distro_name       = __add_string( b, distro_name );
+    record->distro_version    = __add_string( b, distro_version );
+    record->group             = __add_string( b, group );
+    record->short_description = __add_string( b, description );
+  }
+
+  if( name )           free( name );
+  if( version )        free( version );
+  if( arch )           free( arch );
+  if( distro_name )    free( distro_name );
+  if( distro_version ) free( distro_version );
+  if( group )          free( group );
+  if( description )    free( description );
+}
+
+static void copy_record( struct pkgdb_builder *b, struct pkgdb_record *record,
+                         const struct pkgdb *db, const struct pkgdb_record *old )
+{
+  uint32_t i;
+
+  record->name              = __add_string( b, pkgdb_string( db, old->name ) );
+  record->version           = __add_string( b, pkgdb_string( db, old->version ) );
+  record->arch              = __add_string( b, pkgdb_string( db, old->arch ) );
+  record->distro_name       = __add_string( b, pkgdb_string( db, old->distro_name ) );
+  record->distro_version    = __add_string( b, pkgdb_string( db, old->distro_version ) );
+  record->group             = __add_string( b, pkgdb_string( db, old->group ) );
+  record->short_description = __add_string( b, pkgdb_string( db, old->short_description ) );
+
+  record->references  = old->references;
+  record->total_files = old->total_files;
+
+  for( i = 0; i < old->nrequires && old->requires + i < db->header->nrequires; ++i )
+  {
+    const struct pkgdb_requires *requires = &db->requires[old->requires + i];
+
+    __add_requires( b, record, pkgdb_string( db, requires->group ),
+                               pkgdb_string( db, requires->name ),
+                               pkgdb_string( db, requires->version ) );
+  }
+}
+
+static int write_index( struct pkgdb_builder *b, const char *fname )
+{
+  struct pkgdb_header header;
+  FILE  *fp  = NULL;
+  char  *tmp = NULL;
+  int    ret = -1;
+
+  bzero( (void *)&header, sizeof(struct pkgdb_header) );
+  memcpy( (void *)header.magic, PKGDB_MAGIC, 8 );
+  header.version   = PKGDB_VERSION;
+  header.count     = b->count;
+  header.nrequires = b->nrequires;
+  header.strsize   = b->strsize;
+
+  tmp = (char *)malloc( strlen( fname ) + 5 );
+  if( !tmp ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  (void)sprintf( tmp, "%s.tmp", fname );
+
+  if( (fp = fopen( tmp, "w" )) )
+  {
+    if( fwrite( (const void *)&header, sizeof(struct pkgdb_header), 1, fp ) == 1 &&
+        fwrite( (const void *)b->records, sizeof(struct pkgdb_record), (size_t)b->count, fp ) == (size_t)b->count &&
+        fwrite( (const void *)b->requires, sizeof(struct pkgdb_requires), (size_t)b->nrequires, fp ) == (size_t)b->nrequires &&
+        fwrite( (const void *)b->strings, 1, (size_t)b->strsize, fp ) == (size_t)b->strsize &&
+        fflush( fp ) == 0 && fsync( fileno( fp ) ) == 0 )
+    {
+      ret = 0;
+    }
+    if( fclose( fp ) != 0 ) ret = -1;
+
+    if( !ret && rename( tmp, fname ) != 0 ) ret = -1;
+    if( ret ) (void)unlink( tmp );
+  }
+
+  free( tmp );
+
+  return ret;
+}
+
+/* Fills the builder by records of scanned PKGLOGs; unchanged records are copied from DB: */
+static void __build_records( struct pkgdb_builder *b, const struct pkgdb_scan *scan,
+                             const char *pkgs_path, const struct pkgdb *db )
+{
+  char     *path = NULL;
+  uint32_t  i;
+
+  path = (char *)malloc( (size_t)PATH_MAX );
+  if( !path ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( i = 0; i < scan->count; ++i )
+  {
+    const struct pkgdb_entry  *entry  = &scan->entries[i];
+    const struct pkgdb_record *old    = ( db ) ? __find_record( db, entry->pkglog ) : NULL;
+    struct pkgdb_record       *record = __add_record( b );
+
+    record->pkglog     = __add_string( b, entry->pkglog );
+    record->size       = (uint64_t)entry->st.st_size;
+    record->mtime      = (int64_t)entry->st.st_mtim.tv_sec;
+    record->mtime_nsec = (uint32_t)entry->st.st_mtim.tv_nsec;
+
+    if( old && !__entry_is_changed( entry, old ) )
+    {
+      if( old->name ) copy_record( b, record, db, old );
+    }
+    else
+    {
+      (void)snprintf( path, PATH_MAX, "%s/%s", pkgs_path, entry->pkglog );
+      __index_pkglog( b, record, (const char *)path );
+    }
+  }
+
+  free( path );
+}
+
+static int __lock_pkgs_path( const char *pkgs_path )
+{
+  int fd;
+
+  /* The PACKAGES_PATH directory is locked by writers during update: */
+  if( (fd = open( pkgs_path, O_RDONLY | O_DIRECTORY )) == -1 ) return -1;
+  if( flock( fd, LOCK_EX ) == -1 ) { close( fd ); return -1; }
+
+  return fd;
+}
+
+static void __unlock_pkgs_path( int fd )
+{
+  (void)flock( fd, LOCK_UN );
+  close( fd );
+}
+
+int pkgdb_sync( const char *pkgs_path, int create )
+{
+  struct pkgdb_builder  b;
+  struct pkgdb_scan     scan;
+  struct pkgdb         *db = NULL;
+  char                 *fname = NULL;
+  int                   fd, ret = -1;
+
+  if( !pkgs_path ) return ret;
+
+  if( (fd = __lock_pkgs_path( pkgs_path )) == -1 ) return ret;
+
+  fname = __index_fname( pkgs_path );
+  db = __map( fname );
+
+  if( !db && !create )
+  {
+    struct stat st;
+
+    /* there is no index or it is broken: */
+    if( stat( fname, &st ) == 0 ) (void)unlink( fname );
+
+    free( fname );
+    __unlock_pkgs_path( fd );
+    return 0;
+  }
+
+  if( scan_pkgs_path( &scan, pkgs_path ) != 0 )
+  {
+    pkgdb_close( db );
+    free( fname );
+    __unlock_pkgs_path( fd );
+    return ret;
+  }
+
+  bzero( (void *)&b, sizeof(struct pkgdb_builder) );
+  (void)__add_string( &b, "" ); /* zero offset is reserved for NULL */
+
+  __build_records( &b, &scan, pkgs_path, db );
+  pkgdb_close( db );
+
+  ret = write_index( &b, (const char *)fname );
+
+  builder_free( &b );
+  scan_free( &scan );
+  free( fname );
+
+  __unlock_pkgs_path( fd );
+
+  return ret;
+}
+
+static int __compare_names( const void *a, const void *b )
+{
+  return strcmp( *(const char * const *)a, *(const char * const *)b );
+}
+
+int pkgdb_update( const char *pkgs_path, const char * const *pkglogs, uint32_t n, int create )
+{
+  struct pkgdb_builder  b;
+  struct pkgdb         *db = NULL;
+  const char          **names = NULL;
+  char                 *fname = NULL, *path = NULL;
+  uint32_t              i, j;
+  int                   fd, ret = -1;
+
+  if( !pkgs_path ) return ret;
+  if( !n || !pkglogs ) return 0;
+
+  if( (fd = __lock_pkgs_path( pkgs_path )) == -1 ) return ret;
+
+  fname = __index_fname( pkgs_path );
+
+  if( !(db = __map( fname )) )
+  {
+    free( fname );
+    __unlock_pkgs_path( fd );
+
+    /* there is no index yet (or it is broken): */
+    return pkgdb_sync( pkgs_path, create );
+  }
+
+  names = (const char **)malloc( (size_t)n * sizeof(char *) );
+  if( !names ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  memcpy( (void *)names, (const void *)pkglogs, (size_t)n * sizeof(char *) );
+  qsort( (void *)names, (size_t)n, sizeof(char *), __compare_names );
+
+  path = (char *)malloc( (size_t)PATH_MAX );
+  if( !path ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  bzero( (void *)&b, sizeof(struct pkgdb_builder) );
+  (void)__add_string( &b, "" ); /* zero offset is reserved for NULL */
+
+  /*
+    Both the records and the NAMES are sorted by pkglog: records of
+    other PKGLOGs are copied as is, the NAMES are indexed again or
+    dropped if the PKGLOG is removed from the Setup Database:
+   */
+  for( i = 0, j = 0; i < pkgdb_count( db ) || j < n; )
+  {
+    const struct pkgdb_record *old = ( i < pkgdb_count( db ) ) ? &db->records[i] : NULL;
+    const char                *pkglog = ( old ) ? pkgdb_string( db, old->pkglog ) : NULL;
+    struct pkgdb_record       *record = NULL;
+    struct stat                st;
+    int                        cmp;
+
+    if( !pkglog )    cmp = 1;
+    else if( j < n ) cmp = strcmp( pkglog, names[j] );
+    else             cmp = -1;
+
+    if( cmp < 0 )
+    {
+      record = __add_record( &b );
+      record->pkglog     = __add_string( &b, pkglog );
+      record->size       = old->size;
+      record->mtime      = old->mtime;
+      record->mtime_nsec = old->mtime_nsec;
+      if( old->name ) copy_record( &b, record, db, old );
+      ++i;
+      continue;
+    }
+
+    if( !cmp ) ++i;
+
+    /* skip duplicates of the same name: */
+    if( j + 1 < n && !strcmp( names[j], names[j + 1] ) ) { ++j; continue; }
+
+    (void)snprintf( path, PATH_MAX, "%s/%s", pkgs_path, names[j] );
+    if( stat( (const char *)path, &st ) == 0 && S_ISREG(st.st_mode) )
+    {
+      record = __add_record( &b );
+      record->pkglog     = __add_string( &b, names[j] );
+      record->size       = (uint64_t)st.st_size;
+      record->mtime      = (int64_t)st.st_mtim.tv_sec;
+      record->mtime_nsec = (uint32_t)st.st_mtim.tv_nsec;
+      __index_pkglog( &b, record, (const char *)path );
+    }
+    ++j;
+  }
+
+  pkgdb_close( db );
+
+  ret = write_index( &b, (const char *)fname );
+
+  builder_free( &b );
+  free( names );
+  free( path );
+  free( fname );
+
+  __unlock_pkgs_path( fd );
+
+  return ret;
+}
+
+/*
+  Reads the Setup Database into memory without writing the index. The
+  records of unchanged PKGLOGs are taken from the out of date index;
+  other PKGLOGs are read again:
+ */
+static struct pkgdb *__load( const char *pkgs_path )
+{
+  struct pkgdb_builder  b;
+  struct pkgdb_scan     scan;
+  struct pkgdb_header  *header = NULL;
+  struct pkgdb         *db = NULL, *old = NULL;
+  char                 *fname = NULL, *p = NULL;
+
+  if( (db = pkgdb_open( pkgs_path )) ) return db;
+
+  if( scan_pkgs_path( &scan, pkgs_path ) != 0 ) return db;
+
+  fname = __index_fname( pkgs_path );
+  old = __map( fname );
+  free( fname );
+
+  bzero( (void *)&b, sizeof(struct pkgdb_builder) );
+  (void)__add_string( &b, "" ); /* zero offset is reserved for NULL */
+
+  __build_records( &b, &scan, pkgs_path, old );
+  pkgdb_close( old );
+  scan_free( &scan );
+
+  db = (struct pkgdb *)malloc( sizeof(struct pkgdb) );
+  if( !db ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  bzero( (void *)db, sizeof(struct pkgdb) );
+
+  /* the same layout as the index file: */
+  db->size = sizeof(struct pkgdb_header) + (size_t)b.count     * sizeof(struct pkgdb_record)
+                                         + (size_t)b.nrequires * sizeof(struct pkgdb_requires)
+                                         + (size_t)b.strsize;
+  db->map = malloc( db->size );
+  if( !db->map ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  db->allocated = 1;
+
+  header = (struct pkgdb_header *)db->map;
+  bzero( (void *)header, sizeof(struct pkgdb_header) );
+  memcpy( (void *)header->magic, PKGDB_MAGIC, 8 );
+  header->version   = PKGDB_VERSION;
+  header->count     = b.count;
+  header->nrequires = b.nrequires;
+  header->strsize   = b.strsize;
+
+  p = (char *)db->map + sizeof(struct pkgdb_header);
+  if( b.count )     { memcpy( (void *)p, (const void *)b.records, (size_t)b.count * sizeof(struct pkgdb_record) ); }
+  p += (size_t)b.count * sizeof(struct pkgdb_record);
+  if( b.nrequires ) { memcpy( (void *)p, (const void *)b.requires, (size_t)b.nrequires * sizeof(struct pkgdb_requires) ); }
+  p += (size_t)b.nrequires * sizeof(struct pkgdb_requires);
+  memcpy( (void *)p, (const void *)b.strings, (size_t)b.strsize );
+
+  db->header   = (const struct pkgdb_header *)header;
+  db->records  = (const struct pkgdb_record *)((const char *)db->map + sizeof(struct pkgdb_header));
+  db->requires = (const struct pkgdb_requires *)(db->records + header->count);
+  db->strings  = (const char *)(db->requires + header->nrequires);
+
+  builder_free( &b );
+
+  return db;
+}
+/*
+  End of Index BUILD functions.
+ ***************************************************************/
+
+
+/***************************************************************
+  Installed SET functions:
+ */
+static uint32_t __hash( const char *name )
+{
+  uint32_t h = 5381;
+
+  while( *name ) h = (h << 5) + h + (unsigned char)*name++;
+
+  return h;
+}
+
+static int __group_eq( const char *a, const char *b )
+{
+  if( !a || !b ) return ( a == b );
+  return !strcmp( a, b );
+}
+
+static void __set_grow( struct pkgdb_set *set )
+{
+  struct pkgdb_installed **table = NULL, *p = NULL;
+  uint32_t size = ( set->size ) ? set->size * 2 : 1024;
+
+  table = (struct pkgdb_installed **)calloc( (size_t)size, sizeof(struct pkgdb_installed *) );
+  if( !table ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( p = set->list; p; p = p->link )
+  {
+    uint32_t h = __hash( p->name ) & (size - 1);
+    p->next = table[h]; table[h] = p;
+  }
+
+  if( set->table ) free( set->table );
+  set->table = table;
+  set->size  = size;
+}
+
+static void __set_insert( struct pkgdb_set *set, struct pkgdb_installed *package )
+{
+  uint32_t h;
+
+  package->link = set->list; set->list = package;
+  if( ++set->count > set->size ) { __set_grow( set ); return; }
+
+  h = __hash( package->name ) & (set->size - 1);
+  package->next = set->table[h]; set->table[h] = package;
+}
+
+static struct pkgdb_installed *__set_find( struct pkgdb_set *set, const char *group, const char *name, int any_group )
+{
+  struct pkgdb_installed *p = NULL;
+
+  if( !set->size || !name ) return p;
+
+  for( p = set->table[__hash( name ) & (set->size - 1)]; p; p = p->next )
+  {
+    if( !strcmp( p->name, name ) && (any_group || __group_eq( p->group, group )) ) return p;
+  }
+  return p;
+}
+
+static void __installed_free( struct pkgdb_installed *package )
+{
+  if( package->owned )
+  {
+    uint32_t i;
+
+    for( i = 0; i < package->nrequires * 3; ++i )
+      if( package->requires[i] ) free( package->requires[i] );
+
+    if( package->group )   free( package->group );
+    if( package->name )    free( package->name );
+    if( package->version ) free( package->version );
+  }
+  if( package->requires ) free( package->requires );
+  free( package );
+}
+
+static struct pkgdb_installed *__installed_alloc( uint32_t nrequires )
+{
+  struct pkgdb_installed *package = NULL;
+
+  package = (struct pkgdb_installed *)malloc( sizeof(struct pkgdb_installed) );
+  if( !package ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  bzero( (void *)package, sizeof(struct pkgdb_installed) );
+
+  if( nrequires )
+  {
+    package->requires = (char **)calloc( (size_t)nrequires * 3, sizeof(char *) );
+    if( !package->requires ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    package->nrequires = nrequires;
+  }
+
+  return package;
+}
+
+struct pkgdb_set *pkgdb_set_load( const char *pkgs_path )
+{
+  struct pkgdb_set *set = NULL;
+  struct pkgdb     *db  = NULL;
+  struct stat       st;
+  uint32_t          i, j;
+
+  if( !pkgs_path ) return set;
+
+  /* if there is no Setup Database yet then the set is empty: */
+  if( stat( pkgs_path, &st ) == -1 )
+  {
+    if( errno != ENOENT ) return set;
+  }
+  else if( !(db = __load( pkgs_path )) )
+  {
+    return set;
+  }
+
+  set = (struct pkgdb_set *)malloc( sizeof(struct pkgdb_set) );
+  if( !set ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  bzero( (void *)set, sizeof(struct pkgdb_set) );
+
+  set->db = db;
+
+  for( i = 0; db && i < pkgdb_count( db ); ++i )
+  {
+    const struct pkgdb_record *record  = &db->records[i];
+    struct pkgdb_installed    *package = NULL;
+
+    /* any PKGLOG in the Setup Database means that package is installed: */
+    if( !record->name ) continue;
+
+    package = __installed_alloc( record->nrequires );
+
+    package->group   = (char *)pkgdb_string( db, record->group );
+    package->name    = (char *)pkgdb_string( db, record->name );
+    package->version = (char *)pkgdb_string( db, record->version );
+
+    for( j = 0; j < record->nrequires; ++j )
+    {
+      const struct pkgdb_requires *requires = &db->requires[record->requires + j];
+
+      package->requires[j*3]     = (char *)pkgdb_string( db, requires->group );
+      package->requires[j*3 + 1] = (char *)pkgdb_string( db, requires->name );
+      package->requires[j*3 + 2] = (char *)pkgdb_string( db, requires->version );
+    }
+
+    __set_insert( set, package );
+  }
+
+  return set;
+}
+
+void pkgdb_set_free( struct pkgdb_set *set )
+{
+  struct pkgdb_installed *p = NULL, *next = NULL;
+
+  if( !set ) return;
+
+  for( p = set->list; p; p = next )
+  {
+    next = p->link;
+    __installed_free( p );
+  }
+
+  if( set->table ) free( set->table );
+  pkgdb_close( set->db );
+  free( set );
+}
+
+static char *__strdup( const char *s )
+{
+  char *p = NULL;
+
+  if( !s ) return p;
+  if( !(p = strdup( s )) ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  return p;
+}
+
+void pkgdb_set_add( struct pkgdb_set *set, const char *group, const char *name, const char *version,
+                    const char * const *requires, uint32_t nrequires )
+{
+  struct pkgdb_installed *package = NULL;
+  uint32_t i;
+
+  if( !set || !name ) return;
+
+  package = __installed_alloc( nrequires );
+  package->owned = 1;
+
+  package->group   = __strdup( group );
+  package->name    = __strdup( name );
+  package->version = __strdup( version );
+
+  for( i = 0; i < nrequires * 3; ++i ) package->requires[i] = __strdup( requires[i] );
+
+  __set_insert( set, package );
+}
+
+int pkgdb_set_installed( struct pkgdb_set *set, const char *group, const char *name )
+{
+  return ( pkgdb_set_find( set, group, name ) != NULL );
+}
+
+const struct pkgdb_installed *pkgdb_set_find( struct pkgdb_set *set, const char *group, const char *name )
+{
+  struct pkgdb_installed *p = NULL;
+
+  if( !set || !name ) return p;
+
+  if( (p = __set_find( set, group, name, 0 )) ) return p;
+  return __set_find( set, NULL, name, 1 );
+}
+
+int pkgdb_check_requires( struct pkgdb_set *set, const char *group, const char *name,
+                          const char * const *requires, uint32_t nrequires,
+                          pkgdb_missing_func missing, void *user_data )
+{
+  const char * const **stack = NULL, * const **reported = NULL;
+  uint32_t            *counts = NULL;
+  uint32_t             sp = 0, size = 0, nreported = 0, i;
+  int                  ret = 0;
+
+  if( !set || !nrequires ) return ret;
+
+  if( ++set->mark == 0 )
+  {
+    struct pkgdb_installed *p = NULL;
+    for( p = set->list; p; p = p->link ) p->mark = 0;
+    set->mark = 1;
+  }
+
+  /*
+    Depth-first walk over the lists of requires. The stack holds
+    the rest of each list and the number of not visited triples:
+   */
+#define PUSH( list, n )                                                                \
+  do {                                                                                 \
+    if( sp == size )                                                                   \
+    {                                                                                  \
+      size   = ( size ) ? size * 2 : 64;                                               \
+      stack  = (const char * const **)realloc( stack, size * sizeof(*stack) );         \
+      counts = (uint32_t *)realloc( counts, size * sizeof(uint32_t) );                 \
+      if( !stack || !counts ) { FATAL_ERROR( "Cannot allocate memory" ); }             \
+    }                                                                                  \
+    stack[sp] = (list); counts[sp] = (n); ++sp;                                        \
+  } while( 0 )
+
+  PUSH( requires, nrequires );
+
+  while( sp )
+  {
+    const char * const *req = stack[sp - 1];
+    struct pkgdb_installed *p = NULL;
+
+    if( !counts[sp - 1]-- ) { --sp; continue; }
+    stack[sp - 1] += 3;
+
+    /* the package itself: */
+    if( name && !strcmp( req[1], name ) && __group_eq( req[0], group ) ) continue;
+
+    if( (p = __set_find( set, req[0], req[1], 0 )) )
+    {
+      if( p->mark != set->mark )
+      {
+        p->mark = set->mark;
+        if( p->nrequires ) PUSH( (const char * const *)p->requires, p->nrequires );
+      }
+      continue;
+    }
+
+    /* the package can be moved into another group: */
+    if( __set_find( set, NULL, req[1], 1 ) ) continue;
+
+    for( i = 0; i < nreported; ++i )
+    {
+      if( !strcmp( reported[i][1], req[1] ) && __group_eq( reported[i][0], req[0] ) ) break;
+    }
+    if( i < nreported ) continue;
+
+    reported = (const char * const **)realloc( reported, (nreported + 1) * sizeof(*reported) );
+    if( !reported ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    reported[nreported++] = req;
+
+    if( missing ) missing( req[0], req[1], req[2], user_data );
+    ++ret;
+  }
+#undef PUSH
+
+  if( stack )    free( stack );
+  if( counts )   free( counts );
+  if( reported ) free( reported );
+
+  return ret;
+}
+
+int pkgdb_check_pkglog( struct pkgdb_set *set, const char *pkglog_fname,
+                        pkgdb_missing_func missing, void *user_data )
+{
+  struct pkgdb_builder  b;
+  struct pkgdb_record  *record = NULL;
+  const char          **requires = NULL;
+  uint32_t              i;
+  int                   ret = -1;
+
+  if( !set || !pkglog_fname ) return ret;
+
+  bzero( (void *)&b, sizeof(struct pkgdb_builder) );
+  (void)__add_string( &b, "" );
+
+  record = __add_record( &b );
+  __index_pkglog( &b, record, pkglog_fname );
+
+  if( record->name )
+  {
+    if( record->nrequires )
+    {
+      requires = (const char **)malloc( record->nrequires * 3 * sizeof(char *) );
+      if( !requires ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+      for( i = 0; i < record->nrequires; ++i )
+      {
+        const struct pkgdb_requires *req = &b.requires[record->requires + i];
+
+        requires[i*3]     = ( req->group ) ? b.strings + req->group : NULL;
+        requires[i*3 + 1] = b.strings + req->name;
+        requires[i*3 + 2] = ( req->version ) ? b.strings + req->version : NULL;
+      }
+    }
+
+    ret = pkgdb_check_requires( set, ( record->group ) ? b.strings + record->group : NULL,
+                                b.strings + record->name,
+                                (const char * const *)requires, record->nrequires, missing, user_data );
+    if( requires ) free( requires );
+  }
+
+  builder_free( &b );
+
+  return ret;
+}
+
+int pkgdb_requires_status( const char *pkgs_path, const char *pkglog_fname )
+{
+  struct pkgdb_set *set = NULL;
+  int               rc = -1;
+
+  if( (set = pkgdb_set_load( pkgs_path )) )
+  {
+    rc = pkgdb_check_pkglog( set, pkglog_fname, NULL, NULL );
+    pkgdb_set_free( set );
+  }
+
+  return ( rc > 0 ) ? 1 : rc;
+}
+/*
+  End of Installed SET functions.
+ ***************************************************************/
@@ -0,0 +1,218 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#ifndef _PKG_DB_H_
+#define _PKG_DB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+
+/***************************************************************
+  Setup Database INDEX:
+  ====================
+
+    The index of installed packages is saved in the PACKAGES_PATH
+    directory with '.idx' suffix (for example 'var/lib/radix/packages.idx').
+    The file has following layout:
+
+      struct pkgdb_header;
+      struct pkgdb_record   records[count];   - sorted by pkglog
+      struct pkgdb_requires requires[nrequires];
+      char                  strings[strsize]; - '\0' terminated strings
+
+    All strings are offsets in the string table; zero offset means NULL.
+    Each record holds the size and mtime of the PKGLOG file; the index
+    is used only if all PKGLOGs in the Setup Database are unchanged.
+
+    The utilities which change the Setup Database (install-package,
+    remove-package, update-package, chrefs) update the index by
+    pkgdb_update(). Readers never write the index: if it is missing
+    or out of date they read the changed PKGLOGs again.
+ */
+#define PKGDB_MAGIC    "PKGDBIDX"
+#define PKGDB_VERSION  1
+
+struct pkgdb_header
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t count;       /* number of records          */
+  uint32_t nrequires;   /* number of requires entries */
+  uint32_t strsize;     /* size of the string table   */
+};
+
+struct pkgdb_record
+{
+  uint32_t pkglog;      /* [group/]fname relative to PACKAGES_PATH */
+  uint32_t name;        /* zero if the file is not a valid PKGLOG  */
+  uint32_t version;
+  uint32_t arch;
+  uint32_t distro_name;
+  uint32_t distro_version;
+  uint32_t group;
+  uint32_t short_description;
+
+  uint32_t references;  /* REFERENCE COUNTER */
+  uint32_t total_files; /* number of entries in the FILE LIST */
+
+  uint32_t requires;    /* index of the first requires entry */
+  uint32_t nrequires;
+
+  uint64_t size;        /* PKGLOG file size and mtime */
+  int64_t  mtime;
+  uint32_t mtime_nsec;
+  uint32_t reserved;
+};
+
+struct pkgdb_requires
+{
+  uint32_t group;
+  uint32_t name;
+  uint32_t version;
+};
+
+struct pkgdb
+{
+  void   *map;
+  size_t  size;
+  int     allocated;  /* MAP is allocated in memory (not mapped) */
+
+  const struct pkgdb_header   *header;
+  const struct pkgdb_record   *records;
+  const struct pkgdb_requires *requires;
+  const char                  *strings;
+};
+
+
+/*
+  Maps the index of the Setup Database placed in the PKGS_PATH directory.
+  Returns NULL if the index doesn't exist or is out of date.
+ */
+extern struct pkgdb *pkgdb_open( const char *pkgs_path );
+extern void pkgdb_close( struct pkgdb *db );
+
+#define pkgdb_count( db )  ((db)->header->count)
+extern const char *pkgdb_string( const struct pkgdb *db, uint32_t offset );
+
+/*
+  Updates the index under exclusive lock of the PKGS_PATH directory;
+  only changed PKGLOGs are read. The new index is written into the
+  temporary file which then renamed, so readers never see partially
+  written index. If CREATE is zero then only existing index updated.
+  Returns 0 on success.
+ */
+extern int pkgdb_sync( const char *pkgs_path, int create );
+
+/*
+  Updates records of N PKGLOGS ([group/]fname relative to PKGS_PATH)
+  changed by the caller. The records of removed PKGLOGs are dropped,
+  other records are copied from the existing index. If there is no
+  index it is created by full scan when CREATE is not zero. The index
+  is written as in pkgdb_sync(). Returns 0 on success.
+ */
+extern int pkgdb_update( const char *pkgs_path, const char * const *pkglogs, uint32_t n, int create );
+
+
+/***************************************************************
+  Set of installed packages:
+  =========================
+
+    The set is loaded from the index once and then updated in
+    memory as packages are installed, so the requires of many
+    packages can be checked without re-reading Setup Database.
+ */
+struct pkgdb_installed
+{
+  char        *group;
+  char        *name;
+  char        *version;
+
+  char       **requires;  /* group, name, version triples */
+  uint32_t     nrequires;
+
+  uint32_t     mark;
+  int          owned;     /* strings are allocated (not mapped) */
+
+  struct pkgdb_installed *next; /* next package with the same hash */
+  struct pkgdb_installed *link; /* next package in the set         */
+};
+
+struct pkgdb_set
+{
+  struct pkgdb            *db;
+
+  struct pkgdb_installed **table;
+  uint32_t                 size, count;
+
+  uint32_t                 mark;
+  struct pkgdb_installed  *list;
+};
+
+typedef void (*pkgdb_missing_func)( const char *group, const char *name, const char *version, void *user_data );
+
+/*
+  Loads the set of packages installed into PKGS_PATH. The index is
+  read only; if it is missing or out of date the changed PKGLOGs are
+  read again. The set is empty if PKGS_PATH doesn't exist. Returns NULL if the index cannot be used; in this case the
+  caller should check requires as before.
+ */
+extern struct pkgdb_set *pkgdb_set_load( const char *pkgs_path );
+extern void pkgdb_set_free( struct pkgdb_set *set );
+
+/* REQUIRES is the array of NREQUIRES (group, name, version) triples: */
+extern void pkgdb_set_add( struct pkgdb_set *set, const char *group, const char *name, const char *version,
+                           const char * const *requires, uint32_t nrequires );
+
+/* Returns 1 if package NAME is installed into GROUP or into any group: */
+extern int pkgdb_set_installed( struct pkgdb_set *set, const char *group, const char *name );
+
+/* Returns package NAME installed into GROUP or into any group (the last added) or NULL: */
+extern const struct pkgdb_installed *pkgdb_set_find( struct pkgdb_set *set, const char *group, const char *name );
+
+/*
+  Checks all requires of package GROUP/NAME (recursively through the
+  installed packages). A required package is satisfied if it is
+  installed into any group. Calls MISSING (if not NULL) once for each
+  not installed package and returns the number of such packages.
+ */
+extern int pkgdb_check_requires( struct pkgdb_set *set, const char *group, const char *name,
+                                 const char * const *requires, uint32_t nrequires,
+                                 pkgdb_missing_func missing, void *user_data );
+
+/* The same check for package described by PKGLOG file; returns -1 if PKGLOG is invalid: */
+extern int pkgdb_check_pkglog( struct pkgdb_set *set, const char *pkglog_fname,
+                               pkgdb_missing_func missing, void *user_data );
+
+/*
+  Checks the requires of package described by PKGLOG_FNAME against the
+  packages installed into PKGS_PATH as install-package and update-package
+  do. Returns 0 if all required packages are installed, 1 if some are
+  not, or -1 if the set cannot be loaded and the caller should run the
+  check-requires utility.
+ */
+extern int pkgdb_requires_status( const char *pkgs_path, const char *pkglog_fname );
+
+
+#ifdef __cplusplus
+}  /* ... extern "C" */
+#endif
+
+#endif /* _PKG_DB_H_ */
@@ -51,6 +51,7 @@
 
 #include <msglog.h>
 #include <system.h>
+#include <tarball.h>
 
 #define PROGRAM_NAME "pkginfo"
 
@@ -235,12 +236,10 @@ static char uncompress[2] = { 0, 0 };
 static enum _pkglog_type check_pkglog_file( const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   uncompress[0] = '\0';
 
   if( stat( fname, &st ) == -1 )
@@ -248,8 +247,6 @@ static enum _pkglog_type check_pkglog_file( const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -268,47 +265,22 @@ static enum _pkglog_type check_pkglog_file( const char *fname )
     close( fd ); return PKGLOG_TEXT;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    uncompress[0] = 'x';
-    close( fd ); return PKGLOG_GZ;
-  }
+  close( fd );
 
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    uncompress[0] = 'j';
-    close( fd ); return PKGLOG_BZ2;
-  }
+  compression = tarball_compression( fname );
+  uncompress[0] = tarball_tar_option( compression );
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
+  switch( compression )
   {
-    uncompress[0] = 'J';
-    close( fd ); return PKGLOG_XZ;
-  }
-
-  if( pkglog_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return PKGLOG_TAR;
-    }
+    case TARBALL_GZIP:  return PKGLOG_GZ;
+    case TARBALL_BZIP2: return PKGLOG_BZ2;
+    case TARBALL_XZ:    return PKGLOG_XZ;
+    case TARBALL_NONE:  return PKGLOG_TAR;
+    default:
+      break;
   }
 
-  close( fd ); return PKGLOG_UNKNOWN;
+  return PKGLOG_UNKNOWN;
 }
 
 
@@ -1410,157 +1382,141 @@ int main( int argc, char *argv[] )
   else /* TARBALL: */
   {
     pid_t p = (pid_t) -1;
-    int   rc;
+    int   rc, i, count = 0;
 
     int   len = 0;
-    char *cmd = NULL, *errmsg = NULL, *wmsg = NULL;
+    char *cmd = NULL, *wmsg = NULL;
+
+    /******************************************************************
+      All requested service files are extracted by one TAR process.
+      The service files are placed at the end of the package tarball
+      and each separate TAR call has to uncompress whole archive:
+     */
+    struct
+    {
+      const char *operation;
+      const char *member;
+      int         requested;
+    } members[] = {
+      { "pkginfo",        ".PKGINFO",      0 },
+      { "requires",       ".REQUIRES",     0 },
+      { "description",    ".DESCRIPTION",  0 },
+      { "restore-links",  ".RESTORELINKS", 0 },
+      { "install-script", ".INSTALL",      0 },
+      { "filelist",       ".FILELIST",     0 }
+    };
+    const int nmembers = (int)(sizeof( members ) / sizeof( members[0] ));
+
+    /* .REFERENCES is not present in package tarball */
 
     cmd = (char *)malloc( (size_t)PATH_MAX );
     if( !cmd )    { FATAL_ERROR( "Cannot allocate memory" ); }
-
-    errmsg = (char *)malloc( (size_t)PATH_MAX );
-    if( !errmsg ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)cmd, PATH_MAX );
 
     wmsg = (char *)malloc( (size_t)PATH_MAX );
     if( !wmsg )   { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)wmsg, PATH_MAX );
 
+    len = snprintf( &cmd[0], PATH_MAX, "tar -C %s -x%sf %s", destination, uncompress, pkglog_fname );
 
-    if( strstr( operation, "pkginfo" ) ) /* strongly required */
+    for( i = 0; i < nmembers; ++i )
     {
-      bzero( (void *)cmd, PATH_MAX );
-      bzero( (void *)errmsg, PATH_MAX );
-      bzero( (void *)wmsg, PATH_MAX );
+      if( strstr( operation, members[i].operation ) )
+      {
+        members[i].requested = 1; ++count;
 
-      (void)sprintf( &errmsg[0], "Cannot get .PKGINFO from %s file", basename( pkglog_fname ) );
+        /* do not take the file left by previous calls for extracted one: */
+        (void)snprintf( &wmsg[0], PATH_MAX, "%s/%s", destination, members[i].member );
+        (void)unlink( (const char *)&wmsg[0] );
 
-      len = snprintf( &cmd[0], PATH_MAX, "tar -C %s -x%sf %s %s > /dev/null 2>&1", destination, uncompress, pkglog_fname, ".PKGINFO" );
-      if( len == 0 || len == PATH_MAX - 1 )
-      {
-        FATAL_ERROR( errmsg );
-      }
-      p = sys_exec_command( cmd );
-      rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
-      if( rc != 0 )
-      {
-        /*****************************************
-          if( rc > 0 ) { return TAR exit status }
-          else         { return EXIT_FAILURE    }
-         */
-        if( rc > 0 ) exit_status = rc - 1; /* ERROR() will add one */
-        ERROR( errmsg );
-        if( fatal_error_hook) fatal_error_hook();
-        exit( exit_status );
+        if( len > 0 && len < PATH_MAX )
+          len += snprintf( &cmd[len], PATH_MAX - len, " %s", members[i].member );
       }
     }
+    if( len > 0 && len < PATH_MAX )
+      len += snprintf( &cmd[len], PATH_MAX - len, " > /dev/null 2>&1" );
 
-    /* .REFERENCES is not present in package tarball */
-
-    if( strstr( operation, "requires" ) ) /* optional; may be warning */
+    if( len <= 0 || len >= PATH_MAX - 1 )
     {
-      bzero( (void *)cmd, PATH_MAX );
-      bzero( (void *)errmsg, PATH_MAX );
-      bzero( (void *)wmsg, PATH_MAX );
-
-      (void)sprintf( &errmsg[0], "Cannot get .REQUIRES from %s file", basename( pkglog_fname ) );
-
-      (void)sprintf( &cmd[0], "tar -C %s -x%sf %s %s > /dev/null 2>&1", destination, uncompress, pkglog_fname, ".REQUIRES" );
-      p = sys_exec_command( cmd );
-      rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
-      if( rc != 0 && DO_NOT_WARN_ABOUT_EMPTY_REQUIRES == 0 )
-      {
-        WARNING( errmsg );
-      }
+      FATAL_ERROR( "Cannot get service files from %s file", basename( pkglog_fname ) );
     }
 
-    if( strstr( operation, "description" ) ) /* optional; always warning */
+    rc = 0;
+    if( count )
     {
-      bzero( (void *)cmd, PATH_MAX );
-      bzero( (void *)wmsg, PATH_MAX );
+      const char *names[sizeof( members ) / sizeof( members[0] ) + 1];
+      const char *service[sizeof( members ) / sizeof( members[0] ) + 1];
+      int         n = 0, missing;
 
-      (void)sprintf( &cmd[0], "tar -C %s -x%sf %s %s > /dev/null 2>&1", destination, uncompress, pkglog_fname, ".DESCRIPTION" );
-      p = sys_exec_command( cmd );
-      rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
-      if( rc != 0 )
+      for( i = 0; i < nmembers; ++i )
       {
-        WARNING( "Cannot get package .DESCRIPTION from %s file", basename( pkglog_fname ) );
+        service[i] = members[i].member;
+        if( members[i].requested ) names[n++] = members[i].member;
       }
-    }
-
-    if( strstr( operation, "restore-links" ) ) /* optional; may be warning */
-    {
-      bzero( (void *)cmd, PATH_MAX );
-      bzero( (void *)errmsg, PATH_MAX );
-      bzero( (void *)wmsg, PATH_MAX );
-
-      (void)sprintf( &errmsg[0], "Cannot get .RESTORELINKS script from %s file", basename( pkglog_fname ) );
-
-      (void)sprintf( &cmd[0], "tar -C %s -x%sf %s %s > /dev/null 2>&1", destination, uncompress, pkglog_fname, ".RESTORELINKS" );
-      p = sys_exec_command( cmd );
-      rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
-      if( rc != 0 && DO_NOT_WARN_ABOUT_EMPTY_RESTORE_LINKS == 0 )
+      names[n] = NULL; service[nmembers] = NULL;
+
+      /*************************************************************
+        The built-in reader stops as soon as all requested files
+        are found or at the end of service files block, so only
+        the beginning of packages with service files placed first
+        is uncompressed:
+       */
+      if( (missing = tarball_extract_members( pkglog_fname, destination, names, service )) >= 0 )
+      {
+        if( missing ) rc = 2; /* as tar(1) does for not found members */
+      }
+      else
       {
-        WARNING( errmsg );
+        bzero( (void *)wmsg, PATH_MAX );
+        p = sys_exec_command( cmd );
+        rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
       }
     }
 
-    if( strstr( operation, "install-script" ) ) /* strongly required */
+    /****************************************************************
+      TAR returns non-zero status if some of optional files are not
+      present in the package, so we check each requested file:
+     */
+    for( i = 0; i < nmembers; ++i )
     {
-      bzero( (void *)cmd, PATH_MAX );
-      bzero( (void *)errmsg, PATH_MAX );
-      bzero( (void *)wmsg, PATH_MAX );
+      struct stat st;
 
-      (void)sprintf( &errmsg[0], "Cannot get .INSTALL script from %s file", basename( pkglog_fname ) );
+      if( !members[i].requested ) continue;
 
-      len = snprintf( &cmd[0], PATH_MAX, "tar -C %s -x%sf %s %s > /dev/null 2>&1", destination, uncompress, pkglog_fname, ".INSTALL" );
-      if( len == 0 || len == PATH_MAX - 1 )
+      (void)snprintf( &cmd[0], PATH_MAX, "%s/%s", destination, members[i].member );
+      if( stat( (const char *)&cmd[0], &st ) == 0 ) continue;
+
+      if( !strcmp( members[i].member, ".REQUIRES" ) ) /* optional; may be warning */
       {
-        FATAL_ERROR( errmsg );
+        if( DO_NOT_WARN_ABOUT_EMPTY_REQUIRES == 0 )
+          WARNING( "Cannot get .REQUIRES from %s file", basename( pkglog_fname ) );
       }
-      p = sys_exec_command( cmd );
-      rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
-      if( rc != 0 )
+      else if( !strcmp( members[i].member, ".DESCRIPTION" ) ) /* optional; always warning */
       {
-        /*****************************************
-          if( rc > 0 ) { return TAR exit status }
-          else         { return EXIT_FAILURE    }
-         */
-        if( rc > 0 ) exit_status = rc - 1; /* ERROR() will add one */
-        ERROR( errmsg );
-        if( fatal_error_hook) fatal_error_hook();
-        exit( exit_status );
+        WARNING( "Cannot get package .DESCRIPTION from %s file", basename( pkglog_fname ) );
       }
-    }
-
-    if( strstr( operation, "filelist" ) ) /* strongly required */
-    {
-      bzero( (void *)cmd, PATH_MAX );
-      bzero( (void *)errmsg, PATH_MAX );
-      bzero( (void *)wmsg, PATH_MAX );
-
-      (void)sprintf( &errmsg[0], "Cannot get .FILELIST from %s file", basename( pkglog_fname ) );
-
-      len = snprintf( &cmd[0], PATH_MAX, "tar -C %s -x%sf %s %s > /dev/null 2>&1", destination, uncompress, pkglog_fname, ".FILELIST" );
-      if( len == 0 || len == PATH_MAX - 1 )
+      else if( !strcmp( members[i].member, ".RESTORELINKS" ) ) /* optional; may be warning */
       {
-        FATAL_ERROR( errmsg );
+        if( DO_NOT_WARN_ABOUT_EMPTY_RESTORE_LINKS == 0 )
+          WARNING( "Cannot get .RESTORELINKS script from %s file", basename( pkglog_fname ) );
       }
-      p = sys_exec_command( cmd );
-      rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
-      if( rc != 0 )
+      else /* .PKGINFO, .INSTALL and .FILELIST are strongly required */
       {
         /*****************************************
           if( rc > 0 ) { return TAR exit status }
           else         { return EXIT_FAILURE    }
          */
         if( rc > 0 ) exit_status = rc - 1; /* ERROR() will add one */
-        ERROR( errmsg );
+        if( !strcmp( members[i].member, ".PKGINFO" ) || !strcmp( members[i].member, ".FILELIST" ) )
+          ERROR( "Cannot get %s from %s file", members[i].member, basename( pkglog_fname ) );
+        else
+          ERROR( "Cannot get %s script from %s file", members[i].member, basename( pkglog_fname ) );
         if( fatal_error_hook) fatal_error_hook();
         exit( exit_status );
       }
     }
 
     if( cmd )    free( cmd );
-    if( errmsg ) free( errmsg );
     if( wmsg )   free( wmsg );
   }
 
@@ -20,31 +20,52 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 #include <limits.h>
 #include <libgen.h>   /* basename(3) */
 #include <unistd.h>
 #include <time.h>
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <strings.h>  /* index(3) */
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 #include <msglog.h>
 
 #include <make-pkglist.h>
 
 #include <cmpvers.h>
+#include <arena.h>
 #include <dlist.h>
-#include <jsmin.h>
+#include <json.h>
 #include <pkglist.h>
+#include <pkglog-scan.h>
+
+#include <defs.h>
 
 
 char *hardware = NULL;
 int   minimize = 0;
+int   levels   = 0;
+int   graph    = 0;
+int   chunks   = 0;
 
-struct dlist *packages = NULL;
+struct dlist_head packages = DLIST_HEAD_INIT;
 struct dlist *tarballs = NULL;
 
+static struct dlist_head tarballs_head = DLIST_HEAD_INIT; /* O(1) add_tarball() */
+
 struct dlist *provides = NULL;
 struct dlist *extern_requires = NULL;
 
+static struct dlist_head provides_head        = DLIST_HEAD_INIT;
+static struct dlist_head extern_requires_head = DLIST_HEAD_INIT;
+
 static struct dlist *tree = NULL;
 
 static char *pkgs_fname = NULL,
@@ -54,6 +75,10 @@ static char *pkgs_fname = NULL,
 static char *pkgs_min_fname = NULL,
             *tree_min_fname = NULL;
 
+static char *index_fname = NULL,
+            *index_min_fname = NULL,
+            *chunks_dname = NULL;
+
 static const char *tarball_suffix = "txz";
 
 /***************************************************************
@@ -69,7 +94,8 @@ static const char *tarball_suffix = "txz";
  */
 void add_tarball( char *tarball )
 {
-  tarballs = dlist_append( tarballs, (void *)strdup( tarball ) );
+  dlist_head_append( &tarballs_head, (void *)strdup( tarball ) );
+  tarballs = dlist_head_first( &tarballs_head );
 }
 
 static void __free_tarball( void *data, void *user_data )
@@ -79,7 +105,7 @@ static void __free_tarball( void *data, void *user_data )
 
 void free_tarballs( void )
 {
-  if( tarballs ) { dlist_free( tarballs, __free_tarball ); tarballs = NULL; }
+  dlist_head_free( &tarballs_head, __free_tarball ); tarballs = NULL;
 }
 
 static int __compare_tarballs( const void *a, const void *b )
@@ -164,174 +190,421 @@ char *strproc( enum _procedure procedure )
 
 
 /***************************************************************
-  PACKAGE functions:
+  Hash INDEX functions:
+  ====================
+
+  NOTE:
+  ----
+    The INDEX is an open-addressing hash table which maps the
+    (group, name) key of the list item to the node of the list.
+    The index doesn't own nodes or data; it have to be updated
+    together with the list on each insert or remove operation.
+
+    When the list contains several items with the same key the
+    index_find() returns the item inserted first, i.e. the same
+    node which returns dlist_find_data() on the append-only list.
+
+    Groups and names of the model are interned strings (see the
+    pkglist_intern() function), so keys are hashed and compared
+    by pointers.
  */
+typedef void (*IDXKEYF)( const void *data, const char **group, const char **name );
 
-struct pkg *pkg_alloc( void )
+struct index_entry
 {
-  struct pkg *pkg = NULL;
+  struct dlist *node;    /* NULL - empty or deleted slot */
+  unsigned int  hash;
+  unsigned int  seq;     /* insertion order              */
+  int           deleted;
+};
 
-  pkg = (struct pkg *)malloc( sizeof( struct pkg ) );
-  if( !pkg ) { FATAL_ERROR( "Cannot allocate memory" ); }
-  bzero( (void *)pkg, sizeof( struct pkg ) );
+struct index
+{
+  struct index_entry *slots;
 
-  return pkg;
+  unsigned int size;     /* always a power of two        */
+  unsigned int used;     /* live and deleted entries     */
+  unsigned int count;    /* live entries                 */
+  unsigned int seq;
+
+  IDXKEYF key;
+};
+
+#define INDEX_MIN_SIZE  64
+
+static unsigned int __index_hash( const char *group, const char *name )
+{
+  uint64_t hash = (uint64_t)(uintptr_t)group * 0x9e3779b97f4a7c15ull + (uint64_t)(uintptr_t)name;
+
+  hash ^= hash >> 33; hash *= 0xff51afd7ed558ccdull; /* MurmurHash3 finalizer */
+  hash ^= hash >> 33; hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+
+  return (unsigned int)hash;
 }
 
-void pkg_free( struct pkg *pkg )
+static int __index_key_equal( const char *g1, const char *n1, const char *g2, const char *n2 )
 {
-  if( pkg )
-  {
-    if( pkg->group )   { free( pkg->group );   pkg->group   = NULL; }
-    if( pkg->name )    { free( pkg->name );    pkg->name    = NULL; }
-    if( pkg->version ) { free( pkg->version ); pkg->version = NULL; }
+  return ( g1 == g2 && n1 == n2 );
+}
 
-    free( pkg );
-  }
+static void index_init( struct index *index, IDXKEYF key )
+{
+  bzero( (void *)index, sizeof( struct index ) );
+  index->key = key;
 }
 
-static void __pkg_free_func( void *data, void *user_data )
+static void index_free( struct index *index )
 {
-  struct pkg *pkg = (struct pkg *)data;
-  if( pkg ) { pkg_free( pkg ); }
+  IDXKEYF key = index->key;
+
+  if( index->slots ) { free( index->slots ); }
+  index_init( index, key );
 }
 
+static void __index_put( struct index *index, struct dlist *node, unsigned int hash, unsigned int seq )
+{
+  unsigned int mask = index->size - 1;
+  unsigned int i    = hash & mask;
+
+  while( index->slots[i].node ) i = (i + 1) & mask;
+
+  if( !index->slots[i].deleted ) ++index->used;
+
+  index->slots[i].node    = node;
+  index->slots[i].hash    = hash;
+  index->slots[i].seq     = seq;
+  index->slots[i].deleted = 0;
+  ++index->count;
+}
 
-static struct pkginfo *__pkginfo_alloc( void )
+static void __index_resize( struct index *index, unsigned int size )
 {
-  struct pkginfo *pkginfo = NULL;
+  struct index_entry *slots = index->slots;
+  unsigned int        i, old_size = index->size;
 
-  pkginfo = (struct pkginfo *)malloc( sizeof( struct pkginfo ) );
-  if( !pkginfo ) { FATAL_ERROR( "Cannot allocate memory" ); }
-  bzero( (void *)pkginfo, sizeof( struct pkginfo ) );
+  index->slots = (struct index_entry *)calloc( (size_t)size, sizeof( struct index_entry ) );
+  if( !index->slots ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  index->size  = size;
+  index->used  = 0;
+  index->count = 0;
+
+  for( i = 0; i < old_size; ++i )
+  {
+    if( slots[i].node ) __index_put( index, slots[i].node, slots[i].hash, slots[i].seq );
+  }
 
-  return pkginfo;
+  if( slots ) free( slots );
 }
 
-static void __pkginfo_free( struct pkginfo *pkginfo )
+static void index_insert( struct index *index, struct dlist *node )
 {
-  if( pkginfo )
+  const char *group = NULL, *name = NULL;
+
+  if( !index || !node ) return;
+
+  if( (index->used + 1) * 4 >= index->size * 3 )
   {
-    if( pkginfo->name )              { free( pkginfo->name );              pkginfo->name              = NULL; }
-    if( pkginfo->version )           { free( pkginfo->version );           pkginfo->version           = NULL; }
-    if( pkginfo->arch )              { free( pkginfo->arch );              pkginfo->arch              = NULL; }
-    if( pkginfo->distro_name )       { free( pkginfo->distro_name );       pkginfo->distro_name       = NULL; }
-    if( pkginfo->distro_version )    { free( pkginfo->distro_version );    pkginfo->distro_version    = NULL; }
-    if( pkginfo->group )             { free( pkginfo->group );             pkginfo->group             = NULL; }
-    if( pkginfo->short_description ) { free( pkginfo->short_description ); pkginfo->short_description = NULL; }
-    if( pkginfo->url )               { free( pkginfo->url );               pkginfo->url               = NULL; }
-    if( pkginfo->license )           { free( pkginfo->license );           pkginfo->license           = NULL; }
+    unsigned int size = ( index->size ) ? index->size : INDEX_MIN_SIZE;
 
-    free( pkginfo );
+    while( (index->count + 1) * 2 >= size ) size <<= 1;
+    __index_resize( index, size );
   }
+
+  index->key( node->data, &group, &name );
+  __index_put( index, node, __index_hash( group, name ), index->seq++ );
 }
 
+static void index_remove( struct index *index, struct dlist *node )
+{
+  const char  *group = NULL, *name = NULL;
+  unsigned int hash, mask, i;
+
+  if( !index || !node || !index->count ) return;
+
+  index->key( node->data, &group, &name );
+  hash = __index_hash( group, name );
+  mask = index->size - 1;
+
+  for( i = hash & mask; index->slots[i].node || index->slots[i].deleted; i = (i + 1) & mask )
+  {
+    if( index->slots[i].node == node )
+    {
+      index->slots[i].node    = NULL;
+      index->slots[i].deleted = 1;
+      --index->count;
+      return;
+    }
+  }
+}
 
-static struct references *__references_alloc( void )
+/*
+  Returns the first inserted node which has the same key as (group, name)
+  and for which cmp_func( node->data, data ) returns zero. If the cmp_func
+  is NULL then only keys are compared.
+ */
+static struct dlist *index_find( struct index *index, const char *group, const char *name, DLCMPF cmp_func, const void *data )
 {
-  struct references *references = NULL;
+  struct dlist *found = NULL;
+  unsigned int  hash, mask, i, seq = 0;
+
+  if( !index || !index->count || !name ) return found;
+
+  hash = __index_hash( group, name );
+  mask = index->size - 1;
 
-  references = (struct references *)malloc( sizeof( struct references ) );
-  if( !references ) { FATAL_ERROR( "Cannot allocate memory" ); }
-  bzero( (void *)references, sizeof( struct references ) );
+  for( i = hash & mask; index->slots[i].node || index->slots[i].deleted; i = (i + 1) & mask )
+  {
+    struct index_entry *entry = &index->slots[i];
+
+    if( entry->node && entry->hash == hash && (!found || entry->seq < seq) )
+    {
+      const char *g = NULL, *n = NULL;
+
+      index->key( entry->node->data, &g, &n );
+
+      if( __index_key_equal( g, n, group, name ) && (!cmp_func || !cmp_func( entry->node->data, data )) )
+      {
+        found = entry->node;
+        seq   = entry->seq;
+      }
+    }
+  }
 
-  return references;
+  return found;
 }
 
-static void __references_free( struct references *references )
+/* Drops all entries and indexes the list in the order of nodes. */
+static void index_rebuild( struct index *index, struct dlist *list )
 {
-  if( references )
+  index_free( index );
+
+  while( list )
   {
-    if( references->list ) { dlist_free( references->list, __pkg_free_func ); references->list = NULL; }
-    free( references );
+    index_insert( index, list );
+    list = dlist_next( list );
   }
 }
 
 
-static struct requires *__requires_alloc( void )
+static void __package_key( const void *data, const char **group, const char **name )
 {
-  struct requires *requires = NULL;
+  const struct package *package = (const struct package *)data;
+
+  *group = package->pkginfo->group;
+  *name  = package->pkginfo->name;
+}
 
-  requires = (struct requires *)malloc( sizeof( struct requires ) );
-  if( !requires ) { FATAL_ERROR( "Cannot allocate memory" ); }
-  bzero( (void *)requires, sizeof( struct requires ) );
+static void __package_name_key( const void *data, const char **group, const char **name )
+{
+  const struct package *package = (const struct package *)data;
 
-  return requires;
+  *group = NULL;
+  *name  = package->pkginfo->name;
 }
 
-static void __requires_free( struct requires *requires )
+static void __pkg_key( const void *data, const char **group, const char **name )
 {
-  if( requires )
-  {
-    if( requires->list ) { dlist_free( requires->list, __pkg_free_func ); requires->list = NULL; }
-    free( requires );
-  }
+  const struct pkg *pkg = (const struct pkg *)data;
+
+  *group = pkg->group;
+  *name  = pkg->name;
+}
+
+#define INDEX_INIT( key )  { NULL, 0, 0, 0, 0, key }
+
+static struct index packages_index        = INDEX_INIT( __package_key );
+static struct index provides_index        = INDEX_INIT( __package_key );
+static struct index provides_names_index  = INDEX_INIT( __package_name_key );
+static struct index extern_requires_index = INDEX_INIT( __pkg_key );
+static struct index tree_index            = INDEX_INIT( __package_key );
+/*
+  End of Hash INDEX functions.
+ ***************************************************************/
+
+
+/***************************************************************
+  PACKAGE functions:
+  =================
+
+    Packages, pkgs, the nodes of their lists and all strings of
+    the package model are allocated from the MODEL arena.  They
+    live up to free_packages() which releases the arena at once,
+    so package_free() and pkg_free() don't free anything.
+
+    Names, groups, versions, arch and distro strings are interned
+    by pkglist_intern(): the equal strings share one copy, so the
+    model compares these fields by pointers instead of strcmp().
+ */
+static struct arena *model = NULL;
+
+struct strings
+{
+  const char  **slots;
+  unsigned int  size;  /* always a power of two */
+  unsigned int  count;
+};
+
+static struct strings strings = { NULL, 0, 0 };
+
+#define STRINGS_MIN_SIZE  1024
+
+static void *__model_alloc( size_t size )
+{
+  if( !model ) model = arena_create( 0 );
+  return arena_alloc( model, size );
 }
 
+char *pkglist_strdup( const char *s )
+{
+  if( !s ) return NULL;
+  if( !model ) model = arena_create( 0 );
+  return arena_strdup( model, s );
+}
 
-static struct files *__files_alloc( void )
+static unsigned int __string_hash( const char *s )
 {
-  struct files *files = NULL;
+  const unsigned char *p;
+  unsigned int hash = 2166136261u; /* FNV-1a */
 
-  files = (struct files *)malloc( sizeof( struct files ) );
-  if( !files ) { FATAL_ERROR( "Cannot allocate memory" ); }
-  bzero( (void *)files, sizeof( struct files ) );
+  for( p = (const unsigned char *)s; *p; ++p ) { hash ^= *p; hash *= 16777619u; }
 
-  return files;
+  return hash;
 }
 
-static void __files_free_func( void *data, void *user_data )
+static void __strings_resize( unsigned int size )
 {
-  if( data ) { free( data ); }
+  const char  **slots = strings.slots;
+  unsigned int  i, j, old_size = strings.size;
+
+  strings.slots = (const char **)calloc( (size_t)size, sizeof( const char * ) );
+  if( !strings.slots ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  strings.size = size;
+
+  for( i = 0; i < old_size; ++i )
+  {
+    if( !slots[i] ) continue;
+
+    for( j = __string_hash( slots[i] ) & (size - 1); strings.slots[j]; j = (j + 1) & (size - 1) ) ;
+    strings.slots[j] = slots[i];
+  }
+
+  if( slots ) free( slots );
 }
 
-static void __files_free( struct files *files )
+char *pkglist_intern( const char *s )
 {
-  if( files )
+  unsigned int i, mask;
+
+  if( !s ) return NULL;
+
+  if( (strings.count + 1) * 2 > strings.size )
+    __strings_resize( strings.size ? strings.size * 2 : STRINGS_MIN_SIZE );
+
+  mask = strings.size - 1;
+  for( i = __string_hash( s ) & mask; strings.slots[i]; i = (i + 1) & mask )
   {
-    if( files->list ) { dlist_free( files->list, __files_free_func ); files->list = NULL; }
-    free( files );
+    if( !strcmp( strings.slots[i], s ) ) return (char *)strings.slots[i];
   }
+
+  strings.slots[i] = pkglist_strdup( s );
+  ++strings.count;
+
+  return (char *)strings.slots[i];
+}
+
+static void __free_strings( void )
+{
+  if( strings.slots ) free( strings.slots );
+  bzero( (void *)&strings, sizeof( struct strings ) );
+}
+
+/*
+  Versions are compared by keys (see version_key() in cmpvers.c)
+  which are made on the first comparison and cached in the pkginfo
+  and pkg structures:
+ */
+static char *__version_key( const char *version )
+{
+  char *key;
+
+  if( !version ) return NULL;
+
+  key = (char *)alloca( VERSION_KEY_SIZE( strlen( version ) ) );
+  if( !version_key( key, version ) ) return NULL;
+
+  return pkglist_strdup( key );
+}
+
+static int __cmp_versions( const char *v1, char **k1, const char *v2, char **k2 )
+{
+  if( v1 == v2 ) return 0; /* interned strings */
+
+  if( !*k1 ) *k1 = __version_key( v1 );
+  if( !*k2 ) *k2 = __version_key( v2 );
+
+  if( *k1 && *k2 ) return strcmp( (const char *)*k1, (const char *)*k2 );
+
+  return cmp_version( v1, v2 );
+}
+
+static struct dlist *__model_link( void *data )
+{
+  struct dlist *link = (struct dlist *)__model_alloc( sizeof( struct dlist ) );
+
+  bzero( (void *)link, sizeof( struct dlist ) );
+  link->data = data;
+
+  return link;
+}
+
+
+struct pkg *pkg_alloc( void )
+{
+  struct pkg *pkg = NULL;
+
+  pkg = (struct pkg *)__model_alloc( sizeof( struct pkg ) );
+  bzero( (void *)pkg, sizeof( struct pkg ) );
+
+  return pkg;
+}
+
+void pkg_free( struct pkg *pkg )
+{
+  (void)pkg; /* released by free_packages() */
+}
+
+static void __pkg_free_func( void *data, void *user_data )
+{
+  struct pkg *pkg = (struct pkg *)data;
+  if( pkg ) { pkg_free( pkg ); }
 }
 
 
 struct package *package_alloc( void )
 {
-  struct package    *package    = NULL;
-  struct pkginfo    *pkginfo    = __pkginfo_alloc();
-  struct references *references = __references_alloc();
-  struct requires   *requires   = __requires_alloc();
-  struct files      *files      = __files_alloc();
+  struct package *package = NULL;
 
-  package = (struct package *)malloc( sizeof( struct package ) );
-  if( !package ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  package = (struct package *)__model_alloc( sizeof( struct package ) );
   bzero( (void *)package, sizeof( struct package ) );
 
-  package->pkginfo    = pkginfo;
-  package->references = references;
-  package->requires   = requires;
-  package->files      = files;
+  package->pkginfo    = (struct pkginfo *)__model_alloc( sizeof( struct pkginfo ) );
+  package->references = (struct references *)__model_alloc( sizeof( struct references ) );
+  package->requires   = (struct requires *)__model_alloc( sizeof( struct requires ) );
+  package->files      = (struct files *)__model_alloc( sizeof( struct files ) );
+
+  bzero( (void *)package->pkginfo,    sizeof( struct pkginfo ) );
+  bzero( (void *)package->references, sizeof( struct references ) );
+  bzero( (void *)package->requires,   sizeof( struct requires ) );
+  bzero( (void *)package->files,      sizeof( struct files ) );
 
   return package;
 }
 
 void package_free( struct package *package )
 {
-  if( package )
-  {
-    if( package->pkginfo )    {    __pkginfo_free( package->pkginfo );    package->pkginfo    = NULL; }
-    if( package->references ) { __references_free( package->references ); package->references = NULL; }
-    if( package->requires )   {   __requires_free( package->requires );   package->requires   = NULL; }
-    if( package->files )      {      __files_free( package->files );      package->files      = NULL; }
-
-    if( package->description )    { free( package->description );     package->description    = NULL; }
-    if( package->restore_links )  { free( package->restore_links );   package->restore_links  = NULL; }
-    if( package->install_script ) { free( package->install_script );  package->install_script = NULL; }
-    if( package->hardware )       { free( package->hardware );        package->hardware       = NULL; }
-    if( package->tarball )        { free( package->tarball );         package->tarball        = NULL; }
-
-    free( package );
-  }
+  (void)package; /* released by free_packages() */
 }
 
 static void __package_free_func( void *data, void *user_data )
@@ -342,21 +615,25 @@ static void __package_free_func( void *data, void *user_data )
 
 void free_packages( void )
 {
-  if( packages ) { dlist_free( packages, __package_free_func ); packages = NULL; }
+  index_free( &packages_index );
+  dlist_head_free( &packages, __package_free_func );
+
+  __free_strings();
+  arena_destroy( model ); model = NULL;
 }
 
 
 void add_package( struct package *package )
 {
-  packages = dlist_append( packages, (void *)package );
+  index_insert( &packages_index, dlist_head_append( &packages, (void *)package ) );
 }
 
 void add_reference( struct package *package, struct pkg *pkg )
 {
   if( package && package->references && pkg )
   {
-    package->references->list = dlist_append( package->references->list, (void *)pkg );
-    package->references->size = dlist_length( package->references->list );
+    package->references->list = dlist_append_link( package->references->list, __model_link( (void *)pkg ) );
+    ++package->references->size;
   }
 }
 
@@ -364,8 +641,8 @@ void add_required( struct package *package, struct pkg *pkg )
 {
   if( package && package->requires && pkg )
   {
-    package->requires->list = dlist_append( package->requires->list, (void *)pkg );
-    package->requires->size = dlist_length( package->requires->list );
+    package->requires->list = dlist_append_link( package->requires->list, __model_link( (void *)pkg ) );
+    ++package->requires->size;
   }
 }
 
@@ -373,8 +650,7 @@ void add_file( struct package *package, const char *fname )
 {
   if( package && package->files && fname )
   {
-    package->files->list = dlist_append( package->files->list, (void *)strdup( fname ) );
-    package->files->size = dlist_length( package->files->list );
+    dlist_head_append_link( &package->files->list, __model_link( (void *)pkglist_strdup( fname ) ) );
   }
 }
 
@@ -435,11 +711,11 @@ void package_print_files( struct package *package )
 {
   int cnt = 0;
 
-  if( !package ) return;
+  if( !package || !package_files( package ) ) return;
 
-  if( package->files->list )
+  if( dlist_head_length( &package->files->list ) )
   {
-    dlist_foreach( package->files->list, __print_file, (void *)&cnt );
+    dlist_head_foreach( &package->files->list, __print_file, (void *)&cnt );
   }
 }
 
@@ -448,178 +724,808 @@ void package_print_files( struct package *package )
  ***************************************************************/
 
 /***************************************************************
-  Extern REQUIRES list functions:
+  PKGLOG reading functions:
+  ========================
+
+    The PKGLOG file is mapped into memory and  read line by line
+    by one pass. Section headers switch the state of the reader
+    and the lines of each section are parsed directly into  the
+    PACKAGE structure.
+
+    The large sections (PACKAGE DESCRIPTION, RESTORE LINKS, INSTALL
+    SCRIPT and FILE LIST) are only counted by this pass. The reader
+    saves their positions in the PKGLOG file and the content is read
+    when package_description(), package_restore_links(),
+    package_install_script() or package_files() is called.
+
+    Section headers and header keys are recognized by the functions
+    of pkglog-scan.c shared with the Setup Database index (pkgdb.c).
  */
 
-static int __compare_required( const void *a, const void *b )
+struct text
 {
-  int  ret = -1;
+  char   *buf;
+  size_t  len, size;
+};
 
-  struct pkg *pkg1 = (struct pkg *)a;
-  struct pkg *pkg2 = (struct pkg *)b;
+struct pkglog_reader
+{
+  struct package *package;
 
-  if( pkg1->group && pkg2->group )
-  {
-    ret = strcmp( pkg1->group, pkg2->group );
-  }
-  else if( !pkg1->group && !pkg2->group )
-  {
-    ret = 0;
-  }
-  else if( pkg1->group )
-  {
-    ret = 1;
-  }
+  enum _pkglog_section section;
+  unsigned int lines[SECTIONS]; /* number of lines read in each section */
+  int          found[SECTIONS];
 
-  if( ! ret )
-  {
-    return strcmp( pkg1->name, pkg2->name );
-  }
-  return ret;
-}
+  unsigned int counter;    /* the value of REFERENCE COUNTER               */
+  unsigned int references; /* valid references within the counter         */
+  int          bad_requires;
 
-static int __compare_required_with_version( const void *a, const void *b )
+  char        *pattern;    /* 'pkgname:' prefix of description lines      */
+  unsigned int description;
+  struct text  text[SECTIONS];
+
+  int          deferred;   /* do not load the large sections              */
+  off_t        offset;     /* offset of the current line in PKGLOG file   */
+  off_t        next;       /* offset of the next line                     */
+};
+
+
+/***********************************************************
+  Remove leading spaces and take non-space characters only:
+  (Especialy for pkginfo lines)
+ */
+static char *skip_spaces( char *s )
 {
-  int  ret = -1;
+  char *q, *p = (char *)0;
 
-  struct pkg *pkg1 = (struct pkg *)a;
-  struct pkg *pkg2 = (struct pkg *)b;
+  if( !s || *s == '\0' ) return p;
 
-  if( pkg1->group && pkg2->group )
-  {
-    ret = strcmp( pkg1->group, pkg2->group );
-  }
-  else if( !pkg1->group && !pkg2->group )
-  {
-    ret = 0;
-  }
-  else if( pkg1->group )
-  {
-    ret = 1;
-  }
+  p = s;
 
-  if( ! ret )
-  {
-    ret = strcmp( pkg1->name, pkg2->name );
-    if( ! ret )
-    {
-      return cmp_version( (const char *)pkg1->version, (const char *)pkg2->version );
-    }
-  }
-  return ret;
+  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
+  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
+
+  if( *p == '\0' ) return (char *)0;
+
+  return p;
 }
 
-static void __add_unique_required( void *data, void *user_data )
+/*******************************
+  remove spaces at end of line:
+ */
+static void skip_eol_spaces( char *s )
 {
-  struct pkg *pkg = (struct pkg *)data;
+  char *p = (char *)0;
 
-  if( pkg )
-  {
-    struct dlist *found = dlist_find_data( extern_requires, __compare_required, (const void *)data );
+  if( !s || *s == '\0' ) return;
 
-    if( found )
-    {
-      if( cmp_version( (const char *)((struct pkg *)found->data)->version, (const char *)pkg->version ) )
-      {
-        char *s = ((struct pkg *)found->data)->version;
-        ((struct pkg *)found->data)->version =
-           strdup( max_version( (const char *)((struct pkg *)found->data)->version, (const char *)pkg->version ) );
-        free( s );
-      }
-    }
-    else
-    {
-      struct pkg *req = pkg_alloc();
-      if( req )
-      {
-        if( pkg->group )
-        {
-          req->group = strdup( pkg->group   );
-        }
-        req->name    = strdup( pkg->name    );
-        req->version = strdup( pkg->version );
+  p = s + strlen( s ) - 1;
+  while( p >= s && isspace( *p ) ) { *p-- = '\0'; }
+}
 
-        extern_requires = dlist_append( extern_requires, (void *)req );
-      }
-    }
+static size_t read_usize( char *s )
+{
+  size_t  size = 0;
+  size_t  mult = 1;
+  double  sz = 0.0;
+
+  char    suffix;
+  char   *q, *p = (char *)0;
+
+  if( !s || *s == '\0' ) return size;
+
+  p = s;
+
+  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
+  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
+
+  if( *p == '\0' ) return size;
+
+  --q;
+  suffix = *q;
+  switch( suffix )
+  {
+    /* by default size calculates in KiB - 1024 Bytes (du -s -h .) */
+    case 'G':
+    case 'g':
+      mult = 1024 * 1024;
+      *q = '\0';
+      break;
+    case 'M':
+    case 'm':
+      mult = 1024;
+      *q = '\0';
+      break;
+    case 'K':
+    case 'k':
+      *q = '\0';
+      break;
+    default:
+      break;
   }
+
+  if( sscanf( p, "%lg", &sz ) != 1 ) return size;
+
+  return (size_t)round( sz * (double)mult );
 }
 
-static void __fill_extern_requires( void *data, void *user_data )
+static int read_total_files( char *s )
 {
-  struct package *package = (struct package *)data;
+  int   n = 0;
+  char *q, *p = (char *)0;
 
-  if( package )
-  {
-    struct pkg *provide = pkg_alloc();
+  if( !s || *s == '\0' ) return n;
 
-    if( provide )
-    {
-      if( package->pkginfo->group )
-      {
-        provide->group = strdup( package->pkginfo->group   );
-      }
-      provide->name    = strdup( package->pkginfo->name    );
-      provide->version = strdup( package->pkginfo->version );
+  p = s;
 
-      provides = dlist_append( provides, (void *)provide );
-    }
+  while( (*p == ' ' || *p == '\t') && *p != '\0' ) { ++p; } q = p;
+  while(  *q != ' ' && *q != '\t'  && *q != '\0' ) { ++q; } *q = '\0';
 
-    if( package->requires->list )
-    {
-      dlist_foreach( package->requires->list, __add_unique_required, NULL );
-    }
-  }
+  if( *p == '\0' ) return n;
+
+  if( sscanf( p, "%u", &n ) != 1 ) return 0;
+
+  return n;
 }
 
-static void __clean_extern_requires( void *data, void *user_data )
+
+static void __text_append( struct text *text, const char *s )
 {
-  if( data )
+  size_t len = strlen( s ) + 1;
+
+  if( text->len + len + 1 > text->size )
   {
-    extern_requires = dlist_remove_data( extern_requires, __compare_required_with_version, __pkg_free_func, (const void *)data );
+    size_t size = text->size ? text->size : (size_t)PATH_MAX;
+
+    while( text->len + len + 1 > size ) size *= 2;
+
+    text->buf = (char *)realloc( text->buf, size );
+    if( !text->buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    text->size = size;
   }
+
+  memcpy( text->buf + text->len, s, len - 1 );
+  text->len += len;
+  text->buf[text->len - 1] = '\n';
+  text->buf[text->len]     = '\0';
 }
 
-static int __compare_provided_old_package( const void *a, const void *b )
+/* Returns the copy of collected text in the model arena or NULL if it is empty: */
+static char *__text_release( struct text *text )
 {
-  int  ret = -1;
+  char *buf = NULL;
 
-  struct package *pkg1 = (struct package *)a;
-  struct     pkg *pkg2 = (struct     pkg *)b;
+  if( text->buf && text->len ) buf = pkglist_strdup( text->buf );
+  if( text->buf ) free( text->buf );
+  text->buf = NULL; text->len = text->size = 0;
 
-  if( pkg1->pkginfo->group && pkg2->group )
-  {
-    ret = strcmp( pkg1->pkginfo->group, pkg2->group );
-  }
-  else if( !pkg1->pkginfo->group && !pkg2->group )
+  return buf;
+}
+
+
+static struct pkg *__parse_pkg( char *ln )
+{
+  struct pkg *pkg = NULL;
+  char *p, *group = NULL, *name = NULL, *version = NULL;
+
+  if( (p = index( (const char *)ln, '=' )) )
+  {
+    *p = '\0'; version = ++p;
+    if( (p = index( (const char *)ln, '/' )) )
+    {
+      *p = '\0'; name = ++p; group = (char *)&ln[0];
+    }
+    else
+    {
+      name  = (char *)&ln[0]; group = NULL;
+    }
+
+    pkg = pkg_alloc();
+
+    if( group ) pkg->group = pkglist_intern( group );
+    pkg->name    = pkglist_intern( name );
+    pkg->version = pkglist_intern( version );
+  }
+
+  return pkg;
+}
+
+static void __set_field( char **field, char *value )
+{
+  *field = value; /* the previous value stays in the model arena */
+}
+
+static void __read_header_line( struct pkglog_reader *reader, char *ln )
+{
+  struct pkginfo *info = reader->package->pkginfo;
+
+  char *value = NULL;
+
+  switch( pkglog_header_field( ln, &value ) )
+  {
+    case FIELD_NAME:              __set_field( &info->name, pkglist_intern( skip_spaces( value ) ) );           break;
+    case FIELD_VERSION:           __set_field( &info->version, pkglist_intern( skip_spaces( value ) ) );        break;
+    case FIELD_ARCH:              __set_field( &info->arch, pkglist_intern( skip_spaces( value ) ) );           break;
+    case FIELD_DISTRO_NAME:       __set_field( &info->distro_name, pkglist_intern( skip_spaces( value ) ) );    break;
+    case FIELD_DISTRO_VERSION:    __set_field( &info->distro_version, pkglist_intern( skip_spaces( value ) ) ); break;
+    case FIELD_GROUP:             __set_field( &info->group, pkglist_intern( skip_spaces( value ) ) );          break;
+    case FIELD_URL:               __set_field( &info->url, pkglist_strdup( skip_spaces( value ) ) );            break;
+    case FIELD_LICENSE:           __set_field( &info->license, pkglist_strdup( skip_spaces( value ) ) );        break;
+    case FIELD_UNCOMPRESSED_SIZE: info->uncompressed_size = read_usize( value );                                 break;
+    case FIELD_TOTAL_FILES:       info->total_files = read_total_files( value );                                 break;
+    default:
+      break;
+  }
+}
+
+static void __read_short_description( struct pkglog_reader *reader, const char *ln )
+{
+  char *buf = (char *)alloca( strlen( ln ) + 1 );
+
+  /* Get short_description from the first line of PACKAGE DESCRIPTION */
+  pkglog_short_description( buf, ln );
+  if( buf[0] != '\0' )
+  {
+    __set_field( &reader->package->pkginfo->short_description, pkglist_strdup( buf ) );
+  }
+}
+
+static void __read_description_line( struct pkglog_reader *reader, char *ln )
+{
+  char *match = NULL;
+
+  skip_eol_spaces( ln );
+
+  /*
+    skip non-significant spaces at beginning of line
+    and take lines started with 'pkgname:'
+   */
+  if( reader->pattern && (match = strstr( ln, reader->pattern )) &&
+      reader->description < DESCRIPTION_NUMBER_OF_LINES )
+  {
+    int mlen   = strlen( match ), plen = strlen( reader->pattern );
+    int length = ( mlen > plen )  ? (mlen - plen - 1) : 0 ;
+
+    if( length > DESCRIPTION_LENGTH_OF_LINE )
+    {
+      match[plen + 1 + DESCRIPTION_LENGTH_OF_LINE] = '\0'; /* truncating description line  */
+      skip_eol_spaces( match );                            /* remove spaces at end-of-line */
+    }
+    __text_append( &reader->text[SECTION_DESCRIPTION], match );
+    ++reader->description;
+  }
+}
+
+static void __description_pattern( struct pkglog_reader *reader )
+{
+  const char *name = reader->package->pkginfo->name;
+
+  if( name && !reader->pattern )
+  {
+    reader->pattern = (char *)malloc( strlen( name ) + 2 );
+    if( !reader->pattern ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    (void)sprintf( reader->pattern, "%s:", name );
+  }
+}
+
+static struct pkglog_section *__package_section( struct package *package, enum _pkglog_section section )
+{
+  switch( section )
+  {
+    case SECTION_DESCRIPTION:    return &package->description_section;
+    case SECTION_RESTORE_LINKS:  return &package->restore_links_section;
+    case SECTION_INSTALL_SCRIPT: return &package->install_script_section;
+    case SECTION_FILE_LIST:      return &package->file_list_section;
+    default:
+      break;
+  }
+  return NULL;
+}
+
+/* Saves the end of deferred section: */
+static void __stop_section( struct pkglog_reader *reader, off_t offset )
+{
+  struct pkglog_section *section = __package_section( reader->package, reader->section );
+
+  if( reader->deferred && section )
+  {
+    section->size = (size_t)(offset - section->offset);
+  }
+}
+
+static void __start_section( struct pkglog_reader *reader, enum _pkglog_section section, char *ln )
+{
+  struct pkglog_section *deferred = NULL;
+
+  __stop_section( reader, reader->offset );
+
+  reader->section = section;
+  if( reader->deferred && (deferred = __package_section( reader->package, section )) )
+  {
+    deferred->offset = reader->next;
+    deferred->size   = 0;
+  }
+  ++reader->found[section];
+  reader->lines[section] = 0;
+
+  switch( section )
+  {
+    case SECTION_REFERENCES:
+    {
+      unsigned int count;
+
+      skip_eol_spaces( ln );
+      if( sscanf( ln, "REFERENCE COUNTER: %u", &count ) == 1 ) reader->counter = count;
+      break;
+    }
+    case SECTION_DESCRIPTION:
+      __description_pattern( reader );
+      break;
+    default:
+      break;
+  }
+}
+
+static void __read_pkglog_line( struct pkglog_reader *reader, char *ln )
+{
+  enum _pkglog_section section;
+
+  /* FILE LIST is the last section; any line after its header is a file name: */
+  if( reader->section != SECTION_FILE_LIST && (section = pkglog_section_header( ln )) != SECTION_HEADER )
   {
-    ret = 0;
+    __start_section( reader, section, ln );
+    return;
   }
-  else if( pkg1->pkginfo->group )
+
+  ++reader->lines[reader->section];
+
+  if( reader->deferred && __package_section( reader->package, reader->section ) )
   {
-    ret = 1;
+    /* Only the short description is taken from deferred sections: */
+    if( reader->section == SECTION_DESCRIPTION && reader->lines[SECTION_DESCRIPTION] == 1 )
+    {
+      __read_short_description( reader, (const char *)ln );
+    }
+    return;
   }
 
-  if( ! ret )
+  switch( reader->section )
   {
-    ret = strcmp( pkg1->pkginfo->name, pkg2->name );
-    if( ! ret )
+    case SECTION_HEADER:
+      skip_eol_spaces( ln );
+      __read_header_line( reader, ln );
+      break;
+
+    case SECTION_REFERENCES:
+      skip_eol_spaces( ln );
+      if( reader->lines[SECTION_REFERENCES] <= reader->counter )
+      {
+        struct pkg *pkg = __parse_pkg( ln );
+        if( pkg ) { add_reference( reader->package, pkg ); ++reader->references; }
+      }
+      break;
+
+    case SECTION_REQUIRES:
     {
-      pkg2->procedure = UPDATE; /* mark as too old */
-      return ret;
+      struct pkg *pkg;
+
+      skip_eol_spaces( ln );
+      if( (pkg = __parse_pkg( ln )) ) add_required( reader->package, pkg );
+      else                            ++reader->bad_requires;
+      break;
     }
+
+    case SECTION_DESCRIPTION:
+      __read_description_line( reader, ln );
+      break;
+
+    case SECTION_RESTORE_LINKS:
+    case SECTION_INSTALL_SCRIPT:
+      skip_eol_spaces( ln );
+      __text_append( &reader->text[reader->section], ln );
+      break;
+
+    case SECTION_FILE_LIST:
+      skip_eol_spaces( ln );
+      add_file( reader->package, (const char *)ln );
+      break;
+
+    default:
+      break;
   }
+}
+
+static int __finish_pkglog( struct pkglog_reader *reader )
+{
+  struct pkginfo *info = reader->package->pkginfo;
+
+  if( !info->name || !info->version || !info->arch || !info->distro_name || !info->distro_version )
+    return PKGLOG_INVALID;
+  /* group can be equal to NULL */
+
+  if( !reader->found[SECTION_REFERENCES] || !reader->found[SECTION_REQUIRES] )
+    return PKGLOG_NO_REFERENCES;
+  if( reader->references != reader->counter )
+    return PKGLOG_BAD_REFERENCES;
+
+  if( !reader->found[SECTION_DESCRIPTION] )
+    return PKGLOG_NO_REQUIRES;
+  if( reader->bad_requires )
+    return PKGLOG_BAD_REQUIRES;
+
+  if( !reader->found[SECTION_RESTORE_LINKS] )
+    return PKGLOG_NO_DESCRIPTION;
+  if( !reader->found[SECTION_INSTALL_SCRIPT] )
+    return PKGLOG_NO_RESTORE_LINKS;
+  if( !reader->found[SECTION_FILE_LIST] )
+    return PKGLOG_NO_INSTALL_SCRIPT;
+
+  if( !reader->lines[SECTION_FILE_LIST] )
+    return PKGLOG_EMPTY_FILE_LIST;
+  info->total_files = (int)reader->lines[SECTION_FILE_LIST];
+
+  return PKGLOG_OK;
+}
+
+/* Moves the collected text of loaded SECTION into the package: */
+static void __finish_section( struct pkglog_reader *reader, enum _pkglog_section section )
+{
+  struct package *package = reader->package;
+
+  switch( section )
+  {
+    case SECTION_DESCRIPTION:
+      if( !reader->lines[SECTION_DESCRIPTION] || !reader->pattern ) break;
+      while( reader->description < DESCRIPTION_NUMBER_OF_LINES )
+      {
+        __text_append( &reader->text[SECTION_DESCRIPTION], reader->pattern );
+        ++reader->description;
+      }
+      package->description = __text_release( &reader->text[SECTION_DESCRIPTION] );
+      break;
+    case SECTION_RESTORE_LINKS:
+      package->restore_links = __text_release( &reader->text[SECTION_RESTORE_LINKS] );
+      break;
+    case SECTION_INSTALL_SCRIPT:
+      package->install_script = __text_release( &reader->text[SECTION_INSTALL_SCRIPT] );
+      break;
+    default:
+      break;
+  }
+}
+
+static void __free_reader( struct pkglog_reader *reader )
+{
+  int section;
+
+  for( section = 0; section < SECTIONS; ++section )
+  {
+    if( reader->text[section].buf ) free( reader->text[section].buf );
+  }
+  if( reader->pattern ) free( reader->pattern );
+}
+
+/* Reads lines of BUF placed at OFFSET of the PKGLOG file: */
+static void __read_lines( struct pkglog_reader *reader, const char *buf, size_t size, off_t offset )
+{
+  const char *p = buf, *end = buf + size;
+  char       *line = NULL;
+
+  line = (char *)malloc( (size_t)PATH_MAX );
+  if( !line ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  while( p < end )
+  {
+    const char *eol = (const char *)memchr( (const void *)p, '\n', (size_t)(end - p) );
+    size_t      len = eol ? (size_t)(eol - p) : (size_t)(end - p);
+
+    if( reader->deferred && reader->section == SECTION_FILE_LIST )
+    {
+      /* FILE LIST is the last section; here we have to count files only: */
+      ++reader->lines[SECTION_FILE_LIST];
+      p = eol ? eol + 1 : end;
+      continue;
+    }
+
+    if( len > PATH_MAX - 1 ) len = PATH_MAX - 1;
+    memcpy( (void *)line, (const void *)p, len );
+    line[len] = '\0';
+
+    p = eol ? eol + 1 : end;
+    reader->next = offset + (off_t)(p - buf);
+
+    __read_pkglog_line( reader, line );
+
+    reader->offset = reader->next;
+  }
+
+  free( line );
+}
+
+int read_pkglog( const char *fname, struct package *package )
+{
+  struct pkglog_reader reader;
+  struct stat sb;
+  int    fd, ret;
+
+  char  *map = NULL;
+  size_t size;
+
+  if( !fname || !package ) { errno = EINVAL; return -1; }
+
+  if( (fd = open( fname, O_RDONLY )) == -1 ) return -1;
+
+  if( fstat( fd, &sb ) == -1 ) { close( fd ); return -1; }
+  size = (size_t)sb.st_size;
+
+  if( size )
+  {
+    map = (char *)mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if( map == MAP_FAILED ) { close( fd ); return -1; }
+    (void)madvise( (void *)map, size, MADV_SEQUENTIAL );
+  }
+  close( fd );
+
+  bzero( (void *)&reader, sizeof( struct pkglog_reader ) );
+  reader.package  = package;
+  reader.deferred = 1;
+
+  __read_lines( &reader, (const char *)map, size, 0 );
+  __stop_section( &reader, (off_t)size );
+
+  ret = __finish_pkglog( &reader );
+  if( ret == PKGLOG_OK )
+  {
+    package->pkglog = pkglist_strdup( fname );
+  }
+
+  __free_reader( &reader );
+
+  if( map ) (void)munmap( (void *)map, size );
+
   return ret;
 }
 
+/*
+  Returns the raw text of deferred SECTION of the PACKAGE read from
+  PKGLOG file into temporary buffer ('\0' terminated), or NULL if the
+  section is loaded already or the file cannot be read. The buffer
+  should be freed by caller.
+ */
+static char *__read_section( struct package *package, enum _pkglog_section section )
+{
+  struct pkglog_section *deferred = __package_section( package, section );
+
+  char  *buf = NULL;
+  int    fd;
+
+  if( !deferred || !deferred->size || !package->pkglog ) return NULL;
+
+  if( (fd = open( (const char *)package->pkglog, O_RDONLY )) == -1 ) return NULL;
+
+  buf = (char *)malloc( deferred->size + 1 );
+  if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  if( pread( fd, (void *)buf, deferred->size, deferred->offset ) != (ssize_t)deferred->size )
+  {
+    free( buf ); buf = NULL;
+  }
+  else
+  {
+    buf[deferred->size] = '\0';
+  }
+  close( fd );
+
+  return buf;
+}
+
+/*
+  Reads the deferred SECTION of the PACKAGE from PKGLOG file.
+  The section is marked as loaded even if the file cannot be
+  read (for example, when the temporary directory is removed).
+ */
+static void __load_section( struct package *package, enum _pkglog_section section )
+{
+  struct pkglog_section *deferred = __package_section( package, section );
+  struct pkglog_reader   reader;
+
+  char  *buf = NULL;
+
+  if( !deferred || !deferred->size ) return;
+
+  if( (buf = __read_section( package, section )) )
+  {
+    bzero( (void *)&reader, sizeof( struct pkglog_reader ) );
+    reader.package = package;
+    reader.section = section;
+    if( section == SECTION_DESCRIPTION ) __description_pattern( &reader );
+
+    __read_lines( &reader, (const char *)buf, deferred->size, deferred->offset );
+    __finish_section( &reader, section );
+
+    __free_reader( &reader );
+    free( buf );
+  }
+
+  deferred->size = 0;
+}
+
+const char *package_description( struct package *package )
+{
+  if( !package ) return NULL;
+  __load_section( package, SECTION_DESCRIPTION );
+  return (const char *)package->description;
+}
+
+const char *package_restore_links( struct package *package )
+{
+  if( !package ) return NULL;
+  __load_section( package, SECTION_RESTORE_LINKS );
+  return (const char *)package->restore_links;
+}
+
+const char *package_install_script( struct package *package )
+{
+  if( !package ) return NULL;
+  __load_section( package, SECTION_INSTALL_SCRIPT );
+  return (const char *)package->install_script;
+}
+
+struct files *package_files( struct package *package )
+{
+  if( !package ) return NULL;
+  __load_section( package, SECTION_FILE_LIST );
+  return package->files;
+}
+
+const char *pkglog_strerror( int status )
+{
+  switch( status )
+  {
+    case PKGLOG_OK:                return "Success";
+    case PKGLOG_INVALID:           return "Invalid PKGLOG file";
+    case PKGLOG_NO_REFERENCES:     return "PKGLOG doesn't contains REFERENCE COUNTER section";
+    case PKGLOG_BAD_REFERENCES:    return "Invalid REFERENCE COUNTER section";
+    case PKGLOG_NO_REQUIRES:       return "PKGLOG doesn't contains REQUIRES section";
+    case PKGLOG_BAD_REQUIRES:      return "Invalid REQUIRES section";
+    case PKGLOG_NO_DESCRIPTION:    return "PKGLOG doesn't contains PACKAGE DESCRIPTION section";
+    case PKGLOG_NO_RESTORE_LINKS:  return "PKGLOG doesn't contains RESTORE LINKS section";
+    case PKGLOG_NO_INSTALL_SCRIPT: return "PKGLOG doesn't contains INSTALL SCRIPT section";
+    case PKGLOG_EMPTY_FILE_LIST:   return "PKGLOG contains empty FILE LIST section";
+    default:
+      break;
+  }
+  return strerror( errno );
+}
+
+/*
+  End of PKGLOG reading functions.
+ ***************************************************************/
+
+/***************************************************************
+  Extern REQUIRES list functions:
+ */
+
+static int __compare_required_with_version( const void *a, const void *b )
+{
+  struct pkg *pkg1 = (struct pkg *)a;
+  struct pkg *pkg2 = (struct pkg *)b;
+
+  /* groups, names and versions are interned strings: */
+  if( pkg1->group != pkg2->group || pkg1->name != pkg2->name ) return -1;
+
+  return __cmp_versions( pkg1->version, &pkg1->version_key, pkg2->version, &pkg2->version_key );
+}
+
+static void __add_unique_required( void *data, void *user_data )
+{
+  struct pkg *pkg = (struct pkg *)data;
+
+  if( pkg )
+  {
+    struct dlist *found = index_find( &extern_requires_index, pkg->group, pkg->name, NULL, NULL );
+
+    if( found )
+    {
+      struct pkg *req = (struct pkg *)found->data;
+
+      if( __cmp_versions( req->version, &req->version_key, pkg->version, &pkg->version_key ) < 0 )
+      {
+        req->version     = pkg->version;
+        req->version_key = pkg->version_key;
+      }
+    }
+    else
+    {
+      struct pkg *req = pkg_alloc();
+      if( req )
+      {
+        req->group       = pkg->group;
+        req->name        = pkg->name;
+        req->version     = pkg->version;
+        req->version_key = pkg->version_key;
+
+        index_insert( &extern_requires_index, dlist_head_append( &extern_requires_head, (void *)req ) );
+      }
+    }
+  }
+}
+
+static void __fill_extern_requires( void *data, void *user_data )
+{
+  struct package *package = (struct package *)data;
+
+  if( package )
+  {
+    struct pkg *provide = pkg_alloc();
+
+    if( provide )
+    {
+      provide->group   = package->pkginfo->group;
+      provide->name    = package->pkginfo->name;
+      provide->version     = package->pkginfo->version;
+      provide->version_key = package->pkginfo->version_key;
+
+      (void)dlist_head_append( &provides_head, (void *)provide );
+    }
+
+    if( package->requires->list )
+    {
+      dlist_foreach( package->requires->list, __add_unique_required, NULL );
+    }
+  }
+}
+
+static void __clean_extern_requires( void *data, void *user_data )
+{
+  struct pkg *pkg = (struct pkg *)data;
+
+  if( pkg )
+  {
+    struct dlist *found = index_find( &extern_requires_index, pkg->group, pkg->name,
+                                      __compare_required_with_version, (const void *)data );
+    if( found )
+    {
+      index_remove( &extern_requires_index, found );
+      dlist_head_remove_link( &extern_requires_head, found );
+      __pkg_free_func( found->data, data );
+      free( found );
+    }
+  }
+}
+
+static int __compare_provided_old_package( const void *a, const void *b )
+{
+  struct package *pkg1 = (struct package *)a;
+  struct     pkg *pkg2 = (struct     pkg *)b;
+
+  if( pkg1->pkginfo->group != pkg2->group || pkg1->pkginfo->name != pkg2->name ) return -1;
+
+  pkg2->procedure = UPDATE; /* mark as too old */
+  return 0;
+}
+
 static void __remove_old_package( void *data, void *user_data )
 {
-  packages = dlist_remove_data( packages, __compare_provided_old_package, __package_free_func, (const void *)data );
+  struct pkg *pkg = (struct pkg *)data;
+
+  if( pkg )
+  {
+    struct dlist *found = index_find( &packages_index, pkg->group, pkg->name,
+                                      __compare_provided_old_package, (const void *)data );
+    if( found )
+    {
+      index_remove( &packages_index, found );
+      dlist_head_remove_link( &packages, found );
+      __package_free_func( found->data, data );
+      free( found );
+    }
+  }
 }
 
 static void remove_old_packages( void )
 {
-  dlist_foreach( extern_requires, __remove_old_package, NULL );
+  dlist_head_foreach( &extern_requires_head, __remove_old_package, NULL );
 }
 /*
   End of Extern REQUIRES list functions.
@@ -629,133 +1535,541 @@ static void remove_old_packages( void )
 /***************************************************************
   Check REQUIRES functions:
  */
-static int __compare_provided( const void *a, const void *b )
+static int __compare_packages_by_name( const void *a, const void *b )
 {
-  int  ret = -1;
-
   struct package *pkg1 = (struct package *)a;
-  struct     pkg *pkg2 = (struct     pkg *)b;
+  struct package *pkg2 = (struct package *)b;
+
+  /* packages with the same name are equal whatever groups they belong to */
+  return ( pkg1->pkginfo->name == pkg2->pkginfo->name ) ? 0 : -1;
+}
 
-  if( pkg1->pkginfo->group && pkg2->group )
+/* Returns 1 if the required package is satisfied by the extern_requires list. */
+static int check_extern_required( struct pkg *pkg )
+{
+  struct dlist *found = index_find( &extern_requires_index, pkg->group, pkg->name, NULL, NULL );
+
+  if( found )
   {
-    ret = strcmp( pkg1->pkginfo->group, pkg2->group );
+    struct pkg *req = (struct pkg *)found->data;
+
+    if( __cmp_versions( req->version, &req->version_key, pkg->version, &pkg->version_key ) >= 0 )
+    {
+      /* required package is found in the extern_requires list */
+      return 1;
+    }
   }
-  else if( !pkg1->pkginfo->group && !pkg2->group )
+  return 0;
+}
+
+static void check_update( struct package *package )
+{
+  struct dlist *update = NULL;
+
+  /* Packages without requires are never marked for update: */
+  if( !package->requires->list ) return;
+
+  /* Check if the package with the same name already exists in the provides list */
+  update = index_find( &provides_names_index, NULL, package->pkginfo->name,
+                       __compare_packages_by_name, (const void *)package );
+  if( update )
   {
-    ret = 0;
+    /* Set install procedure to UPDATE: */
+    package->procedure = UPDATE;
   }
-  else if( pkg1->pkginfo->group )
+}
+/*
+  End of Check REQUIRES functions.
+ ***************************************************************/
+
+static void __provide_package( struct dlist *node )
+{
+  struct dlist *provided = NULL;
+
+  /* move independed package to the provides list */
+  index_remove( &packages_index, node );
+  dlist_head_remove_link( &packages, node );
+
+  provided = dlist_head_append( &provides_head, node->data );
+  index_insert( &provides_index, provided );
+  index_insert( &provides_names_index, provided );
+
+  free( node );
+}
+
+
+/***************************************************************
+  Topological SORT functions:
+  ==========================
+
+  NOTE:
+  ----
+    Packages are moved into the provides list in the same order
+    as the passes over the packages list do: a package leaves the
+    list on the first pass where all its requires are provided by
+    packages which left the list before it. Each required package
+    is provided by the first moved package with the same key.
+
+    So the pass of the package is the max of the passes of its
+    required packages, plus one for each required package which
+    follows it in the list, and the packages are released from the
+    ready queue in order of (pass, position) in O((V + E) log V).
+
+    The level of the package is the number of the dependency wave:
+    all requires of the package are provided by packages of lower
+    levels, so packages of the same level can be installed at once.
+    Packages with the same name are never placed at the same level:
+    each next of them gets the level above the previous one.
+
+    Packages which never become ready are members of or depend on
+    a cycle (or require a newer version than provided); the cycles
+    are found as strongly connected components (Tarjan).
+ */
+struct tsort_edge
+{
+  int                node;  /* waiting package  */
+  struct pkg        *pkg;   /* required version */
+  struct tsort_edge *next;
+};
+
+struct tsort_key
+{
+  struct pkg        *pkg;      /* (group, name) key                 */
+  int                provider; /* first package with the key or -1  */
+  struct tsort_edge *waiters;
+};
+
+struct tsort_name
+{
+  const char *name;
+  int         level;    /* level of the last provided package NAME */
+};
+
+struct tsort_node
+{
+  struct dlist *list;      /* NULL when the package is provided */
+  int           position;
+  int           pass;
+  int           level;     /* installation level (wave)         */
+  int           depended;  /* number of unsatisfied requires    */
+
+  int           index, lowlink, on_stack;
+};
+
+struct tsort
+{
+  struct tsort_node *nodes;
+  int                size;
+
+  int               *queue; /* binary heap ordered by (pass, position) */
+  int                queued;
+
+  struct dlist_head  keys;
+  struct index       keys_index;
+
+  struct dlist_head  names;
+  struct index       names_index;
+
+  int               *stack; /* Tarjan's stack */
+  int                sp, index;
+};
+
+static void __tsort_key( const void *data, const char **group, const char **name )
+{
+  const struct tsort_key *key = (const struct tsort_key *)data;
+
+  *group = key->pkg->group;
+  *name  = key->pkg->name;
+}
+
+static void __tsort_name( const void *data, const char **group, const char **name )
+{
+  const struct tsort_name *same = (const struct tsort_name *)data;
+
+  *group = NULL;
+  *name  = same->name;
+}
+
+static int __tsort_less( struct tsort *ts, int a, int b )
+{
+  if( ts->nodes[a].pass != ts->nodes[b].pass )
+    return ts->nodes[a].pass < ts->nodes[b].pass;
+
+  return ts->nodes[a].position < ts->nodes[b].position;
+}
+
+static void tsort_push( struct tsort *ts, int node )
+{
+  int i = ts->queued++;
+
+  while( i > 0 && __tsort_less( ts, node, ts->queue[(i - 1) / 2] ) )
   {
-    ret = 1;
+    ts->queue[i] = ts->queue[(i - 1) / 2];
+    i = (i - 1) / 2;
   }
+  ts->queue[i] = node;
+}
+
+static int tsort_pop( struct tsort *ts )
+{
+  int node = ts->queue[0], last = ts->queue[--ts->queued];
+  int i = 0, child;
 
-  if( ! ret )
+  while( (child = 2 * i + 1) < ts->queued )
   {
-    return strcmp( pkg1->pkginfo->name, pkg2->name );
+    if( child + 1 < ts->queued && __tsort_less( ts, ts->queue[child + 1], ts->queue[child] ) ) ++child;
+    if( !__tsort_less( ts, ts->queue[child], last ) ) break;
+    ts->queue[i] = ts->queue[child];
+    i = child;
   }
-  return ret;
+  ts->queue[i] = last;
+
+  return node;
 }
 
-static int __compare_packages_by_name( const void *a, const void *b )
+static struct tsort_key *tsort_find_key( struct tsort *ts, const char *group, const char *name )
 {
-  int  ret = -1;
+  struct dlist *found = index_find( &ts->keys_index, group, name, NULL, NULL );
 
-  struct package *pkg1 = (struct package *)a;
-  struct package *pkg2 = (struct package *)b;
+  if( found ) return (struct tsort_key *)found->data;
+  return NULL;
+}
+
+static void tsort_init( struct tsort *ts )
+{
+  struct dlist *list = NULL;
+  int i;
+
+  bzero( (void *)ts, sizeof(struct tsort) );
+  index_init( &ts->keys_index, __tsort_key );
+  index_init( &ts->names_index, __tsort_name );
+
+  ts->size  = dlist_head_length( &packages );
+  ts->nodes = (struct tsort_node *)calloc( (size_t)ts->size + 1, sizeof(struct tsort_node) );
+  ts->queue = (int *)calloc( (size_t)ts->size + 1, sizeof(int) );
+  ts->stack = (int *)calloc( (size_t)ts->size + 1, sizeof(int) );
+  if( !ts->nodes || !ts->queue || !ts->stack ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( i = 0, list = dlist_head_first( &packages ); list; ++i, list = dlist_next( list ) )
+  {
+    struct package *package = (struct package *)list->data;
+    struct dlist   *reqs    = package->requires->list;
+
+    ts->nodes[i].list     = list;
+    ts->nodes[i].position = i;
+    ts->nodes[i].pass     = 1;
+    ts->nodes[i].level    = 1;
+
+    while( reqs )
+    {
+      struct pkg        *pkg  = (struct pkg *)reqs->data;
+      struct tsort_key  *key  = NULL;
+      struct tsort_edge *edge = NULL;
+
+      reqs = dlist_next( reqs );
+
+      if( !pkg || check_extern_required( pkg ) ) continue;
+
+      if( !(key = tsort_find_key( ts, pkg->group, pkg->name )) )
+      {
+        key = (struct tsort_key *)malloc( sizeof(struct tsort_key) );
+        if( !key ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+        key->pkg      = pkg;
+        key->provider = -1;
+        key->waiters  = NULL;
+
+        index_insert( &ts->keys_index, dlist_head_append( &ts->keys, (void *)key ) );
+      }
+
+      edge = (struct tsort_edge *)malloc( sizeof(struct tsort_edge) );
+      if( !edge ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+      edge->node    = i;
+      edge->pkg     = pkg;
+      edge->next    = key->waiters;
+      key->waiters  = edge;
+
+      ts->nodes[i].depended += 1;
+    }
+  }
+
+  for( i = 0; i < ts->size; ++i )
+  {
+    struct package   *package = (struct package *)ts->nodes[i].list->data;
+    struct tsort_key *key     = tsort_find_key( ts, package->pkginfo->group, package->pkginfo->name );
+
+    if( key && key->provider < 0 ) key->provider = i;
+
+    if( !ts->nodes[i].depended ) tsort_push( ts, i );
+  }
+}
+
+static void __tsort_free_key( void *data, void *user_data )
+{
+  struct tsort_key  *key  = (struct tsort_key *)data;
+  struct tsort_edge *edge = key->waiters;
+
+  while( edge )
+  {
+    struct tsort_edge *next = edge->next;
+    free( edge );
+    edge = next;
+  }
+  free( key );
+}
+
+static void __tsort_free_name( void *data, void *user_data )
+{
+  free( data );
+}
+
+static void tsort_free( struct tsort *ts )
+{
+  index_free( &ts->keys_index );
+  dlist_head_free( &ts->keys, __tsort_free_key );
+
+  index_free( &ts->names_index );
+  dlist_head_free( &ts->names, __tsort_free_name );
+
+  free( ts->nodes );
+  free( ts->queue );
+  free( ts->stack );
+}
+
+static void tsort_provide( struct tsort *ts, int node )
+{
+  struct tsort_node *n       = &ts->nodes[node];
+  struct package    *package = (struct package *)n->list->data;
+  struct tsort_key  *key     = NULL;
+  struct tsort_edge *edge    = NULL;
+  struct tsort_name *same    = NULL;
+  struct dlist      *found   = NULL;
+  struct pkginfo    *info    = NULL;
+  int                first   = 0;
+
+  first = !index_find( &provides_index, package->pkginfo->group, package->pkginfo->name, NULL, NULL );
+
+  /* packages with the same name are installed one after another: */
+  if( (found = index_find( &ts->names_index, NULL, package->pkginfo->name, NULL, NULL )) )
+  {
+    same = (struct tsort_name *)found->data;
+    if( n->level <= same->level ) n->level = same->level + 1;
+  }
+  else
+  {
+    same = (struct tsort_name *)malloc( sizeof(struct tsort_name) );
+    if( !same ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+    same->name = package->pkginfo->name;
+    index_insert( &ts->names_index, dlist_head_append( &ts->names, (void *)same ) );
+  }
+  same->level = n->level;
+
+  check_update( package );
+  package->level = n->level;
+  __provide_package( n->list );
+  n->list = NULL;
+
+  /* only the first provided package with the same key satisfies requires */
+  if( !first || !(key = tsort_find_key( ts, package->pkginfo->group, package->pkginfo->name )) ) return;
+
+  info = package->pkginfo;
+
+  for( edge = key->waiters; edge; edge = edge->next )
+  {
+    struct tsort_node *w = &ts->nodes[edge->node];
+
+    if( __cmp_versions( info->version, &info->version_key, edge->pkg->version, &edge->pkg->version_key ) >= 0 )
+    {
+      int pass = ( n->position < w->position ) ? n->pass : n->pass + 1;
+
+      if( w->pass < pass ) w->pass = pass;
+      if( w->level < n->level + 1 ) w->level = n->level + 1;
+      if( --w->depended == 0 ) tsort_push( ts, edge->node );
+    }
+  }
+}
+
+/* Returns the position of package which have to provide the required pkg or -1. */
+static int tsort_required( struct tsort *ts, struct pkg *pkg )
+{
+  struct tsort_key *key = NULL;
+
+  if( !pkg || check_extern_required( pkg ) ) return -1;
+  if( index_find( &provides_index, pkg->group, pkg->name, NULL, NULL ) ) return -1;
+
+  if( (key = tsort_find_key( ts, pkg->group, pkg->name )) ) return key->provider;
+  return -1;
+}
+
+static void __package_fullname( char *buf, size_t size, struct package *package )
+{
+  if( package->pkginfo->group )
+    (void)snprintf( buf, size, "%s/%s-%s", package->pkginfo->group,
+                                           package->pkginfo->name,
+                                           package->pkginfo->version );
+  else
+    (void)snprintf( buf, size, "%s-%s", package->pkginfo->name,
+                                        package->pkginfo->version );
+}
+
+static int __compare_positions( const void *a, const void *b )
+{
+  return *(const int *)a - *(const int *)b;
+}
+
+static void tsort_print_cycle( struct tsort *ts, int *members, int count )
+{
+  char *buf = NULL;
+  int   i;
+
+  buf = (char *)malloc( (size_t)PATH_MAX );
+  if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  if( count == 1 )
+  {
+    __package_fullname( buf, (size_t)PATH_MAX, (struct package *)ts->nodes[members[0]].list->data );
+    ERROR( "Package %s requires itself", buf );
+    free( buf );
+    return;
+  }
+
+  qsort( (void *)members, (size_t)count, sizeof(int), __compare_positions );
+
+  ERROR( "Circular dependencies between %d packages:", count );
+  for( i = 0; i < count; ++i )
+  {
+    __package_fullname( buf, (size_t)PATH_MAX, (struct package *)ts->nodes[members[i]].list->data );
+    fprintf( errlog, "    %s\n", buf );
+  }
+
+  free( buf );
+}
+
+static void tsort_strongconnect( struct tsort *ts, int node )
+{
+  struct tsort_node *n       = &ts->nodes[node];
+  struct package    *package = (struct package *)n->list->data;
+  struct dlist      *reqs    = package->requires->list;
+  int                loop    = 0;
+
+  n->index = n->lowlink = ++ts->index;
+  ts->stack[ts->sp++] = node;
+  n->on_stack = 1;
 
-  if( !strcmp( pkg1->pkginfo->name, pkg2->pkginfo->name ) )
+  while( reqs )
   {
-    if( pkg1->pkginfo->group && pkg2->pkginfo->group )
+    int required = tsort_required( ts, (struct pkg *)reqs->data );
+
+    reqs = dlist_next( reqs );
+
+    if( required < 0 || !ts->nodes[required].list ) continue;
+    if( required == node ) loop = 1;
+
+    if( !ts->nodes[required].index )
     {
-      ret = strcmp( pkg1->pkginfo->group, pkg2->pkginfo->group );
+      tsort_strongconnect( ts, required );
+      if( ts->nodes[required].lowlink < n->lowlink ) n->lowlink = ts->nodes[required].lowlink;
     }
-    else if( !pkg1->pkginfo->group && !pkg2->pkginfo->group )
+    else if( ts->nodes[required].on_stack )
     {
-      ret = 0;
+      if( ts->nodes[required].index < n->lowlink ) n->lowlink = ts->nodes[required].index;
     }
-    else if( pkg1->pkginfo->group )
+  }
+
+  if( n->lowlink == n->index )
+  {
+    int *members = &ts->stack[ts->sp], count = 0;
+
+    do
     {
-      ret = 1;
+      --members; ++count;
+      ts->nodes[*members].on_stack = 0;
     }
+    while( *members != node );
 
-    /* returns equal only if groups are not equal */
-    if( ret ) return 0;
-  }
+    ts->sp -= count;
 
-  return ret;
+    if( count > 1 || loop ) tsort_print_cycle( ts, members, count );
+  }
 }
 
-static int check_dependencies( struct package *package )
+static void tsort_print_unresolved( struct tsort *ts )
 {
-  struct dlist *list = NULL, *next = NULL, *update = NULL;
-  int    depended    = -1;
-
-  if( !package ) return depended;
-  depended = 0;
+  char *buf = NULL;
+  int   i;
 
-  if( !(list = package->requires->list) ) return depended;
+  buf = (char *)malloc( (size_t)PATH_MAX );
+  if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
 
-  while( list )
+  for( i = 0; i < ts->size; ++i )
   {
-    next = dlist_next( list );
+    struct package *package = NULL;
+    struct dlist   *reqs    = NULL;
+
+    if( !ts->nodes[i].list ) continue;
+
+    package = (struct package *)ts->nodes[i].list->data;
+
+    for( reqs = package->requires->list; reqs; reqs = dlist_next( reqs ) )
     {
-      int has_extern_dependencies = 0, already_provided = 0;
+      struct pkg     *pkg   = (struct pkg *)reqs->data;
+      struct dlist   *found = NULL;
+      struct pkginfo *info  = NULL;
 
-      struct pkg   *pkg   = (struct pkg *)list->data;
-      struct dlist *found = dlist_find_data( extern_requires, __compare_required, (const void *)pkg );
+      if( !pkg || check_extern_required( pkg ) ) continue;
 
-      if( found )
-      {
-        if( cmp_version( (const char *)((struct pkg *)found->data)->version, (const char *)pkg->version ) >= 0 )
-        {
-          /* required package is found in the extern_requires list */
-          has_extern_dependencies += 1;
-        }
-      }
+      found = index_find( &provides_index, pkg->group, pkg->name, NULL, NULL );
+      if( found ) info = ((struct package *)found->data)->pkginfo;
 
-      found = dlist_find_data( provides, __compare_provided, (const void *)pkg );
-      if( found )
+      if( info && __cmp_versions( info->version, &info->version_key, pkg->version, &pkg->version_key ) < 0 )
       {
-        if( cmp_version( (const char *)((struct package *)found->data)->pkginfo->version, (const char *)pkg->version ) >= 0 )
-        {
-          /* required package is found in the extern_requires list */
-          already_provided += 1;
-        }
+        __package_fullname( buf, (size_t)PATH_MAX, package );
+        if( pkg->group )
+          ERROR( "%s: required %s/%s=%s is not provided", buf, pkg->group, pkg->name, pkg->version );
+        else
+          ERROR( "%s: required %s=%s is not provided", buf, pkg->name, pkg->version );
       }
-
-      if( !already_provided && !has_extern_dependencies ) depended += 1;
     }
-    list = next;
   }
 
-  /* Check if the package with the same name already exists in the provides list */
-  update = dlist_find_data( provides, __compare_packages_by_name, (const void *)package );
-  if( update )
+  for( i = 0; i < ts->size; ++i )
   {
-    /* Set install procedure to UPDATE: */
-    package->procedure = UPDATE;
+    if( ts->nodes[i].list && !ts->nodes[i].index ) tsort_strongconnect( ts, i );
   }
 
-  return depended;
+  free( buf );
 }
-/*
-  End of Check REQUIRES functions.
- ***************************************************************/
 
-static void __fill_provides_list( void *data, void *user_data )
+/* Moves packages into provides list in order of installation. */
+static void sort_packages_list( void )
 {
-  struct package *package = (struct package *)data;
+  struct tsort ts;
+  int          unresolved = 0;
 
-  if( package )
+  tsort_init( &ts );
+
+  while( ts.queued )
   {
-    if( !check_dependencies( package ) )
-    {
-      /* move independed package to the provides list */
-      packages = dlist_remove( packages, (const void *)data );
-      provides = dlist_append( provides, (void *)package );
-    }
+    tsort_provide( &ts, tsort_pop( &ts ) );
+  }
+
+  if( (unresolved = dlist_head_length( &packages )) != 0 )
+  {
+    tsort_print_unresolved( &ts );
+  }
+
+  tsort_free( &ts );
+
+  if( unresolved )
+  {
+    FATAL_ERROR( "Cannot resolve dependencies of %d packages", unresolved );
   }
 }
+/*
+  End of Topological SORT functions.
+ ***************************************************************/
 
 
 static void __print_extern_package( void *data, void *user_data )
@@ -796,7 +2110,32 @@ static void __print_provided_package( void *data, void *user_data )
       fprintf( output, "%s:", tarball_suffix ); /* default is '.txz' */
     }
     fprintf( output, "%s:",  strproc( package->procedure ) );
-    fprintf( output, "%s\n", strprio( package->priority, 0 ) );
+    if( levels )
+    {
+      struct dlist *list = package->requires->list;
+      int           n    = 0;
+
+      fprintf( output, "%s:",  strprio( package->priority, 0 ) );
+      fprintf( output, "%d:",  package->level );
+
+      /* only requires which present in the list; extern requires are already installed: */
+      for( ; list; list = dlist_next( list ) )
+      {
+        struct pkg *pkg = (struct pkg *)list->data;
+
+        if( !pkg || !index_find( &provides_index, pkg->group, pkg->name, NULL, NULL ) ) continue;
+
+        if( n++ ) fprintf( output, "," );
+        if( pkg->group ) fprintf( output, "%s/", pkg->group );
+        fprintf( output, "%s", pkg->name );
+        if( pkg->version ) fprintf( output, "=%s", pkg->version );
+      }
+      fprintf( output, "\n" );
+    }
+    else
+    {
+      fprintf( output, "%s\n", strprio( package->priority, 0 ) );
+    }
   }
 }
 
@@ -808,15 +2147,18 @@ static void __reduce_packages_list( struct pkg *pkg )
 
   if( !pkg ) return;
 
-  found = dlist_find_data( packages, __compare_provided, (const void *)pkg );
+  found = index_find( &packages_index, pkg->group, pkg->name, NULL, NULL );
   if( found && found->data )
   {
     struct dlist *list = NULL, *next = NULL;
 
     package = (struct package *)found->data;
 
-    packages = dlist_remove( packages, (const void *)package );
-    provides = dlist_append( provides, (void *)package );
+    index_remove( &packages_index, found );
+    dlist_head_remove_link( &packages, found );
+    free( found );
+
+    (void)dlist_head_append( &provides_head, (void *)package );
 
     if( !(list = package->requires->list) ) return;
 
@@ -835,19 +2177,18 @@ static void reduce_packages_list( struct pkg *pkg )
 {
   __reduce_packages_list( pkg );
 
-  dlist_free( packages, __package_free_func );
-  if( dlist_length( provides ) != 0 )
-  {
-    packages = provides;
-    provides = NULL;
-  }
+  dlist_head_free( &packages, __package_free_func );
+  packages = provides_head;
+  dlist_head_init( &provides_head );
+
+  index_rebuild( &packages_index, dlist_head_first( &packages ) );
 }
 
 int create_provides_list( struct pkg *single_package )
 {
   int ret = 0;
 
-  if( !packages ) return ret;
+  if( !dlist_head_length( &packages ) ) return ret;
 
   if( single_package )
   {
@@ -858,33 +2199,36 @@ int create_provides_list( struct pkg *single_package )
   }
 
   /* Fill two lists: provides and extern_requires: */
-  dlist_foreach( packages, __fill_extern_requires, NULL );
+  dlist_head_foreach( &packages, __fill_extern_requires, NULL );
 
   /* Remove packages from extern_requires list which present in the provides list: */
-  dlist_foreach( provides, __clean_extern_requires, NULL );
+  dlist_head_foreach( &provides_head, __clean_extern_requires, NULL );
 
   /* Now we don't need previous contents of provides list: */
-  dlist_free( provides, __pkg_free_func );
-  provides = NULL;
+  dlist_head_free( &provides_head, __pkg_free_func );
 
   /* Remove old packages if required new version of them */
   remove_old_packages();
 
   /* move packages into provides list in order of installation: */
-  while( dlist_length( packages ) != 0 )
-  {
-    dlist_foreach( packages, __fill_provides_list, NULL );
-  }
+  sort_packages_list();
 
-  return dlist_length( extern_requires );
+  provides        = dlist_head_first( &provides_head );
+  extern_requires = dlist_head_first( &extern_requires_head );
+
+  return dlist_head_length( &extern_requires_head );
 }
 
 void free_provides_list( void )
 {
   if( hardware ) { free( hardware ); hardware = NULL; }
 
-  dlist_free( extern_requires, __pkg_free_func );
-  dlist_free( provides, __package_free_func );
+  index_free( &extern_requires_index );
+  index_free( &provides_index );
+  index_free( &provides_names_index );
+
+  dlist_head_free( &extern_requires_head, __pkg_free_func ); extern_requires = NULL;
+  dlist_head_free( &provides_head, __package_free_func );    provides        = NULL;
 }
 
 void print_provides_list( const char *plist_fname )
@@ -926,6 +2270,19 @@ void print_provides_list( const char *plist_fname )
   fprintf( plist, "#                    { OPTIONAL    | optional    | OPT | opt }\n" );
   fprintf( plist, "#                    { SKIP        | skip        | SKP | skp }\n" );
   fprintf( plist, "#\n" );
+  if( levels )
+  {
+    fprintf( plist, "# The optional seventh and eighth fields are used for parallel installation:\n" );
+    fprintf( plist, "#\n" );
+    fprintf( plist, "# pkgname:version:description:tarball:procedure:priority:level:requires\n" );
+    fprintf( plist, "#\n" );
+    fprintf( plist, "#   level       - all packages required by the package have lower levels,\n" );
+    fprintf( plist, "#                 so packages of the same level can be installed in parallel;\n" );
+    fprintf( plist, "#   requires    - comma separated list of packages {group/name=version | name=version}\n" );
+    fprintf( plist, "#                 which should be installed before the package; the version is\n" );
+    fprintf( plist, "#                 the least version required by the package.\n" );
+    fprintf( plist, "#\n" );
+  }
 
   if( extern_requires )
   {
@@ -945,8 +2302,8 @@ void print_provides_list( const char *plist_fname )
 
 struct _ctx
 {
-  FILE *output;
-  int   index, size, depth;
+  struct json *json;
+  int          index, size, depth;
 };
 
 /**************************
@@ -959,7 +2316,8 @@ static int   svg_width  = 2;
 static int   svg_height = 2;
 
 static char *json_pkgs_file = NULL;
-static char *json_tree_file = NULL;
+static char *json_tree_file = NULL; /* or index of chunks */
+static char *json_chunks_dir = NULL;
 
 static char *copying = "Radix cross Linux";
 
@@ -984,7 +2342,10 @@ static char *copying = "Radix cross Linux";
      расширение: '.pkgs.json', '.tree.json', '.tree.html';
 
    - если основное базовое имя файла начинается с точки, то расширение
-     заменяем на: 'pkgs.json', 'tree.json', 'tree.html'.
+     заменяем на: 'pkgs.json', 'tree.json', 'tree.html';
+
+   - с опцией --chunks вместо '.tree.json' создаются '.index.json' и
+     каталог '.chunks' с отдельными файлами для каждого пакета.
 */
 static void allocate_fnames( const char *json_fname )
 {
@@ -1013,6 +2374,10 @@ static void allocate_fnames( const char *json_fname )
 
       (void)sprintf( e, ".pkgs.min.json" ); pkgs_min_fname = strdup( (const char *)&buf[0] );
       (void)sprintf( e, ".tree.min.json" ); tree_min_fname = strdup( (const char *)&buf[0] );
+
+      (void)sprintf( e, ".index.json" );     index_fname     = strdup( (const char *)&buf[0] );
+      (void)sprintf( e, ".index.min.json" ); index_min_fname = strdup( (const char *)&buf[0] );
+      (void)sprintf( e, ".chunks" );         chunks_dname    = strdup( (const char *)&buf[0] );
     }
     else
     {
@@ -1022,6 +2387,10 @@ static void allocate_fnames( const char *json_fname )
 
       (void)sprintf( e, "pkgs.min.json" ); pkgs_min_fname = strdup( (const char *)&buf[0] );
       (void)sprintf( e, "tree.min.json" ); tree_min_fname = strdup( (const char *)&buf[0] );
+
+      (void)sprintf( e, "index.json" );     index_fname     = strdup( (const char *)&buf[0] );
+      (void)sprintf( e, "index.min.json" ); index_min_fname = strdup( (const char *)&buf[0] );
+      (void)sprintf( e, "chunks" );         chunks_dname    = strdup( (const char *)&buf[0] );
     }
   }
   else
@@ -1034,32 +2403,37 @@ static void allocate_fnames( const char *json_fname )
 
     (void)sprintf( e, ".pkgs.min.json" ); pkgs_min_fname = strdup( (const char *)&buf[0] );
     (void)sprintf( e, ".tree.min.json" ); tree_min_fname = strdup( (const char *)&buf[0] );
+
+    (void)sprintf( e, ".index.json" );     index_fname     = strdup( (const char *)&buf[0] );
+    (void)sprintf( e, ".index.min.json" ); index_min_fname = strdup( (const char *)&buf[0] );
+    (void)sprintf( e, ".chunks" );         chunks_dname    = strdup( (const char *)&buf[0] );
   }
 
   if( minimize )
   {
     json_pkgs_file = strdup( (const char *)basename( pkgs_min_fname ) );
-    json_tree_file = strdup( (const char *)basename( tree_min_fname ) );
+    json_tree_file = strdup( (const char *)basename( (chunks) ? index_min_fname : tree_min_fname ) );
   }
   else
   {
     json_pkgs_file = strdup( (const char *)basename( pkgs_fname ) );
-    json_tree_file = strdup( (const char *)basename( tree_fname ) );
+    json_tree_file = strdup( (const char *)basename( (chunks) ? index_fname : tree_fname ) );
   }
+  json_chunks_dir = strdup( (const char *)basename( chunks_dname ) );
 
   free( buf );
 }
 
 
 
-static struct package * find_package( struct dlist *list, struct pkg *pkg )
+static struct package * find_package( struct index *index, struct pkg *pkg )
 {
   struct package *package = NULL;
   struct dlist   *found   = NULL;
 
   if( !pkg ) return package;
 
-  found = dlist_find_data( list, __compare_provided, (const void *)pkg );
+  found = index_find( index, pkg->group, pkg->name, NULL, NULL );
   if( found )
   {
     return (struct package *)found->data;
@@ -1068,399 +2442,792 @@ static struct package * find_package( struct dlist *list, struct pkg *pkg )
   return package;
 }
 
-void print_package_data( FILE *output, struct package *package )
+void print_package_data( struct json *json, struct package *package )
 {
-  if( !output || !package ) return;
+  if( !json || !package ) return;
 
   /* "id": "net:bind-9.10.1", */
+  json_text( json, "  \"id\": " );
   if( package->pkginfo->group ) {
-    fprintf( output, "  \"id\": \"%s:%s-%s\",\n", package->pkginfo->group,
-                                                  package->pkginfo->name,
-                                                  package->pkginfo->version );
+    json_stringf( json, "%s:%s-%s", package->pkginfo->group,
+                                    package->pkginfo->name,
+                                    package->pkginfo->version );
   } else {
-    fprintf( output, "  \"id\": \"%s-%s\",\n", package->pkginfo->name,
-                                               package->pkginfo->version );
+    json_stringf( json, "%s-%s", package->pkginfo->name,
+                                 package->pkginfo->version );
   }
   /* "name": "bind", */
-  fprintf( output, "  \"name\": \"%s\",\n", package->pkginfo->name );
+  json_text( json, ",\n  \"name\": " );
+  json_string( json, package->pkginfo->name );
   /* "version": "9.10.1", */
-  fprintf( output, "  \"version\": \"%s\",\n", package->pkginfo->version );
+  json_text( json, ",\n  \"version\": " );
+  json_string( json, package->pkginfo->version );
   /* "group": "net", */
-  if( package->pkginfo->group ) {
-    fprintf( output, "  \"group\": \"%s\",\n", package->pkginfo->group );
-  } else {
-    fprintf( output, "  \"group\": \"\",\n" );
-  }
+  json_text( json, ",\n  \"group\": " );
+  json_string( json, package->pkginfo->group );
   /* "arch": "omap543x-eglibc", */
-  fprintf( output, "  \"arch\": \"%s\",\n", package->pkginfo->arch );
+  json_text( json, ",\n  \"arch\": " );
+  json_string( json, package->pkginfo->arch );
   /* "hardware": "omap5uevm", */
-  fprintf( output, "  \"hardware\": \"%s\",\n", hardware );
+  json_text( json, ",\n  \"hardware\": " );
+  json_string( json, hardware );
   /* "license": "custom", */
-  fprintf( output, "  \"license\": \"%s\",\n", package->pkginfo->license );
+  json_text( json, ",\n  \"license\": " );
+  json_string( json, package->pkginfo->license );
   /* "description": "bind 9.10.1 (DNS server and utilities)", */
-  fprintf( output, "  \"description\": \"%s %s (%s)\",\n", package->pkginfo->name,
-                                                           package->pkginfo->version,
-                                                           package->pkginfo->short_description );
+  json_text( json, ",\n  \"description\": " );
+  json_stringf( json, "%s %s (%s)", package->pkginfo->name,
+                                    package->pkginfo->version,
+                                    package->pkginfo->short_description );
   /* "uncompressed_size": "17M", */
-  fprintf( output, "  \"uncompressed_size\": \"" );
+  json_text( json, ",\n  \"uncompressed_size\": " );
   if( package->pkginfo->uncompressed_size > 1048576 ) {
-    fprintf( output, "%ldG\",\n", package->pkginfo->uncompressed_size / 1048576 );
+    json_stringf( json, "%ldG", package->pkginfo->uncompressed_size / 1048576 );
   } else if( package->pkginfo->uncompressed_size > 1024 ) {
-    fprintf( output, "%ldM\",\n", package->pkginfo->uncompressed_size / 1024 );
+    json_stringf( json, "%ldM", package->pkginfo->uncompressed_size / 1024 );
   } else {
-    fprintf( output, "%ldK\",\n", package->pkginfo->uncompressed_size );
+    json_stringf( json, "%ldK", package->pkginfo->uncompressed_size );
   }
   /* "total_files": "421" */
-  fprintf( output, "  \"total_files\": \"%d\"\n", package->pkginfo->total_files );
+  json_text( json, ",\n  \"total_files\": " );
+  json_stringf( json, "%d", package->pkginfo->total_files );
+}
+
+static void __print_pkgs_node( void *data, void *user_data )
+{
+  struct package *package = (struct package *)data;
+  struct _ctx    *ctx     = (struct _ctx *)user_data;
+
+  if( !package || !ctx ) return;
+
+  if( ctx->index != 0 )
+  {
+    json_text( ctx->json, " },\n {\n" );
+  }
+  print_package_data( ctx->json, package );
+  json_text( ctx->json, "\n" );
+  ++ctx->index;
+}
+
+static void print_pkgs_json( struct json *json, struct dlist *list )
+{
+  struct _ctx ctx;
+
+  if( !json ) return;
+
+  bzero( (void *)&ctx, sizeof(struct _ctx) );
+
+  ctx.json  = json;
+  ctx.index = 0;
+
+  json_text( json, "[{\n" );
+
+  dlist_foreach( list, __print_pkgs_node, (void *)&ctx );
+
+  json_text( json, " }]\n" );
+}
+
+static void __remove_required_package( void *data, void *user_data )
+{
+  struct pkg *pkg = (struct pkg *)data;
+
+  if( pkg )
+  {
+    struct dlist *found = index_find( &tree_index, pkg->group, pkg->name, NULL, NULL );
+    if( found )
+    {
+      /*******************************************
+        if package reqired for some other package
+        we have to remove it from tree list:
+       */
+      index_remove( &tree_index, found );
+      tree = __dlist_remove_link( tree, found );
+      free( found );
+    }
+  }
+}
+
+static void __remove_required_packages( void *data, void *user_data )
+{
+  struct package *package = (struct package *)data;
+  struct dlist   *list = NULL;
+
+  if( !package ) return;
+
+  if( !(list = package->requires->list) ) return;
+
+  dlist_foreach( list, __remove_required_package, NULL );
+}
+
+static void remove_required_packages( struct dlist *list )
+{
+  dlist_foreach( list, __remove_required_packages, NULL );
+}
+
+
+static void __check_pkg_requires( void *data, void *user_data )
+{
+  struct pkg *pkg     = (struct pkg *)data;
+  int        *counter = (int *)user_data;
+
+  if( pkg )
+  {
+    struct package *package = find_package( &provides_index, pkg );
+    if( package ) { ++(*counter); }
+  }
+}
+
+static int check_pkg_requires( struct dlist *list )
+{
+  int cnt = 0;
+  dlist_foreach( list, __check_pkg_requires, (void *)&cnt );
+  return cnt;
+}
+
+
+static void print_pkg_tree( struct _ctx *ctx, struct dlist *list );
+
+static void print_tree_node( struct _ctx *ctx, const char *group, const char *name, const char *version, struct dlist *reqs )
+{
+  struct json *json = ctx->json;
+
+  json_indent( json, ctx->depth );
+  json_text( json, "{\n" );
+
+  json_indent( json, ctx->depth + 1 );
+  json_text( json, "\"name\": " );
+  if( group )
+    json_stringf( json, "%s:%s-%s", group, name, version );
+  else
+    json_stringf( json, "%s-%s", name, version );
+
+  if( reqs && check_pkg_requires( reqs ) > 0 )
+  {
+    json_text( json, ",\n" );
+
+    json_indent( json, ctx->depth + 1 );
+    json_text( json, "\"children\": [\n" );
+
+    print_pkg_tree( ctx, reqs );
+
+    json_indent( json, ctx->depth + 1 );
+    json_text( json, "]\n" );
+  }
+  else
+  {
+    json_text( json, "\n" );
+  }
+
+  json_indent( json, ctx->depth );
+  json_text( json, "}" );
+}
+
+static void print_pkg_tree( struct _ctx *ctx, struct dlist *list )
+{
+  int count = 0;
+
+  if( !ctx || !list ) return;
+
+  ctx->depth += 2;
+  svg_width = max( svg_width, ctx->depth );
+
+  while( list )
+  {
+    struct pkg     *pkg     = (struct pkg *)list->data;
+    struct package *package = find_package( &provides_index, pkg );
+
+    if( package )
+    {
+      if( count++ ) { json_text( ctx->json, ",\n" ); }
+
+      print_tree_node( ctx, pkg->group, pkg->name, pkg->version, package->requires->list );
+    }
+    list = dlist_next( list );
+  }
+  if( count ) { json_text( ctx->json, "\n" ); }
+
+  ctx->depth -= 2;
+}
+
+static void print_package_node( struct _ctx *ctx, struct package *package )
+{
+  if( !package || !ctx ) return;
+
+  print_tree_node( ctx, package->pkginfo->group,
+                        package->pkginfo->name,
+                        package->pkginfo->version, package->requires->list );
+}
+
+static void print_tree_distro( struct json *json, struct package *package )
+{
+  json_text( json, " \"distro\": [ " );
+  json_string( json, package->pkginfo->distro_name );
+  json_text( json, ", " );
+  json_string( json, package->pkginfo->distro_version );
+  json_text( json, ", " );
+  json_string( json, package->pkginfo->url );
+  json_text( json, " ],\n" );
 }
 
-static void __print_pkgs_node( void *data, void *user_data )
-{
-  struct package *package = (struct package *)data;
-  struct _ctx    *ctx     = (struct _ctx *)user_data;
+static void __print_tree_node( void *data, void *user_data )
+{
+  struct package *package = (struct package *)data;
+  struct _ctx    *ctx     = (struct _ctx *)user_data;
+
+  if( !package || !ctx ) return;
+
+  if( ctx->size > 1 )
+  {
+    if( ctx->index == 0 )
+    {
+      char *buf = NULL;
+
+      buf = (char *)malloc( (size_t)PATH_MAX );
+      if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+      bzero( (void *)buf, PATH_MAX );
+
+      (void)sprintf( &buf[0], "%s", hardware );
+      root = strdup( (const char *)&buf[0] );
+      (void)sprintf( &buf[0], "%s", package->pkginfo->url );
+      bug_url = strdup( (const char *)&buf[0] );
+      free( buf );
+
+      print_tree_distro( ctx->json, package );
+      json_text( ctx->json, " \"name\": " );
+      json_string( ctx->json, hardware );
+      json_text( ctx->json, ",\n \"children\": [\n" );
+    }
+
+
+    print_package_node( ctx, package );
+    svg_height += 2;
+
+
+    if( ctx->index < ctx->size - 1 ) json_text( ctx->json, "," );
+    else                             json_text( ctx->json, "\n ]" );
+
+    json_text( ctx->json, "\n" );
+  }
+  else
+  {
+    struct dlist *reqs = NULL;
+    char *buf = NULL;
+
+    buf = (char *)malloc( (size_t)PATH_MAX );
+    if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+    bzero( (void *)buf, PATH_MAX );
+
+    if( package->pkginfo->group )
+      (void)sprintf( &buf[0], "%s/%s-%s", package->pkginfo->group,
+                                          package->pkginfo->name,
+                                          package->pkginfo->version );
+    else
+      (void)sprintf( &buf[0], "%s-%s", package->pkginfo->name,
+                                       package->pkginfo->version );
+
+    root = strdup( (const char *)&buf[0] );
+    (void)sprintf( &buf[0], "%s", package->pkginfo->url );
+    bug_url = strdup( (const char *)&buf[0] );
+    free( buf );
+
+    print_tree_distro( ctx->json, package );
+    json_text( ctx->json, " \"name\": " );
+    if( package->pkginfo->group )
+      json_stringf( ctx->json, "%s:%s-%s", package->pkginfo->group,
+                                           package->pkginfo->name,
+                                           package->pkginfo->version );
+    else
+      json_stringf( ctx->json, "%s-%s", package->pkginfo->name,
+                                        package->pkginfo->version );
+
 
-  if( !package || !ctx ) return;
+    svg_height += 2;
+    ctx->depth  -=2;
+
+    if( (reqs = package->requires->list) && check_pkg_requires( reqs ) > 0 )
+    {
+      json_text( ctx->json, ",\n" );
+
+      json_text( ctx->json, " \"children\": [\n" );
+
+      print_pkg_tree( ctx, reqs );
+
+      json_text( ctx->json, " ]\n" );
+    }
 
-  if( ctx->index != 0 )
-  {
-    fprintf( ctx->output, " },\n {\n" );
   }
-  print_package_data( ctx->output, package );
+
   ++ctx->index;
 }
 
-static void print_pkgs_json( FILE *output, struct dlist *list )
+static void print_tree_json( struct json *json, struct dlist *list )
 {
   struct _ctx ctx;
 
-  if( !output ) return;
+  if( !json || !list ) return;
 
   bzero( (void *)&ctx, sizeof(struct _ctx) );
 
-  ctx.output = output;
+  ctx.json   = json;
   ctx.index  = 0;
+  ctx.size   = dlist_length( list );
+  ctx.depth  = 2;
 
-  fprintf( output, "[{\n" );
+  json_text( json, "{\n" );
+  dlist_foreach( list, __print_tree_node, (void *)&ctx );
+  json_text( json, "}\n" );
 
-  dlist_foreach( list, __print_pkgs_node, (void *)&ctx );
+  svg_height += svg_width / 2;
 
-  fprintf( output, " }]\n" );
+  svg_width  = (svg_width  + 4) * 160;
+  svg_height = (svg_height + 4) * 24;
 }
 
-static void __remove_required_package( void *data, void *user_data )
+/*********************************************************
+  The REQUIRES GRAPH is the compact form of REQUIRES TREE:
+  every package is printed once in the "nodes" array with
+  indexes of its requires, and "children" holds indexes of
+  root packages. The size of output is linear in the number
+  of requires while the tree expansion grows exponentially
+  with depth of DAG. HTML viewer builds the tree on demand.
+ */
+struct graph_node
 {
-  struct package *package = NULL;
-  struct pkg     *pkg = (struct pkg *)data;
-
-  if( pkg )
-  {
-    package = find_package( tree, pkg );
-    if( package )
-    {
-      /*******************************************
-        if package reqired for some other package
-        we have to remove it from tree list:
-       */
-      tree = dlist_remove( tree, (const void *)package );
-    }
-  }
-}
+  struct package *package;
+  int             height;  /* number of levels in the subtree */
+};
 
-static void __remove_required_packages( void *data, void *user_data )
+struct graph
 {
-  struct package *package = (struct package *)data;
-  struct dlist   *list = NULL;
+  struct graph_node *nodes;
+  int                size;
 
-  if( !package ) return;
+  struct dlist_head  list;
+  struct index       index;
+};
 
-  if( !(list = package->requires->list) ) return;
+static void __graph_key( const void *data, const char **group, const char **name )
+{
+  const struct graph_node *node = (const struct graph_node *)data;
 
-  dlist_foreach( list, __remove_required_package, NULL );
+  *group = node->package->pkginfo->group;
+  *name  = node->package->pkginfo->name;
 }
 
-static void remove_required_packages( struct dlist *list )
+static int graph_find_node( struct graph *gr, const char *group, const char *name )
 {
-  dlist_foreach( list, __remove_required_packages, NULL );
-}
+  struct dlist *found = index_find( &gr->index, group, name, NULL, NULL );
 
+  if( found ) return (int)((struct graph_node *)found->data - gr->nodes);
+  return -1;
+}
 
-static void __check_pkg_requires( void *data, void *user_data )
+static void graph_init( struct graph *gr, struct dlist *list )
 {
-  struct pkg *pkg     = (struct pkg *)data;
-  int        *counter = (int *)user_data;
+  int i;
 
-  if( pkg )
+  bzero( (void *)gr, sizeof(struct graph) );
+  index_init( &gr->index, __graph_key );
+
+  gr->size  = dlist_length( list );
+  gr->nodes = (struct graph_node *)calloc( (size_t)gr->size + 1, sizeof(struct graph_node) );
+  if( !gr->nodes ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  for( i = 0; list; ++i, list = dlist_next( list ) )
   {
-    struct package *package = find_package( provides, pkg );
-    if( package ) { ++(*counter); }
+    gr->nodes[i].package = (struct package *)list->data;
+    index_insert( &gr->index, dlist_head_append( &gr->list, (void *)&gr->nodes[i] ) );
+  }
+
+  /*********************************************************
+    The list is in reverse installation order, so requires
+    of the node have greater indexes and are counted first:
+   */
+  for( i = gr->size - 1; i >= 0; --i )
+  {
+    struct dlist *reqs = gr->nodes[i].package->requires->list;
+    int height = 0;
+
+    while( reqs )
+    {
+      struct pkg *pkg = (struct pkg *)reqs->data;
+      int node = graph_find_node( gr, pkg->group, pkg->name );
+
+      if( node >= 0 ) height = max( height, gr->nodes[node].height );
+      reqs = dlist_next( reqs );
+    }
+    gr->nodes[i].height = height + 1;
   }
 }
 
-static int check_pkg_requires( struct dlist *list )
+static void graph_free( struct graph *gr )
 {
-  int cnt = 0;
-  dlist_foreach( list, __check_pkg_requires, (void *)&cnt );
-  return cnt;
+  index_free( &gr->index );
+  dlist_head_free( &gr->list, NULL );
+
+  free( gr->nodes );
 }
 
+static void graph_print_requires( struct graph *gr, struct json *json, struct dlist *reqs )
+{
+  int count = 0;
 
-static void print_pkg_tree( struct _ctx *ctx, struct dlist *list )
+  while( reqs )
+  {
+    struct pkg *pkg = (struct pkg *)reqs->data;
+    int node = graph_find_node( gr, pkg->group, pkg->name );
+
+    if( node >= 0 )
+    {
+      if( count++ ) { json_text( json, ", " ); }
+      json_printf( json, "%d", node );
+    }
+    reqs = dlist_next( reqs );
+  }
+}
+
+/* Prints the head of REQUIRES GRAPH (or INDEX) and sets root, bug_url: */
+static void graph_print_head( struct json *json, struct dlist *list )
 {
-  struct dlist *next = NULL;
+  struct package *package = NULL;
+  char           *buf = NULL;
+  int             size;
 
-  if( !ctx || !list ) return;
+  buf = (char *)malloc( (size_t)PATH_MAX );
+  if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  bzero( (void *)buf, PATH_MAX );
 
-  ctx->depth += 2;
-  svg_width = max( svg_width, ctx->depth );
+  package = (struct package *)list->data;
+  size    = dlist_length( list );
 
-  while( list )
-  {
-    next = dlist_next( list );
-    {
-      struct pkg     *pkg     = (struct pkg *)list->data;
-      struct package *package = find_package( provides, pkg );
+  if( size > 1 )
+    (void)sprintf( &buf[0], "%s", hardware );
+  else if( package->pkginfo->group )
+    (void)sprintf( &buf[0], "%s/%s-%s", package->pkginfo->group,
+                                        package->pkginfo->name,
+                                        package->pkginfo->version );
+  else
+    (void)sprintf( &buf[0], "%s-%s", package->pkginfo->name,
+                                     package->pkginfo->version );
+  root = strdup( (const char *)&buf[0] );
+  (void)sprintf( &buf[0], "%s", package->pkginfo->url );
+  bug_url = strdup( (const char *)&buf[0] );
+  free( buf );
 
-      if( package )
-      {
-        char *p, *buf = NULL;
-        int   depth = 0;
+  json_text( json, "{\n" );
+  print_tree_distro( json, package );
+  json_text( json, " \"name\": " );
+  if( size > 1 )
+    json_string( json, hardware );
+  else if( package->pkginfo->group )
+    json_stringf( json, "%s:%s-%s", package->pkginfo->group,
+                                    package->pkginfo->name,
+                                    package->pkginfo->version );
+  else
+    json_stringf( json, "%s-%s", package->pkginfo->name,
+                                 package->pkginfo->version );
+}
 
-        struct dlist *reqs = NULL;
+/* Prints indexes of root nodes and calculates the size of SVG: */
+static void graph_print_children( struct graph *gr, struct json *json, struct dlist *list )
+{
+  struct package *package = (struct package *)list->data;
+  int             count = 0;
 
-        buf = (char *)malloc( (size_t)PATH_MAX );
-        if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
-        bzero( (void *)buf, PATH_MAX );
+  json_text( json, " \"children\": [ " );
+  if( dlist_length( list ) > 1 )
+  {
+    while( list )
+    {
+      struct pkginfo *info = ((struct package *)list->data)->pkginfo;
+      int node = graph_find_node( gr, info->group, info->name );
 
-        buf[0] = ' ';
-        buf[1] = '\0';
+      if( node >= 0 )
+      {
+        if( count++ ) { json_text( json, ", " ); }
+        json_printf( json, "%d", node );
 
-        p = (char *)&buf[1];
-        depth = ctx->depth;
+        svg_width   = max( svg_width, 2 * gr->nodes[node].height );
+        svg_height += 2;
+      }
+      list = dlist_next( list );
+    }
+  }
+  else
+  {
+    int node = graph_find_node( gr, package->pkginfo->group, package->pkginfo->name );
 
-        while( depth ) { (void)sprintf( p, " " ); --depth; ++p; *p = '\0'; }
+    graph_print_requires( gr, json, package->requires->list );
 
-        (void)sprintf( p - 1, "{\n" );
-        fprintf( ctx->output, (char *)&buf[0] );
-        *(p - 1) = ' '; *p = '\0';
+    if( node >= 0 ) svg_width = max( svg_width, 2 * (gr->nodes[node].height - 1) );
+    svg_height += 2;
+  }
+  json_text( json, " ]\n" );
+  json_text( json, "}\n" );
 
-        if( pkg->group )
-          (void)sprintf( p, "\"name\": \"%s:%s-%s\"", pkg->group,
-                                                      pkg->name,
-                                                      pkg->version );
-        else
-          (void)sprintf( p, "\"name\": \"%s-%s\"", pkg->name,
-                                                   pkg->version );
+  svg_height += svg_width / 2;
 
-        fprintf( ctx->output, (char *)&buf[0] );
+  svg_width  = (svg_width  + 4) * 160;
+  svg_height = (svg_height + 4) * 24;
+}
 
-        if( (reqs = package->requires->list) && check_pkg_requires( reqs ) > 0 )
-        {
-          fprintf( ctx->output, ",\n" );
+static void print_graph_json( struct json *json, struct dlist *list )
+{
+  struct graph gr;
+  int          i;
 
-          (void)sprintf( p, "\"children\": [\n" );
-          fprintf( ctx->output, (char *)&buf[0] );
+  if( !json || !list ) return;
 
-          print_pkg_tree( ctx, reqs );
+  graph_init( &gr, provides );
 
-          (void)sprintf( p, "]\n" );
-          fprintf( ctx->output, (char *)&buf[0] );
-        }
-        else
-        {
-          fprintf( ctx->output, "\n" );
-        }
+  graph_print_head( json, list );
 
-        (void)sprintf( p - 1, "}" );
-        fprintf( ctx->output, (char *)&buf[0] );
-        *(p - 1) = ' '; *p = '\0';
+  json_text( json, ",\n \"nodes\": [\n" );
+  for( i = 0; i < gr.size; ++i )
+  {
+    struct pkginfo *info = gr.nodes[i].package->pkginfo;
 
-        if( next ) { fprintf( ctx->output, ",\n" ); }
-        else       { fprintf( ctx->output, "\n" );  }
+    json_text( json, "  { \"name\": " );
+    if( info->group )
+      json_stringf( json, "%s:%s-%s", info->group, info->name, info->version );
+    else
+      json_stringf( json, "%s-%s", info->name, info->version );
 
-        free( buf );
-      } /* End if( package )  */
+    if( gr.nodes[i].height > 1 )
+    {
+      json_text( json, ", \"requires\": [ " );
+      graph_print_requires( &gr, json, gr.nodes[i].package->requires->list );
+      json_text( json, " ]" );
     }
-    list = next;
-  } /* End of while( list ) */
+    json_text( json, (i < gr.size - 1) ? " },\n" : " }\n" );
+  }
+  json_text( json, " ],\n" );
 
-  ctx->depth -= 2;
+  graph_print_children( &gr, json, list );
+
+  graph_free( &gr );
 }
 
-static void print_package_node( struct _ctx *ctx, struct package *package )
+/*********************************************************
+  The CHUNKS are the REQUIRES GRAPH split for lazy loading
+  by HTML viewer: the small INDEX holds names of packages,
+  indexes of their requires and indexes of root nodes, so
+  the tree is built from INDEX only. The details of package
+  with index N (description and file list) are placed into
+  the separate 'N.json' file of the chunks directory.
+ */
+static void print_description_text( struct json *json, struct package *package )
 {
-  char *p, *buf = NULL;
-  int   depth = 0;
-
-  struct dlist *list = NULL;
+  const char *desc = package_description( package );
+  const char *name = package->pkginfo->name;
+  size_t      plen = strlen( name );
+  char       *buf, *p;
 
-  if( !package || !ctx ) return;
+  if( !desc ) { json_string( json, NULL ); return; }
 
-  buf = (char *)malloc( (size_t)PATH_MAX );
+  buf = (char *)malloc( strlen( desc ) + 1 );
   if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
-  bzero( (void *)buf, PATH_MAX );
 
-  buf[0] = ' ';
-  buf[1] = '\0';
+  /* remove the 'pkgname:' prefixes of lines: */
+  for( p = buf; *desc; )
+  {
+    const char *eol = index( desc, '\n' );
+    size_t      len = eol ? (size_t)(eol - desc) : strlen( desc );
 
-  p = (char *)&buf[1];
-  depth = ctx->depth;
+    if( len > plen && !strncmp( desc, name, plen ) && desc[plen] == ':' )
+    {
+      desc += plen + 1; len -= plen + 1;
+      if( len && *desc == ' ' ) { ++desc; --len; }
+    }
+    memcpy( (void *)p, (const void *)desc, len ); p += len;
+    *p++ = '\n';
 
-  while( depth ) { (void)sprintf( p, " " ); --depth; ++p; *p = '\0'; }
+    desc += len; if( *desc ) ++desc;
+  }
+  while( p > buf && *(p - 1) == '\n' ) --p;
+  *p = '\0';
 
-  (void)sprintf( p - 1, "{\n" );
-  fprintf( ctx->output, (char *)&buf[0] );
-  *(p - 1) = ' '; *p = '\0';
+  json_string( json, buf );
+  free( buf );
+}
 
-  if( package->pkginfo->group )
-    (void)sprintf( p, "\"name\": \"%s:%s-%s\"", package->pkginfo->group,
-                                                package->pkginfo->name,
-                                                package->pkginfo->version );
-  else
-    (void)sprintf( p, "\"name\": \"%s-%s\"", package->pkginfo->name,
-                                             package->pkginfo->version );
+static void __print_file_name( struct json *json, const char *fname, int *count )
+{
+  json_text( json, (*count)++ ? ",\n" : "\n" );
+  json_indent( json, 3 );
+  json_string( json, fname );
+}
 
-  fprintf( ctx->output, (char *)&buf[0] );
+/*
+  The FILE LIST is read from PKGLOG into temporary buffer and is not
+  loaded into the model: the files of all packages would stay in the
+  arena up to the end of the program.
+ */
+static void print_files_text( struct json *json, struct package *package )
+{
+  struct dlist *list = NULL;
+  char         *text = NULL, *p, *eol;
+  int           count = 0;
 
-  if( (list = package->requires->list) && check_pkg_requires( list ) > 0 )
+  if( (text = __read_section( package, SECTION_FILE_LIST )) )
   {
-    fprintf( ctx->output, ",\n" );
-
-    (void)sprintf( p, "\"children\": [\n" );
-    fprintf( ctx->output, (char *)&buf[0] );
-
-    print_pkg_tree( ctx, list );
+    for( p = text; *p; p = eol )
+    {
+      if( (eol = index( p, '\n' )) ) *eol++ = '\0';
+      else                           eol = p + strlen( p );
 
-    (void)sprintf( p, "]\n" );
-    fprintf( ctx->output, (char *)&buf[0] );
+      skip_eol_spaces( p );
+      __print_file_name( json, (const char *)p, &count );
+    }
+    free( text );
   }
   else
   {
-    fprintf( ctx->output, "\n" );
+    /* the section is loaded already: */
+    if( package->files ) list = dlist_head_first( &package->files->list );
+    while( list )
+    {
+      __print_file_name( json, (const char *)list->data, &count );
+      list = dlist_next( list );
+    }
   }
 
-  (void)sprintf( p - 1, "}" );
-  fprintf( ctx->output, (char *)&buf[0] );
-  *(p - 1) = ' '; *p = '\0';
-
-  free( buf );
+  if( count ) { json_text( json, "\n" ); json_indent( json, 2 ); }
 }
 
-static void __print_tree_node( void *data, void *user_data )
+static void print_package_chunk( struct graph *gr, int node, const char *fname )
 {
-  struct package *package = (struct package *)data;
-  struct _ctx    *ctx     = (struct _ctx *)user_data;
-
-  if( !package || !ctx ) return;
-
-  if( ctx->size > 1 )
-  {
-    if( ctx->index == 0 )
-    {
-      char *buf = NULL;
+  struct package *package = gr->nodes[node].package;
+  struct json     json;
+  FILE           *fp;
 
-      buf = (char *)malloc( (size_t)PATH_MAX );
-      if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
-      bzero( (void *)buf, PATH_MAX );
+  fp = fopen( fname, "w" );
+  if( !fp ) { FATAL_ERROR( "Cannot create %s file", fname ); }
 
-      (void)sprintf( &buf[0], "%s", hardware );
-      root = strdup( (const char *)&buf[0] );
-      (void)sprintf( &buf[0], "%s", package->pkginfo->url );
-      bug_url = strdup( (const char *)&buf[0] );
-      free( buf );
+  /* with --minimize option chunks are created in compact form only: */
+  if( minimize )
+    json_init( &json, NULL, fp );
+  else
+    json_init( &json, fp, NULL );
 
-      fprintf( ctx->output, " \"distro\": [ \"%s\", \"%s\", \"%s\" ],\n",
-                                              package->pkginfo->distro_name,
-                                                      package->pkginfo->distro_version,
-                                                               package->pkginfo->url );
-      fprintf( ctx->output, " \"name\": \"%s\",\n", hardware );
-      fprintf( ctx->output, " \"children\": [\n" );
-    }
+  json_text( &json, "{\n" );
+  print_package_data( &json, package );
 
+  json_text( &json, ",\n  \"package_description\": " );
+  print_description_text( &json, package );
 
-    print_package_node( ctx, package );
-    svg_height += 2;
+  json_text( &json, ",\n  \"files\": [" );
+  print_files_text( &json, package );
+  json_text( &json, "]\n}\n" );
+  json_free( &json );
 
+  fflush( fp ); fclose( fp );
+}
 
-    if( ctx->index < ctx->size - 1 ) fprintf( ctx->output, "," );
-    else                             fprintf( ctx->output, "\n ]" );
+/* Returns 1 if NAME is the name of chunk file 'N.json': */
+static int __chunk_name( const char *name )
+{
+  const char *p = name;
 
-    fprintf( ctx->output, "\n" );
-  }
-  else
-  {
-    struct dlist *reqs = NULL;
-    char *buf = NULL;
+  while( isdigit( (unsigned char)*p ) ) ++p;
 
-    buf = (char *)malloc( (size_t)PATH_MAX );
-    if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
-    bzero( (void *)buf, PATH_MAX );
+  return ( p != name && !strcmp( p, ".json" ) );
+}
 
-    if( package->pkginfo->group )
-      (void)sprintf( &buf[0], "%s/%s-%s", package->pkginfo->group,
-                                          package->pkginfo->name,
-                                          package->pkginfo->version );
-    else
-      (void)sprintf( &buf[0], "%s-%s", package->pkginfo->name,
-                                       package->pkginfo->version );
+/*
+  Removes the chunks of previous run from existing chunks directory:
+  the new INDEX may have fewer packages and the stale 'N.json' files
+  should not be left. Other entries are not touched. FNAME is a
+  PATH_MAX buffer for file names.
+ */
+static void clean_chunks_dir( char *fname )
+{
+  DIR           *dir;
+  struct dirent *entry;
+  struct stat    st;
 
-    root = strdup( (const char *)&buf[0] );
-    (void)sprintf( &buf[0], "%s", package->pkginfo->url );
-    bug_url = strdup( (const char *)&buf[0] );
-    free( buf );
+  if( !(dir = opendir( chunks_dname )) )
+  {
+    FATAL_ERROR( "Cannot open %s directory", basename( chunks_dname ) );
+  }
 
-    fprintf( ctx->output, " \"distro\": [ \"%s\", \"%s\", \"%s\" ],\n",
-                                            package->pkginfo->distro_name,
-                                                    package->pkginfo->distro_version,
-                                                             package->pkginfo->url );
-    if( package->pkginfo->group )
-      fprintf( ctx->output, " \"name\": \"%s:%s-%s\"", package->pkginfo->group,
-                                                       package->pkginfo->name,
-                                                       package->pkginfo->version );
-    else
-      fprintf( ctx->output, " \"name\": \"%s-%s\"", package->pkginfo->name,
-                                                    package->pkginfo->version );
+  while( (entry = readdir( dir )) )
+  {
+    if( !strcmp( entry->d_name, "." ) || !strcmp( entry->d_name, ".." ) ) continue;
 
+    (void)snprintf( fname, (size_t)PATH_MAX, "%s/%s", chunks_dname, entry->d_name );
 
-    svg_height += 2;
-    ctx->depth  -=2;
+    if( !__chunk_name( (const char *)entry->d_name ) ||
+        lstat( (const char *)fname, &st ) < 0 || !S_ISREG(st.st_mode) )
+    {
+      WARNING( "%s: is not a chunk file; skipped", fname );
+      continue;
+    }
 
-    if( (reqs = package->requires->list) && check_pkg_requires( reqs ) > 0 )
+    if( unlink( fname ) < 0 && errno != ENOENT )
     {
-      fprintf( ctx->output, ",\n" );
+      FATAL_ERROR( "Cannot remove %s file", fname );
+    }
+  }
+
+  closedir( dir );
+}
 
-      fprintf( ctx->output, " \"children\": [\n" );
+static void print_chunks_json( struct json *json, struct dlist *list )
+{
+  struct graph gr;
+  char        *fname = NULL;
+  int          i;
 
-      print_pkg_tree( ctx, reqs );
+  if( !json || !list ) return;
 
-      fprintf( ctx->output, " ]\n" );
-    }
+  fname = (char *)malloc( (size_t)PATH_MAX );
+  if( !fname ) { FATAL_ERROR( "Cannot allocate memory" ); }
 
+  if( mkdir( chunks_dname, 0755 ) < 0 )
+  {
+    if( errno != EEXIST ) { FATAL_ERROR( "Cannot create %s directory", basename( chunks_dname ) ); }
+    clean_chunks_dir( fname );
   }
 
-  ++ctx->index;
-}
+  graph_init( &gr, provides );
 
-static void print_tree_json( FILE *output, struct dlist *list )
-{
-  struct _ctx ctx;
+  graph_print_head( json, list );
 
-  if( !output || !list ) return;
+  json_text( json, ",\n \"chunks\": " );
+  json_string( json, json_chunks_dir );
 
-  bzero( (void *)&ctx, sizeof(struct _ctx) );
+  json_text( json, ",\n \"packages\": [\n" );
+  for( i = 0; i < gr.size; ++i )
+  {
+    struct pkginfo *info = gr.nodes[i].package->pkginfo;
 
-  ctx.output = output;
-  ctx.index  = 0;
-  ctx.size   = dlist_length( list );
-  ctx.depth  = 2;
+    json_text( json, "  { \"name\": " );
+    json_string( json, info->name );
+    json_text( json, ", \"version\": " );
+    json_string( json, info->version );
+    if( info->group )
+    {
+      json_text( json, ", \"group\": " );
+      json_string( json, info->group );
+    }
+    if( gr.nodes[i].height > 1 )
+    {
+      json_text( json, ", \"requires\": [ " );
+      graph_print_requires( &gr, json, gr.nodes[i].package->requires->list );
+      json_text( json, " ]" );
+    }
+    json_text( json, (i < gr.size - 1) ? " },\n" : " }\n" );
 
-  fprintf( output, "{\n" );
-  dlist_foreach( list, __print_tree_node, (void *)&ctx );
-  fprintf( output, "}\n" );
+    (void)snprintf( fname, (size_t)PATH_MAX, "%s/%d.json", chunks_dname, i );
+    print_package_chunk( &gr, i, (const char *)fname );
+  }
+  json_text( json, " ],\n" );
 
-  svg_height += svg_width / 2;
+  graph_print_children( &gr, json, list );
 
-  svg_width  = (svg_width  + 4) * 160;
-  svg_height = (svg_height + 4) * 24;
+  graph_free( &gr );
+  free( fname );
 }
 
 #include <pkglist.html.c>
@@ -1468,25 +3235,51 @@ static void print_tree_json( FILE *output, struct dlist *list )
 void print_provides_tree( const char *json_fname )
 {
   FILE *pkgs_fp = NULL, *tree_fp = NULL, *html_fp = NULL;
+  FILE *pkgs_min_fp = NULL, *tree_min_fp = NULL;
+  char *tree_out, *tree_min_out;
+
+  struct json json;
 
   allocate_fnames( json_fname );
 
+  /* with --chunks option the INDEX is created instead of REQUIRES TREE: */
+  tree_out     = (chunks) ? index_fname     : tree_fname;
+  tree_min_out = (chunks) ? index_min_fname : tree_min_fname;
+
   pkgs_fp = fopen( (const char *)pkgs_fname, "w" );
   if( !pkgs_fp ) { FATAL_ERROR( "Cannot create %s file", basename( pkgs_fname ) ); }
-  tree_fp = fopen( (const char *)tree_fname, "w" );
-  if( !tree_fp ) { FATAL_ERROR( "Cannot create %s file", basename( tree_fname ) ); }
+  tree_fp = fopen( (const char *)tree_out, "w" );
+  if( !tree_fp ) { FATAL_ERROR( "Cannot create %s file", basename( tree_out ) ); }
   html_fp = fopen( (const char *)html_fname, "w" );
   if( !html_fp ) { FATAL_ERROR( "Cannot create %s file", basename( html_fname ) ); }
 
+  if( minimize )
+  {
+    /*************************************************
+      .min.json files are written at the same time as
+      .json files by compact output of JSON writer:
+     */
+    pkgs_min_fp = fopen( (const char *)pkgs_min_fname, "w" );
+    if( !pkgs_min_fp ) { FATAL_ERROR( "Cannot create %s file", basename( pkgs_min_fname ) ); }
+    tree_min_fp = fopen( (const char *)tree_min_out, "w" );
+    if( !tree_min_fp ) { FATAL_ERROR( "Cannot create %s file", basename( tree_min_out ) ); }
+  }
+
   tree = dlist_copy( provides );
+  index_rebuild( &tree_index, tree );
 
   /*****************************************************
     print out the array of all packages in JSON format:
    */
-  print_pkgs_json( pkgs_fp, provides );
+  json_init( &json, pkgs_fp, pkgs_min_fp );
+  print_pkgs_json( &json, provides );
+  json_free( &json );
   fflush( pkgs_fp ); fclose( pkgs_fp );
+  if( pkgs_min_fp ) { fflush( pkgs_min_fp ); fclose( pkgs_min_fp ); }
 
-  provides = dlist_reverse( provides );
+  dlist_head_attach( &provides_head, dlist_reverse( provides ) );
+  provides = dlist_head_first( &provides_head );
+  index_rebuild( &provides_index, provides );
 
   /********************************************************
     remove unneded packages from tree list to to leave the
@@ -1495,23 +3288,21 @@ void print_provides_tree( const char *json_fname )
   remove_required_packages( provides );
 
   /***********************************************
-    print out the REQIIRES TREE in JSON format
-    starting from last installation layer of DAG:
+    print out the REQIIRES TREE (or the compact
+    REQUIRES GRAPH, or INDEX of CHUNKS) in JSON
+    format starting from last installation layer
+    of DAG:
    */
-  print_tree_json( tree_fp, tree );
+  json_init( &json, tree_fp, tree_min_fp );
+  if( chunks )
+    print_chunks_json( &json, tree );
+  else if( graph )
+    print_graph_json( &json, tree );
+  else
+    print_tree_json( &json, tree );
+  json_free( &json );
   fflush( tree_fp ); fclose( tree_fp );
-
-  if( minimize )
-  {
-    if( minimize_json( (const char *)pkgs_fname, (const char *)pkgs_min_fname ) < 1 )
-    {
-      (void)unlink( (const char *)pkgs_min_fname );
-    }
-    if( minimize_json( (const char *)tree_fname, (const char *)tree_min_fname ) < 1 )
-    {
-      (void)unlink( (const char *)tree_min_fname );
-    }
-  }
+  if( tree_min_fp ) { fflush( tree_min_fp ); fclose( tree_min_fp ); }
 
 
   /***********************************************
@@ -1534,9 +3325,15 @@ void print_provides_tree( const char *json_fname )
   if( pkgs_min_fname ) { free( pkgs_min_fname ); pkgs_min_fname = NULL; }
   if( tree_min_fname ) { free( tree_min_fname ); tree_min_fname = NULL; }
 
+  if( index_fname )     { free( index_fname );     index_fname     = NULL; }
+  if( index_min_fname ) { free( index_min_fname ); index_min_fname = NULL; }
+  if( chunks_dname )    { free( chunks_dname );    chunks_dname    = NULL; }
+
   if( json_pkgs_file ) { free( json_pkgs_file ); json_pkgs_file = NULL; }
   if( json_tree_file ) { free( json_tree_file ); json_tree_file = NULL; }
+  if( json_chunks_dir ) { free( json_chunks_dir ); json_chunks_dir = NULL; }
 
+  index_free( &tree_index );
   __dlist_free( tree ); /* do not free node data */
 }
 /*
@@ -23,6 +23,8 @@
 extern "C" {
 #endif
 
+#include <sys/types.h>
+
 #include <dlist.h>
 
 
@@ -55,6 +57,8 @@ struct pkginfo
   size_t  uncompressed_size; /* size in 1024-byte blocks */
   size_t  compressed_size;   /* size in bytes            */
   int     total_files;
+
+  char   *version_key;       /* cached key of version    */
 };
 
 struct pkg
@@ -62,6 +66,7 @@ struct pkg
   char *group;
   char *name;
   char *version;
+  char *version_key; /* cached key of version */
 
   enum  _procedure procedure; /* install procedure */
 };
@@ -80,8 +85,14 @@ struct requires
 
 struct files
 {
-  int    size;
-  struct dlist *list;     /* list of strings */
+  struct dlist_head list; /* list of strings */
+};
+
+/* Position of the PKGLOG section which is not read yet: */
+struct pkglog_section
+{
+  off_t   offset; /* the first line after the section header */
+  size_t  size;   /* 0 if the section is read or empty       */
 };
 
 
@@ -94,21 +105,35 @@ struct package
   char  *tarball;
   enum  _procedure procedure; /* install procedure     */
   enum  _priority  priority;  /* install user priority */
+  int              level;     /* installation level    */
 
   struct references *references;
   struct requires   *requires;
 
+  /*
+    Large sections are read from PKGLOG on demand;
+    use package_description(), package_files(), etc.:
+   */
   char  *description;
 
   char  *restore_links;
   char  *install_script;
 
   struct files *files;
+
+  char  *pkglog; /* PKGLOG file name */
+  struct pkglog_section description_section;
+  struct pkglog_section restore_links_section;
+  struct pkglog_section install_script_section;
+  struct pkglog_section file_list_section;
 };
 
 
 extern char *hardware;
 extern int   minimize;
+extern int   levels;
+extern int   graph;
+extern int   chunks;
 
 extern char *strprio( enum _priority priority, int short_name );
 extern char *strproc( enum _procedure procedure );
@@ -121,7 +146,15 @@ extern const char *find_tarball( const char *name );
 extern void print_tarballs( void );
 
 
-extern struct dlist *packages;
+extern struct dlist_head packages;
+
+/* Strings of the package model should be allocated by: */
+extern char *pkglist_strdup( const char *s );
+/*
+  Names, groups, versions, arch and distro strings of pkginfo and
+  pkg structures are compared by pointers and have to be set by:
+ */
+extern char *pkglist_intern( const char *s );
 
 extern struct pkg *pkg_alloc( void );
 extern void pkg_free( struct pkg *pkg );
@@ -140,6 +173,34 @@ extern void add_package( struct package *package ); /* append the packages list
 extern void free_packages( void );
 
 
+enum _pkglog_status
+{
+  PKGLOG_OK = 0,
+  PKGLOG_INVALID,           /* required PKGINFO fields are not found */
+  PKGLOG_NO_REFERENCES,
+  PKGLOG_BAD_REFERENCES,
+  PKGLOG_NO_REQUIRES,
+  PKGLOG_BAD_REQUIRES,
+  PKGLOG_NO_DESCRIPTION,
+  PKGLOG_NO_RESTORE_LINKS,
+  PKGLOG_NO_INSTALL_SCRIPT,
+  PKGLOG_EMPTY_FILE_LIST
+};
+
+/*
+  Reads the FNAME PKGLOG into PACKAGE by one pass. Returns PKGLOG_OK,
+  the status of the first invalid section, or -1 (errno is set) if
+  the file cannot be read:
+ */
+extern int read_pkglog( const char *fname, struct package *package );
+extern const char *pkglog_strerror( int status );
+
+extern const char   *package_description( struct package *package );
+extern const char   *package_restore_links( struct package *package );
+extern const char   *package_install_script( struct package *package );
+extern struct files *package_files( struct package *package );
+
+
 struct dlist *provides;
 struct dlist *extern_requires;
 
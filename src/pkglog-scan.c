@@ -0,0 +1,119 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>  /* index(3) */
+
+#include <pkglog-scan.h>
+
+
+static const char *section_headers[SECTIONS] =
+{
+  NULL,
+  "REFERENCE COUNTER:",
+  "REQUIRES:",
+  "PACKAGE DESCRIPTION:",
+  "RESTORE LINKS:",
+  "INSTALL SCRIPT:",
+  "FILE LIST:"
+};
+
+static const struct
+{
+  const char         *key;
+  enum _pkglog_field  field;
+} header_fields[] =
+{
+  { "PACKAGE NAME:",      FIELD_NAME              },
+  { "PACKAGE VERSION:",   FIELD_VERSION           },
+  { "ARCH:",              FIELD_ARCH              },
+  { "DISTRO:",            FIELD_DISTRO_NAME       },
+  { "DISTRO VERSION:",    FIELD_DISTRO_VERSION    },
+  { "GROUP:",             FIELD_GROUP             },
+  { "URL:",               FIELD_URL               },
+  { "LICENSE:",           FIELD_LICENSE           },
+  { "UNCOMPRESSED SIZE:", FIELD_UNCOMPRESSED_SIZE },
+  { "TOTAL FILES:",       FIELD_TOTAL_FILES       }
+};
+
+
+enum _pkglog_section pkglog_section_header( const char *line )
+{
+  int section;
+
+  if( !line ) return SECTION_HEADER;
+
+  for( section = SECTION_REFERENCES; section < SECTIONS; ++section )
+  {
+    if( !strncmp( line, section_headers[section], strlen( section_headers[section] ) ) )
+      return (enum _pkglog_section)section;
+  }
+
+  return SECTION_HEADER;
+}
+
+enum _pkglog_field pkglog_header_field( char *line, char **value )
+{
+  size_t i, len;
+
+  if( !line ) return FIELD_NONE;
+
+  for( i = 0; i < sizeof( header_fields ) / sizeof( header_fields[0] ); ++i )
+  {
+    len = strlen( header_fields[i].key );
+    if( !strncmp( line, header_fields[i].key, len ) )
+    {
+      if( value ) *value = line + len;
+      return header_fields[i].field;
+    }
+  }
+
+  return FIELD_NONE;
+}
+
+void pkglog_short_description( char *buf, const char *line )
+{
+  const char *p, *q;
+  size_t      len;
+
+  if( !buf ) return;
+  buf[0] = '\0';
+  if( !line || line[0] == '\0' ) return;
+
+  p = index( line, '(' );
+  q = index( line, ')' );
+  if( p && q && q > p )
+  {
+    len = (size_t)(q - p - 1);
+    memcpy( (void *)buf, (const void *)(p + 1), len );
+    buf[len] = '\0';
+  }
+  else
+  {
+    /*
+      If short description declaration is incorrect at first line
+      of description; then we take whole first line of description:
+     */
+    p = index( line, ':' );
+    if( !p ) p = line; else ++p;
+    while( *p == ' ' || *p == '\t' ) { ++p; }
+    strcpy( buf, p );
+  }
+}
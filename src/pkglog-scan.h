@@ -0,0 +1,97 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#ifndef _PKGLOG_SCAN_H_
+#define _PKGLOG_SCAN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/***************************************************************
+  PKGLOG scanning:
+  ===============
+
+    The layout of PKGLOG file is shared by the readers of package
+    list (pkglist.c) and Setup Database index (pkgdb.c). The file
+    starts with header lines 'KEY: value' and then goes sections
+    in following order:
+
+      REFERENCE COUNTER: N
+      REQUIRES:
+      PACKAGE DESCRIPTION:
+      RESTORE LINKS:
+      INSTALL SCRIPT:
+      FILE LIST:
+
+    The readers keep their own state and call these functions to
+    classify the lines.
+ */
+enum _pkglog_section
+{
+  SECTION_HEADER = 0,
+  SECTION_REFERENCES,
+  SECTION_REQUIRES,
+  SECTION_DESCRIPTION,
+  SECTION_RESTORE_LINKS,
+  SECTION_INSTALL_SCRIPT,
+  SECTION_FILE_LIST,
+
+  SECTIONS
+};
+
+enum _pkglog_field
+{
+  FIELD_NONE = 0,
+  FIELD_NAME,
+  FIELD_VERSION,
+  FIELD_ARCH,
+  FIELD_DISTRO_NAME,
+  FIELD_DISTRO_VERSION,
+  FIELD_GROUP,
+  FIELD_URL,
+  FIELD_LICENSE,
+  FIELD_UNCOMPRESSED_SIZE,
+  FIELD_TOTAL_FILES
+};
+
+/*
+  Returns the section started by LINE or SECTION_HEADER if LINE is not
+  a section header. FILE LIST is the last section: the lines after its
+  header are file names and should not be passed here.
+ */
+extern enum _pkglog_section pkglog_section_header( const char *line );
+
+/*
+  Returns the field of header LINE and sets VALUE to the text after
+  the key (not trimmed) or returns FIELD_NONE for unknown lines:
+ */
+extern enum _pkglog_field pkglog_header_field( char *line, char **value );
+
+/*
+  Copies short description from the first LINE of PACKAGE DESCRIPTION
+  into BUF. The BUF should have at least strlen( LINE ) + 1 bytes.
+ */
+extern void pkglog_short_description( char *buf, const char *line );
+
+
+#ifdef __cplusplus
+}  /* ... extern "C" */
+#endif
+
+#endif /* _PKGLOG_SCAN_H_ */
@@ -49,6 +49,7 @@
 
 #include <msglog.h>
 #include <system.h>
+#include <tarball.h>
 
 #define PROGRAM_NAME "pkglog"
 
@@ -414,12 +415,10 @@ static char uncompress[2] = { 0, 0 };
 static enum _pkginfo_type check_pkginfo_file( const char *fname )
 {
   struct stat st;
-  size_t pkginfo_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   uncompress[0] = '\0';
 
   if( stat( fname, &st ) == -1 )
@@ -427,8 +426,6 @@ static enum _pkginfo_type check_pkginfo_file( const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkginfo_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -447,47 +444,22 @@ static enum _pkginfo_type check_pkginfo_file( const char *fname )
     close( fd ); return PKGINFO_TEXT;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    uncompress[0] = 'x';
-    close( fd ); return PKGINFO_GZ;
-  }
+  close( fd );
 
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    uncompress[0] = 'j';
-    close( fd ); return PKGINFO_BZ2;
-  }
+  compression = tarball_compression( fname );
+  uncompress[0] = tarball_tar_option( compression );
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
+  switch( compression )
   {
-    uncompress[0] = 'J';
-    close( fd ); return PKGINFO_XZ;
-  }
-
-  if( pkginfo_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return PKGINFO_TAR;
-    }
+    case TARBALL_GZIP:  return PKGINFO_GZ;
+    case TARBALL_BZIP2: return PKGINFO_BZ2;
+    case TARBALL_XZ:    return PKGINFO_XZ;
+    case TARBALL_NONE:  return PKGINFO_TAR;
+    default:
+      break;
   }
 
-  close( fd ); return PKGINFO_UNKNOWN;
+  return PKGINFO_UNKNOWN;
 }
 
 
@@ -1215,6 +1187,10 @@ int main( int argc, char *argv[] )
       int   len = 0;
       char *cmd = NULL, *errmsg = NULL, *wmsg = NULL;
 
+      const char * const service_files[] = {
+        ".PKGINFO", ".REQUIRES", ".DESCRIPTION", ".RESTORELINKS", ".INSTALL", ".FILELIST", NULL
+      };
+
       cmd = (char *)malloc( (size_t)PATH_MAX );
       if( !cmd )    { FATAL_ERROR( "Cannot allocate memory" ); }
 
@@ -1237,8 +1213,18 @@ int main( int argc, char *argv[] )
       {
         FATAL_ERROR( errmsg );
       }
-      p = sys_exec_command( cmd );
-      rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
+
+      /* built-in TAR reader; tar(1) is used if the compression is not supported: */
+      if( (rc = tarball_extract_members( pkginfo_fname, srcdir, service_files, service_files )) < 0 )
+      {
+        p = sys_exec_command( cmd );
+        rc = sys_wait_command( p, (char *)&wmsg[0], PATH_MAX );
+      }
+      else if( rc > 0 )
+      {
+        rc = 2; /* as tar(1) does for not found members */
+      }
+
       if( rc != 0 )
       {
         if( ! DO_NOT_WARN_ABOUT_SERVICE_FILES )
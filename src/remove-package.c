@@ -60,6 +60,8 @@
 
 #include <cmpvers.h>
 #include <dlist.h>
+#include <pkgdb.h>
+#include <tarball.h>
 
 #if defined( HAVE_DIALOG )
 #include <dialog-ui.h>
@@ -449,12 +451,10 @@ static void set_signal_handlers()
 static enum _input_type check_input_file( char *uncompress, const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   if( uncompress )
   {
     *uncompress = '\0';
@@ -465,8 +465,6 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -485,47 +483,14 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     close( fd ); return IFMT_LOG;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    if( uncompress ) { *uncompress = 'x'; }
-    close( fd ); return IFMT_PKG;
-  }
+  close( fd );
 
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    if( uncompress ) { *uncompress = 'j'; }
-    close( fd ); return IFMT_PKG;
-  }
+  /* GZ, BZ2, XZ or TAR */
+  if( (compression = tarball_compression( fname )) == TARBALL_UNKNOWN ) return IFMT_UNKNOWN;
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
-  {
-    if( uncompress ) { *uncompress = 'J'; }
-    close( fd ); return IFMT_PKG;
-  }
-
-  if( pkglog_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return IFMT_PKG;
-    }
-  }
+  if( uncompress ) { *uncompress = tarball_tar_option( compression ); }
 
-  close( fd ); return IFMT_UNKNOWN;
+  return IFMT_PKG;
 }
 
 
@@ -850,6 +815,9 @@ static void read_filelist( void )
   char *ln   = NULL;
   char *line = NULL, *tmp = NULL;
 
+  struct dlist_head dhead = DLIST_HEAD_INIT,
+                    fhead = DLIST_HEAD_INIT;
+
   tmp = (char *)malloc( (size_t)PATH_MAX );
   if( !tmp ) { FATAL_ERROR( "Cannot allocate memory" ); }
   bzero( (void *)tmp, PATH_MAX );
@@ -871,6 +839,9 @@ static void read_filelist( void )
   if( !line ) { FATAL_ERROR( "Cannot allocate memory" ); }
   bzero( (void *)line, PATH_MAX );
 
+  dlist_head_attach( &dhead, dirs );
+  dlist_head_attach( &fhead, files );
+
   while( (ln = fgets( line, PATH_MAX, fp )) )
   {
     ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
@@ -880,16 +851,19 @@ static void read_filelist( void )
     {
       *(ln + strlen(ln) - 1) = '\0';
       (void)sprintf( &tmp[0], "%s%s", (const char *)root, (const char *)ln );
-      dirs = dlist_append( dirs, strdup( (const char *)&tmp[0] ) );
+      dlist_head_append( &dhead, strdup( (const char *)&tmp[0] ) );
     }
     else
     {
       (void)sprintf( &tmp[0], "%s%s", (const char *)root, (const char *)ln );
-      files = dlist_append( files, strdup( (const char *)&tmp[0] ) );
+      dlist_head_append( &fhead, strdup( (const char *)&tmp[0] ) );
     }
 
   } /* End of while( file list entry ) */
 
+  dirs  = dlist_head_detach( &dhead );
+  files = dlist_head_detach( &fhead );
+
   fclose( fp );
 
   free( line );
@@ -1391,6 +1365,25 @@ static void finalize_removal( void )
     }
   }
 
+  /******************************************
+    Update the index of the Setup Database:
+   */
+  bzero( (void *)tmp, PATH_MAX );
+  {
+    const char *pkglog = (const char *)&tmp[0];
+
+    if( group )
+      (void)sprintf( &tmp[0], "%s/%s", group, basename( (char *)pkglog_fname ) );
+    else
+      (void)sprintf( &tmp[0], "%s", basename( (char *)pkglog_fname ) );
+
+    /* there is nothing to update if the index doesn't exist: */
+    if( pkgdb_update( (const char *)pkgs_path, &pkglog, 1, 0 ) != 0 )
+    {
+      WARNING( "Cannot update the index of Setup Database" );
+    }
+  }
+
   free( tmp );
 }
 
@@ -78,6 +78,19 @@ pid_t sys_exec_command( const char *cmd )
   return pid; /* only to avoid compilaton warning */
 }
 
+pid_t sys_spawn_command( const char *cmd )
+{
+  pid_t pid = fork();
+
+  if( pid != 0 )
+  {
+    return pid;
+  }
+
+  xexec( cmd );
+  return pid; /* only to avoid compilaton warning */
+}
+
 
 /*****************************************************************
   sys_wait_command() - Wait for pid.
@@ -26,6 +26,12 @@ extern "C" {
 
 extern pid_t sys_exec_command( const char *cmd );
 
+/*
+  The same as sys_exec_command() but returns -1 (errno is set) if the
+  child process cannot be created instead of FATAL error:
+ */
+extern pid_t sys_spawn_command( const char *cmd );
+
 /*****************************************************************
   sys_wait_command() - Wait for pid.
 
@@ -0,0 +1,1254 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>  /* index(3)    */
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pwd.h>
+#include <grp.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h> /* makedev(3) */
+
+#if defined( HAVE_ZLIB )
+#include <zlib.h>
+#endif
+#if defined( HAVE_BZLIB )
+#include <bzlib.h>
+#endif
+#if defined( HAVE_LZMA )
+#include <lzma.h>
+#endif
+
+#include <msglog.h>
+#include <tarball.h>
+
+
+#define TARBALL_BLOCK    512
+#define TARBALL_BUFSIZE  65536
+
+struct tarball;
+
+struct decompressor
+{
+  int     (*init)( struct tarball *tar );
+  ssize_t (*read)( struct tarball *tar, void *buf, size_t size );
+  void    (*end)( struct tarball *tar );
+};
+
+struct directory
+{
+  char   *path;
+  time_t  mtime;
+  long    mtime_nsec;
+};
+
+struct symlink
+{
+  char                  *path;
+  char                  *linkname;
+  dev_t                  dev;     /* the placeholder file */
+  ino_t                  ino;
+  struct tarball_member  member;  /* resolved owner and mtime */
+};
+
+struct tarball
+{
+  int                        fd;
+  enum _tarball_compression  compression;
+  const struct decompressor *decompressor;
+  void                      *stream;    /* decompressor state */
+
+  unsigned char             *in;        /* compressed data */
+  size_t                     in_size, in_pos;
+  int                        eof;       /* end of compressed file */
+  int                        finished;  /* end of uncompressed stream */
+
+  tarball_raw_func           raw_func;
+  void                      *raw_data;
+
+  struct tarball_member      member;
+  uint64_t                   remain;    /* not read data of current member */
+  uint64_t                   padding;
+  int                        end;
+
+  struct directory          *dirs;      /* mtimes are restored at finish */
+  size_t                     ndirs, dsize;
+
+  struct symlink            *links;     /* symbolic links are created at finish */
+  size_t                     nlinks, lsize;
+};
+
+
+/***************************************************************
+  Compressed INPUT functions:
+ */
+static int __fill( struct tarball *tar )
+{
+  ssize_t n;
+
+  if( tar->in_pos < tar->in_size ) return 1;
+  if( tar->eof ) return 0;
+
+  do {
+    n = read( tar->fd, (void *)tar->in, TARBALL_BUFSIZE );
+  } while( n == -1 && errno == EINTR );
+
+  if( n < 0 ) return -1;
+
+  tar->in_pos  = 0;
+  tar->in_size = (size_t)n;
+
+  if( n == 0 ) { tar->eof = 1; return 0; }
+
+  if( tar->raw_func ) tar->raw_func( (const void *)tar->in, (size_t)n, tar->raw_data );
+
+  return 1;
+}
+
+static ssize_t __none_read( struct tarball *tar, void *buf, size_t size )
+{
+  size_t n;
+  int    rc;
+
+  if( (rc = __fill( tar )) <= 0 ) return (ssize_t)rc;
+
+  n = tar->in_size - tar->in_pos;
+  if( n > size ) n = size;
+
+  memcpy( buf, (const void *)(tar->in + tar->in_pos), n );
+  tar->in_pos += n;
+
+  return (ssize_t)n;
+}
+
+static const struct decompressor none_decompressor = { NULL, __none_read, NULL };
+
+
+#if defined( HAVE_ZLIB )
+static int __gzip_init( struct tarball *tar )
+{
+  z_stream *zs = (z_stream *)calloc( 1, sizeof(z_stream) );
+
+  if( !zs ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  /* 15 + 32: gzip header detection */
+  if( inflateInit2( zs, 15 + 32 ) != Z_OK ) { free( zs ); return -1; }
+
+  tar->stream = (void *)zs;
+  return 0;
+}
+
+static ssize_t __gzip_read( struct tarball *tar, void *buf, size_t size )
+{
+  z_stream *zs = (z_stream *)tar->stream;
+  int       rc;
+
+  zs->next_out  = (Bytef *)buf;
+  zs->avail_out = (uInt)size;
+
+  while( zs->avail_out == (uInt)size && !tar->finished )
+  {
+    if( (rc = __fill( tar )) < 0 ) return -1;
+    if( rc == 0 ) { errno = EIO; return -1; } /* truncated stream */
+
+    zs->next_in  = (Bytef *)(tar->in + tar->in_pos);
+    zs->avail_in = (uInt)(tar->in_size - tar->in_pos);
+
+    rc = inflate( zs, Z_NO_FLUSH );
+
+    tar->in_pos = tar->in_size - zs->avail_in;
+
+    if( rc == Z_STREAM_END )
+    {
+      /* concatenated gzip members: */
+      if( __fill( tar ) > 0 ) { if( inflateReset( zs ) != Z_OK ) return -1; }
+      else                    tar->finished = 1;
+    }
+    else if( rc != Z_OK && rc != Z_BUF_ERROR ) { errno = EIO; return -1; }
+  }
+
+  return (ssize_t)(size - zs->avail_out);
+}
+
+static void __gzip_end( struct tarball *tar )
+{
+  (void)inflateEnd( (z_stream *)tar->stream );
+  free( tar->stream ); tar->stream = NULL;
+}
+
+static const struct decompressor gzip_decompressor = { __gzip_init, __gzip_read, __gzip_end };
+#endif
+
+
+#if defined( HAVE_BZLIB )
+static int __bzip2_init( struct tarball *tar )
+{
+  bz_stream *bz = (bz_stream *)calloc( 1, sizeof(bz_stream) );
+
+  if( !bz ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  if( BZ2_bzDecompressInit( bz, 0, 0 ) != BZ_OK ) { free( bz ); return -1; }
+
+  tar->stream = (void *)bz;
+  return 0;
+}
+
+static ssize_t __bzip2_read( struct tarball *tar, void *buf, size_t size )
+{
+  bz_stream *bz = (bz_stream *)tar->stream;
+  int        rc;
+
+  bz->next_out  = (char *)buf;
+  bz->avail_out = (unsigned int)size;
+
+  while( bz->avail_out == (unsigned int)size && !tar->finished )
+  {
+    if( (rc = __fill( tar )) < 0 ) return -1;
+    if( rc == 0 ) { errno = EIO; return -1; }
+
+    bz->next_in  = (char *)(tar->in + tar->in_pos);
+    bz->avail_in = (unsigned int)(tar->in_size - tar->in_pos);
+
+    rc = BZ2_bzDecompress( bz );
+
+    tar->in_pos = tar->in_size - bz->avail_in;
+
+    if( rc == BZ_STREAM_END )
+    {
+      /* concatenated bzip2 streams: */
+      if( __fill( tar ) > 0 )
+      {
+        (void)BZ2_bzDecompressEnd( bz );
+        bzero( (void *)bz, sizeof(bz_stream) );
+        if( BZ2_bzDecompressInit( bz, 0, 0 ) != BZ_OK ) return -1;
+        bz->next_out  = (char *)buf + (size - bz->avail_out);
+      }
+      else
+        tar->finished = 1;
+    }
+    else if( rc != BZ_OK ) { errno = EIO; return -1; }
+  }
+
+  return (ssize_t)(size - bz->avail_out);
+}
+
+static void __bzip2_end( struct tarball *tar )
+{
+  (void)BZ2_bzDecompressEnd( (bz_stream *)tar->stream );
+  free( tar->stream ); tar->stream = NULL;
+}
+
+static const struct decompressor bzip2_decompressor = { __bzip2_init, __bzip2_read, __bzip2_end };
+#endif
+
+
+#if defined( HAVE_LZMA )
+static int __xz_init( struct tarball *tar )
+{
+  lzma_stream  init = LZMA_STREAM_INIT;
+  lzma_stream *xz   = (lzma_stream *)malloc( sizeof(lzma_stream) );
+
+  if( !xz ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  *xz = init;
+
+  if( lzma_stream_decoder( xz, UINT64_MAX, LZMA_CONCATENATED ) != LZMA_OK ) { free( xz ); return -1; }
+
+  tar->stream = (void *)xz;
+  return 0;
+}
+
+static ssize_t __xz_read( struct tarball *tar, void *buf, size_t size )
+{
+  lzma_stream *xz = (lzma_stream *)tar->stream;
+  lzma_ret     ret;
+  int          rc;
+
+  xz->next_out  = (uint8_t *)buf;
+  xz->avail_out = size;
+
+  while( xz->avail_out == size && !tar->finished )
+  {
+    if( (rc = __fill( tar )) < 0 ) return -1;
+
+    xz->next_in  = (const uint8_t *)(tar->in + tar->in_pos);
+    xz->avail_in = tar->in_size - tar->in_pos;
+
+    ret = lzma_code( xz, ( rc == 0 ) ? LZMA_FINISH : LZMA_RUN );
+
+    tar->in_pos = tar->in_size - xz->avail_in;
+
+    if( ret == LZMA_STREAM_END )   tar->finished = 1;
+    else if( ret != LZMA_OK )      { errno = EIO; return -1; }
+    else if( rc == 0 && xz->avail_out == size ) { errno = EIO; return -1; }
+  }
+
+  return (ssize_t)(size - xz->avail_out);
+}
+
+static void __xz_end( struct tarball *tar )
+{
+  lzma_end( (lzma_stream *)tar->stream );
+  free( tar->stream ); tar->stream = NULL;
+}
+
+static const struct decompressor xz_decompressor = { __xz_init, __xz_read, __xz_end };
+#endif
+
+/* Reads exactly SIZE bytes; returns the number of read bytes or -1 on error: */
+static ssize_t __read_full( struct tarball *tar, void *buf, size_t size )
+{
+  size_t done = 0;
+
+  while( done < size )
+  {
+    ssize_t n = tar->decompressor->read( tar, (void *)((char *)buf + done), size - done );
+
+    if( n < 0 ) return -1;
+    if( n == 0 ) break;
+    done += (size_t)n;
+  }
+  return (ssize_t)done;
+}
+
+static int __skip( struct tarball *tar, uint64_t size )
+{
+  char buf[TARBALL_BLOCK * 16];
+
+  while( size )
+  {
+    size_t  len = ( size > sizeof(buf) ) ? sizeof(buf) : (size_t)size;
+    ssize_t n   = __read_full( tar, (void *)&buf[0], len );
+
+    if( n != (ssize_t)len ) return -1;
+    size -= len;
+  }
+  return 0;
+}
+/*
+  End of Compressed INPUT functions.
+ ***************************************************************/
+
+
+/***************************************************************
+  Archive OPEN functions:
+ */
+enum _tarball_compression tarball_compression( const char *fname )
+{
+  enum _tarball_compression ret = TARBALL_UNKNOWN;
+  unsigned char buf[8];
+  int fd;
+
+  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
+
+  if( (fd = open( fname, O_RDONLY )) == -1 ) return ret;
+
+  if( read( fd, (void *)&buf[0], 6 ) == 6 )
+  {
+    if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
+      ret = TARBALL_GZIP;
+    else if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
+      ret = TARBALL_BZIP2;
+    else if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
+             buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
+      ret = TARBALL_XZ;
+    else if( lseek( fd, 257, SEEK_SET ) == 257 && read( fd, (void *)&buf[0], 5 ) == 5 &&
+             !strncmp( (const char *)&buf[0], "ustar", 5 ) )
+      ret = TARBALL_NONE;
+  }
+
+  close( fd );
+
+  return ret;
+}
+
+char tarball_tar_option( enum _tarball_compression compression )
+{
+  switch( compression )
+  {
+    case TARBALL_GZIP:  return 'x';
+    case TARBALL_BZIP2: return 'j';
+    case TARBALL_XZ:    return 'J';
+    default:
+      break;
+  }
+  return '\0';
+}
+
+struct tarball *tarball_open( const char *fname )
+{
+  struct tarball *tar = NULL;
+  const struct decompressor *decompressor = NULL;
+  enum _tarball_compression compression = tarball_compression( fname );
+
+  switch( compression )
+  {
+    case TARBALL_NONE:  decompressor = &none_decompressor;  break;
+#if defined( HAVE_ZLIB )
+    case TARBALL_GZIP:  decompressor = &gzip_decompressor;  break;
+#endif
+#if defined( HAVE_BZLIB )
+    case TARBALL_BZIP2: decompressor = &bzip2_decompressor; break;
+#endif
+#if defined( HAVE_LZMA )
+    case TARBALL_XZ:    decompressor = &xz_decompressor;    break;
+#endif
+    case TARBALL_UNKNOWN:
+      errno = EINVAL;
+      return tar;
+    default:
+      errno = ENOTSUP;
+      return tar;
+  }
+
+  tar = (struct tarball *)malloc( sizeof(struct tarball) );
+  if( !tar ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  bzero( (void *)tar, sizeof(struct tarball) );
+
+  tar->in = (unsigned char *)malloc( (size_t)TARBALL_BUFSIZE );
+  if( !tar->in ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  tar->compression  = compression;
+  tar->decompressor = decompressor;
+
+  if( (tar->fd = open( fname, O_RDONLY )) == -1 )
+  {
+    free( tar->in ); free( tar );
+    return NULL;
+  }
+
+  if( decompressor->init && decompressor->init( tar ) != 0 )
+  {
+    close( tar->fd );
+    free( tar->in ); free( tar );
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  return tar;
+}
+
+static void __free_member( struct tarball_member *member )
+{
+  if( member->name )     free( member->name );
+  if( member->linkname ) free( member->linkname );
+  if( member->uname )    free( member->uname );
+  if( member->gname )    free( member->gname );
+
+  bzero( (void *)member, sizeof(struct tarball_member) );
+}
+
+void tarball_close( struct tarball *tar )
+{
+  if( !tar ) return;
+
+  (void)tarball_finish( tar );
+
+  if( tar->dirs )  free( tar->dirs );
+  if( tar->links ) free( tar->links );
+
+  if( tar->decompressor->end ) tar->decompressor->end( tar );
+
+  __free_member( &tar->member );
+
+  close( tar->fd );
+  free( tar->in );
+  free( tar );
+}
+
+void tarball_set_raw_func( struct tarball *tar, tarball_raw_func func, void *user_data )
+{
+  if( !tar ) return;
+
+  tar->raw_func = func;
+  tar->raw_data = user_data;
+
+  /* the data which is already read: */
+  if( func && tar->in_size ) func( (const void *)tar->in, tar->in_size, user_data );
+}
+/*
+  End of Archive OPEN functions.
+ ***************************************************************/
+
+
+/***************************************************************
+  Archive HEADER functions:
+ */
+static uint64_t __number( const char *p, size_t len )
+{
+  uint64_t val = 0;
+  size_t   i = 0;
+
+  /* base-256 (GNU) encoding of large values: */
+  if( (unsigned char)p[0] & 0x80 )
+  {
+    val = (unsigned char)p[0] & 0x7F;
+    for( i = 1; i < len; ++i ) val = (val << 8) | (unsigned char)p[i];
+    return val;
+  }
+
+  while( i < len && (p[i] == ' ' || p[i] == '\0') ) ++i;
+  while( i < len && p[i] >= '0' && p[i] <= '7' ) { val = (val << 3) + (uint64_t)(p[i] - '0'); ++i; }
+
+  return val;
+}
+
+static int __check_sum( const unsigned char *block )
+{
+  uint64_t sum = __number( (const char *)&block[148], 8 );
+  uint64_t usum = 0;
+  int64_t  ssum = 0;
+  int      i;
+
+  for( i = 0; i < TARBALL_BLOCK; ++i )
+  {
+    unsigned char c = ( i >= 148 && i < 156 ) ? ' ' : block[i];
+
+    usum += c;
+    ssum += (signed char)c;
+  }
+
+  return ( sum == usum || (int64_t)sum == ssum );
+}
+
+static char *__strndup( const char *s, size_t len )
+{
+  char *p = (char *)malloc( len + 1 );
+
+  if( !p ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  memcpy( (void *)p, (const void *)s, len );
+  p[len] = '\0';
+
+  return p;
+}
+
+static char *__field( const unsigned char *block, size_t offset, size_t len )
+{
+  const char *s = (const char *)&block[offset];
+  size_t      n = 0;
+
+  while( n < len && s[n] ) ++n;
+
+  return __strndup( s, n );
+}
+
+struct pax
+{
+  char     *path, *linkpath, *uname, *gname;
+  uint64_t  size, uid, gid, mtime;
+  long      mtime_nsec;
+  int       has_size, has_uid, has_gid, has_mtime;
+};
+
+static void __free_pax( struct pax *pax )
+{
+  if( pax->path )     free( pax->path );
+  if( pax->linkpath ) free( pax->linkpath );
+  if( pax->uname )    free( pax->uname );
+  if( pax->gname )    free( pax->gname );
+
+  bzero( (void *)pax, sizeof(struct pax) );
+}
+
+static void __parse_pax( struct pax *pax, char *data, size_t size )
+{
+  char *p = data, *end = data + size;
+
+  /* records: "<length> <keyword>=<value>\n" */
+  while( p < end )
+  {
+    char   *q = p, *key = NULL, *value = NULL;
+    size_t  len = 0;
+
+    while( q < end && *q >= '0' && *q <= '9' ) { len = len * 10 + (size_t)(*q - '0'); ++q; }
+    if( q >= end || *q != ' ' || len == 0 || p + len > end ) break;
+
+    key = ++q;
+    p[len - 1] = '\0'; /* replace new-line symbol */
+
+    if( (value = index( key, '=' )) )
+    {
+      *value++ = '\0';
+
+      if( !strcmp( key, "path" ) )          { if( pax->path ) free( pax->path ); pax->path = __strndup( value, strlen( value ) ); }
+      else if( !strcmp( key, "linkpath" ) ) { if( pax->linkpath ) free( pax->linkpath ); pax->linkpath = __strndup( value, strlen( value ) ); }
+      else if( !strcmp( key, "uname" ) )    { if( pax->uname ) free( pax->uname ); pax->uname = __strndup( value, strlen( value ) ); }
+      else if( !strcmp( key, "gname" ) )    { if( pax->gname ) free( pax->gname ); pax->gname = __strndup( value, strlen( value ) ); }
+      else if( !strcmp( key, "size" ) )     { pax->size  = strtoull( value, NULL, 10 ); pax->has_size  = 1; }
+      else if( !strcmp( key, "uid" ) )      { pax->uid   = strtoull( value, NULL, 10 ); pax->has_uid   = 1; }
+      else if( !strcmp( key, "gid" ) )      { pax->gid   = strtoull( value, NULL, 10 ); pax->has_gid   = 1; }
+      else if( !strcmp( key, "mtime" ) )
+      {
+        char *frac = NULL;
+        int   digits = 0;
+
+        pax->mtime = strtoull( value, &frac, 10 ); pax->has_mtime = 1;
+        pax->mtime_nsec = 0;
+
+        if( frac && *frac == '.' )
+          for( ++frac; digits < 9; ++digits )
+          {
+            pax->mtime_nsec *= 10;
+            if( *frac >= '0' && *frac <= '9' ) pax->mtime_nsec += *frac++ - '0';
+          }
+      }
+    }
+    p += len;
+  }
+}
+
+static char *__read_data( struct tarball *tar, uint64_t size )
+{
+  char     *data = NULL;
+  uint64_t  padding = (TARBALL_BLOCK - size % TARBALL_BLOCK) % TARBALL_BLOCK;
+
+  if( size > (uint64_t)16 * 1024 * 1024 ) return data; /* unreasonable header size */
+
+  data = (char *)malloc( (size_t)size + 1 );
+  if( !data ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  if( __read_full( tar, (void *)data, (size_t)size ) != (ssize_t)size || __skip( tar, padding ) != 0 )
+  {
+    free( data );
+    return NULL;
+  }
+  data[size] = '\0';
+
+  return data;
+}
+
+static char *__member_name( char *name )
+{
+  char *p = name;
+
+  /* remove leading './' and '/' as tar(1) does: */
+  for( ;; )
+  {
+    if( p[0] == '.' && p[1] == '/' ) p += 2;
+    else if( p[0] == '/' )           p += 1;
+    else break;
+  }
+  if( !*p || !strcmp( p, "." ) ) p = ".";
+
+  memmove( (void *)name, (const void *)p, strlen( p ) + 1 );
+
+  /* remove trailing slashes of directories: */
+  p = name + strlen( name );
+  while( p > name + 1 && *(p - 1) == '/' ) *(--p) = '\0';
+
+  return name;
+}
+
+int tarball_next( struct tarball *tar, struct tarball_member **member )
+{
+  unsigned char block[TARBALL_BLOCK];
+  struct pax    pax;
+  char         *longname = NULL, *longlink = NULL;
+
+  if( !tar ) return -1;
+  if( tar->end ) return 0;
+
+  if( __skip( tar, tar->remain + tar->padding ) != 0 ) return -1;
+  tar->remain = tar->padding = 0;
+
+  __free_member( &tar->member );
+  bzero( (void *)&pax, sizeof(struct pax) );
+
+  for( ;; )
+  {
+    ssize_t   n = __read_full( tar, (void *)&block[0], TARBALL_BLOCK );
+    uint64_t  size;
+    char      type;
+    int       i;
+
+    if( n == 0 ) { tar->end = 1; break; } /* archive without end-of-archive blocks */
+    if( n != TARBALL_BLOCK ) goto error;
+
+    for( i = 0; i < TARBALL_BLOCK && !block[i]; ++i ) ;
+    if( i == TARBALL_BLOCK ) { tar->end = 1; break; }
+
+    if( !__check_sum( (const unsigned char *)&block[0] ) ) { errno = EINVAL; goto error; }
+
+    type = (char)block[156];
+    size = __number( (const char *)&block[124], 12 );
+
+    if( type == 'x' || type == 'g' || type == 'L' || type == 'K' )
+    {
+      char *data = __read_data( tar, size );
+
+      if( !data ) goto error;
+
+      if( type == 'x' )      __parse_pax( &pax, data, (size_t)size );
+      else if( type == 'L' ) { if( longname ) free( longname ); longname = data; data = NULL; }
+      else if( type == 'K' ) { if( longlink ) free( longlink ); longlink = data; data = NULL; }
+
+      if( data ) free( data );
+      continue;
+    }
+
+    /****************
+      Fill member:
+     */
+    if( pax.path )     { tar->member.name = pax.path; pax.path = NULL; }
+    else if( longname ) { tar->member.name = longname; longname = NULL; }
+    else
+    {
+      char *name   = __field( block, 0, 100 );
+      char *prefix = ( !strncmp( (const char *)&block[257], "ustar", 5 ) ) ? __field( block, 345, 155 ) : NULL;
+
+      if( prefix && *prefix )
+      {
+        tar->member.name = (char *)malloc( strlen( prefix ) + strlen( name ) + 2 );
+        if( !tar->member.name ) { FATAL_ERROR( "Cannot allocate memory" ); }
+        (void)sprintf( tar->member.name, "%s/%s", prefix, name );
+        free( name );
+      }
+      else
+        tar->member.name = name;
+
+      if( prefix ) free( prefix );
+    }
+    (void)__member_name( tar->member.name );
+
+    if( pax.linkpath )  { tar->member.linkname = pax.linkpath; pax.linkpath = NULL; }
+    else if( longlink ) { tar->member.linkname = longlink; longlink = NULL; }
+    else                  tar->member.linkname = __field( block, 157, 100 );
+
+    if( pax.uname ) { tar->member.uname = pax.uname; pax.uname = NULL; }
+    else              tar->member.uname = __field( block, 265, 32 );
+    if( pax.gname ) { tar->member.gname = pax.gname; pax.gname = NULL; }
+    else              tar->member.gname = __field( block, 297, 32 );
+
+    tar->member.type     = ( type ) ? type : '0';
+    tar->member.mode     = (mode_t)(__number( (const char *)&block[100], 8 ) & 07777);
+    tar->member.uid      = (uid_t)( ( pax.has_uid )   ? pax.uid   : __number( (const char *)&block[108], 8 ) );
+    tar->member.gid      = (gid_t)( ( pax.has_gid )   ? pax.gid   : __number( (const char *)&block[116], 8 ) );
+    tar->member.mtime    = (time_t)( ( pax.has_mtime ) ? pax.mtime : __number( (const char *)&block[136], 12 ) );
+    tar->member.mtime_nsec = ( pax.has_mtime ) ? pax.mtime_nsec : 0;
+    tar->member.size     = ( pax.has_size ) ? pax.size : size;
+    tar->member.devmajor = (dev_t)__number( (const char *)&block[329], 8 );
+    tar->member.devminor = (dev_t)__number( (const char *)&block[337], 8 );
+
+    /* No data records are stored for links, devices and FIFOs: */
+    if( index( "12346", tar->member.type ) ) tar->member.size = 0;
+
+    tar->remain  = tar->member.size;
+    tar->padding = (TARBALL_BLOCK - tar->remain % TARBALL_BLOCK) % TARBALL_BLOCK;
+
+    __free_pax( &pax );
+
+    *member = &tar->member;
+    return 1;
+  }
+
+  __free_pax( &pax );
+  if( longname ) free( longname );
+  if( longlink ) free( longlink );
+
+  return 0;
+
+error:
+  __free_pax( &pax );
+  if( longname ) free( longname );
+  if( longlink ) free( longlink );
+
+  return -1;
+}
+
+ssize_t tarball_read( struct tarball *tar, void *buf, size_t size )
+{
+  ssize_t n;
+
+  if( !tar ) return -1;
+  if( !tar->remain ) return 0;
+
+  if( (uint64_t)size > tar->remain ) size = (size_t)tar->remain;
+
+  n = __read_full( tar, buf, size );
+  if( n != (ssize_t)size ) { errno = EIO; return -1; }
+
+  tar->remain -= (uint64_t)n;
+
+  return n;
+}
+
+int tarball_skip_rest( struct tarball *tar )
+{
+  char buf[TARBALL_BLOCK * 16];
+  ssize_t n;
+
+  if( !tar ) return -1;
+
+  /* the rest of archive (after end-of-archive blocks) is read by raw function: */
+  while( (n = tar->decompressor->read( tar, (void *)&buf[0], sizeof(buf) )) > 0 ) ;
+  if( n < 0 ) return -1;
+
+  while( __fill( tar ) > 0 ) tar->in_pos = tar->in_size;
+
+  tar->remain = tar->padding = 0;
+  tar->end = 1;
+
+  return 0;
+}
+/*
+  End of Archive HEADER functions.
+ ***************************************************************/
+
+
+/***************************************************************
+  Extract functions:
+ */
+static int __mkdir_p( char *path )
+{
+  char *p = path;
+
+  while( (p = index( p + 1, '/' )) )
+  {
+    *p = '\0';
+    if( mkdir( path, 0755 ) == -1 && errno != EEXIST ) { *p = '/'; return -1; }
+    *p = '/';
+  }
+  return 0;
+}
+
+static int __unsafe_name( const char *name )
+{
+  const char *p = name;
+
+  /* reject members which contain '..' components: */
+  while( p && *p )
+  {
+    if( p[0] == '.' && p[1] == '.' && (p[2] == '/' || p[2] == '\0') ) return 1;
+    if( (p = index( p, '/' )) ) ++p;
+  }
+  return 0;
+}
+
+static int __remove( const char *path, int keep_dir )
+{
+  struct stat st;
+
+  if( lstat( path, &st ) == -1 ) return ( errno == ENOENT ) ? 0 : -1;
+
+  if( S_ISDIR(st.st_mode) )
+  {
+    if( keep_dir ) return 0;
+    return rmdir( path );
+  }
+  return unlink( path );
+}
+
+static uid_t __uid( const struct tarball_member *member )
+{
+  static char  *uname = NULL;
+  static uid_t  uid   = 0;
+
+  struct passwd *pw = NULL;
+
+  if( !member->uname || !*member->uname ) return member->uid;
+  if( uname && !strcmp( uname, member->uname ) ) return uid;
+
+  if( !(pw = getpwnam( member->uname )) ) return member->uid;
+
+  if( uname ) free( uname );
+  uname = strdup( member->uname );
+  uid   = pw->pw_uid;
+
+  return uid;
+}
+
+static gid_t __gid( const struct tarball_member *member )
+{
+  static char  *gname = NULL;
+  static gid_t  gid   = 0;
+
+  struct group *gr = NULL;
+
+  if( !member->gname || !*member->gname ) return member->gid;
+  if( gname && !strcmp( gname, member->gname ) ) return gid;
+
+  if( !(gr = getgrnam( member->gname )) ) return member->gid;
+
+  if( gname ) free( gname );
+  gname = strdup( member->gname );
+  gid   = gr->gr_gid;
+
+  return gid;
+}
+
+static mode_t __mode( const struct tarball_member *member )
+{
+  static int    init = 0;
+  static mode_t mask = 0;
+
+  /* like tar(1) the superuser ignores umask: */
+  if( geteuid() == 0 ) return member->mode;
+
+  if( !init ) { mask = umask( 0 ); (void)umask( mask ); init = 1; }
+
+  return member->mode & ~mask;
+}
+
+static int __set_attributes( const char *path, const struct tarball_member *member, int symlink )
+{
+  struct timespec ts[2];
+
+  if( geteuid() == 0 )
+  {
+    if( lchown( path, __uid( member ), __gid( member ) ) == -1 ) return -1;
+  }
+
+  /* chown(2) clears set-user-ID bits, so the mode is changed after: */
+  if( !symlink && chmod( path, __mode( member ) ) == -1 ) return -1;
+
+  ts[0].tv_sec = ts[1].tv_sec = member->mtime;
+  ts[0].tv_nsec = ts[1].tv_nsec = member->mtime_nsec;
+
+  return utimensat( AT_FDCWD, path, ts, ( symlink ) ? AT_SYMLINK_NOFOLLOW : 0 );
+}
+
+static int __extract_file( struct tarball *tar, const char *path )
+{
+  char    *buf = NULL;
+  ssize_t  n;
+  int      fd, ret = 0;
+
+  if( __remove( path, 0 ) == -1 ) return -1;
+
+  if( (fd = open( path, O_WRONLY | O_CREAT | O_EXCL, 0600 )) == -1 ) return -1;
+
+  buf = (char *)malloc( (size_t)TARBALL_BUFSIZE );
+  if( !buf ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  while( (n = tarball_read( tar, (void *)buf, TARBALL_BUFSIZE )) > 0 )
+  {
+    char *p = buf;
+
+    while( n > 0 )
+    {
+      ssize_t w = write( fd, (const void *)p, (size_t)n );
+
+      if( w == -1 && errno == EINTR ) continue;
+      if( w <= 0 ) { ret = -1; break; }
+      p += w; n -= w;
+    }
+    if( ret ) break;
+  }
+  if( n < 0 ) ret = -1;
+
+  free( buf );
+
+  if( close( fd ) == -1 ) ret = -1;
+  if( ret ) return ret;
+
+  return __set_attributes( path, &tar->member, 0 );
+}
+
+/*
+  Like tar(1) the symbolic link is created after all members are
+  extracted, so the members of archive cannot be written through the
+  links of the same archive (with 'a -> /outside' and then 'a/x' the
+  'a/x' cannot be created because 'a' is not a directory). Until the
+  end of extraction an empty file holds the place of the link:
+ */
+static int __defer_symlink( struct tarball *tar, const char *path, const char *linkname,
+                            const struct tarball_member *member )
+{
+  struct symlink *link = NULL;
+  struct stat     st;
+  int             fd;
+
+  if( __remove( path, 0 ) == -1 ) return -1;
+
+  if( (fd = open( path, O_WRONLY | O_CREAT | O_EXCL, 0 )) == -1 ) return -1;
+  if( fstat( fd, &st ) == -1 ) { close( fd ); return -1; }
+  if( close( fd ) == -1 ) return -1;
+
+  if( tar->nlinks == tar->lsize )
+  {
+    tar->lsize = ( tar->lsize ) ? tar->lsize * 2 : 64;
+    tar->links = (struct symlink *)realloc( tar->links, tar->lsize * sizeof(struct symlink) );
+    if( !tar->links ) { FATAL_ERROR( "Cannot allocate memory" ); }
+  }
+
+  link = &tar->links[tar->nlinks++];
+  bzero( (void *)link, sizeof(struct symlink) );
+
+  link->path     = strdup( path );
+  link->linkname = strdup( linkname );
+  if( !link->path || !link->linkname ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  link->dev = st.st_dev;
+  link->ino = st.st_ino;
+
+  link->member.uid        = __uid( member );
+  link->member.gid        = __gid( member );
+  link->member.mtime      = member->mtime;
+  link->member.mtime_nsec = member->mtime_nsec;
+
+  return 0;
+}
+
+/* Returns the deferred symbolic link placed at PATH or NULL: */
+static struct symlink *__deferred_symlink( struct tarball *tar, const char *path )
+{
+  size_t i = tar->nlinks;
+
+  /* the last member with the same name wins: */
+  while( i )
+  {
+    if( !strcmp( tar->links[--i].path, path ) ) return &tar->links[i];
+  }
+  return NULL;
+}
+
+int tarball_finish( struct tarball *tar )
+{
+  int ret = 0;
+  size_t i;
+
+  if( !tar ) return -1;
+
+  for( i = 0; i < tar->nlinks; ++i )
+  {
+    struct symlink *link = &tar->links[i];
+    struct stat     st;
+
+    /* the placeholder can be replaced by the later member of archive: */
+    if( lstat( link->path, &st ) == 0 && st.st_dev == link->dev && st.st_ino == link->ino && S_ISREG(st.st_mode) )
+    {
+      if( unlink( link->path ) == -1 || symlink( link->linkname, link->path ) == -1 ||
+          __set_attributes( link->path, &link->member, 1 ) == -1 ) ret = -1;
+    }
+    free( link->path );
+    free( link->linkname );
+  }
+  tar->nlinks = 0;
+
+  /* restore mtimes of extracted directories in reverse order: */
+  while( tar->ndirs )
+  {
+    struct directory *dir = &tar->dirs[--tar->ndirs];
+    struct timespec   ts[2];
+
+    ts[0].tv_sec = ts[1].tv_sec = dir->mtime;
+    ts[0].tv_nsec = ts[1].tv_nsec = dir->mtime_nsec;
+    (void)utimensat( AT_FDCWD, dir->path, ts, 0 );
+    free( dir->path );
+  }
+
+  return ret;
+}
+
+int tarball_extract( struct tarball *tar, const char *dir )
+{
+  struct tarball_member *member = NULL;
+  char   *path = NULL;
+  int     ret = -1;
+
+  if( !tar || !dir || !tar->member.name ) return ret;
+
+  member = &tar->member;
+
+  if( __unsafe_name( member->name ) ) { errno = EINVAL; return ret; }
+
+  path = (char *)malloc( strlen( dir ) + strlen( member->name ) + 2 );
+  if( !path ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  if( !strcmp( member->name, "." ) ) (void)sprintf( path, "%s", dir );
+  else                               (void)sprintf( path, "%s/%s", dir, member->name );
+
+  if( __mkdir_p( path ) != 0 ) { free( path ); return ret; }
+
+  switch( member->type )
+  {
+    case '5': /* directory */
+    {
+      struct stat st;
+
+      if( lstat( path, &st ) == 0 && !S_ISDIR(st.st_mode) ) (void)unlink( path );
+      if( mkdir( path, 0700 ) == -1 && errno != EEXIST ) break;
+      if( __set_attributes( path, member, 0 ) == -1 ) break;
+
+      if( tar->ndirs == tar->dsize )
+      {
+        tar->dsize = ( tar->dsize ) ? tar->dsize * 2 : 64;
+        tar->dirs  = (struct directory *)realloc( tar->dirs, tar->dsize * sizeof(struct directory) );
+        if( !tar->dirs ) { FATAL_ERROR( "Cannot allocate memory" ); }
+      }
+      tar->dirs[tar->ndirs].path  = path; path = NULL;
+      tar->dirs[tar->ndirs].mtime = member->mtime;
+      tar->dirs[tar->ndirs].mtime_nsec = member->mtime_nsec;
+      ++tar->ndirs;
+
+      ret = 0;
+      break;
+    }
+    case '2': /* symbolic link */
+      ret = __defer_symlink( tar, path, member->linkname, member );
+      break;
+
+    case '1': /* hard link */
+    {
+      struct symlink *deferred = NULL;
+
+      char *target = (char *)malloc( strlen( dir ) + strlen( member->linkname ) + 2 );
+      if( !target ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+      (void)sprintf( target, "%s/%s", dir, member->linkname );
+      (void)__member_name( target + strlen( dir ) + 1 );
+
+      if( __unsafe_name( member->linkname ) ) { free( target ); break; }
+
+      /* the hard link to deferred symbolic link is the same symbolic link: */
+      if( (deferred = __deferred_symlink( tar, (const char *)target )) )
+      {
+        struct tarball_member attrs = deferred->member;
+        char *linkname = strdup( (const char *)deferred->linkname );
+        if( !linkname ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+        ret = __defer_symlink( tar, path, (const char *)linkname, &attrs );
+        free( linkname );
+      }
+      else if( __remove( path, 0 ) == 0 )
+        ret = link( target, path );
+
+      free( target );
+      break;
+    }
+    case '3': /* character device */
+    case '4': /* block device     */
+    case '6': /* FIFO             */
+    {
+      mode_t type = ( member->type == '3' ) ? S_IFCHR : ( member->type == '4' ) ? S_IFBLK : S_IFIFO;
+
+      if( __remove( path, 0 ) == -1 ) break;
+      if( mknod( path, type | 0600, makedev( member->devmajor, member->devminor ) ) == -1 ) break;
+      ret = __set_attributes( path, member, 0 );
+      break;
+    }
+    default: /* regular file; unknown types are extracted as regular files too */
+      ret = __extract_file( tar, path );
+      break;
+  }
+
+  if( path ) free( path );
+
+  return ret;
+}
+
+static int __in_list( const char *name, const char * const *list )
+{
+  while( *list )
+    if( !strcmp( name, *list++ ) ) return 1;
+  return 0;
+}
+
+int tarball_extract_members( const char *fname, const char *dir,
+                             const char * const *names, const char * const *group )
+{
+  struct tarball        *tar = NULL;
+  struct tarball_member *member = NULL;
+  char                  *found = NULL;
+  int                    i, n = 0, missing, rc = 0, in_group = 0;
+
+  if( !names ) return -1;
+  while( names[n] ) ++n;
+  missing = n;
+
+  if( !(tar = tarball_open( fname )) ) return -1;
+
+  found = (char *)calloc( (size_t)n + 1, 1 );
+  if( !found ) { FATAL_ERROR( "Cannot allocate memory" ); }
+
+  /* stop reading when all requested members are found: */
+  while( missing && (rc = tarball_next( tar, &member )) > 0 )
+  {
+    if( group )
+    {
+      if( __in_list( (const char *)member->name, group ) ) in_group = 1;
+      else if( in_group ) break; /* the rest of GROUP is not present */
+    }
+
+    for( i = 0; i < n; ++i )
+    {
+      if( !found[i] && !strcmp( member->name, names[i] ) )
+      {
+        if( tarball_extract( tar, dir ) != 0 ) { missing = -1; break; }
+        found[i] = 1; --missing;
+        break;
+      }
+    }
+    if( missing < 0 ) break;
+  }
+  if( missing > 0 && rc < 0 ) missing = -1;
+
+  free( found );
+  tarball_close( tar );
+
+  return missing;
+}
+
+int tarball_service_file( const char *name )
+{
+  const char *excluded[] = {
+    ".DESCRIPTION", ".FILELIST", ".INSTALL", ".PKGINFO", ".REQUIRES", ".RESTORELINKS", NULL
+  };
+  const char *p = name;
+
+  while( p )
+  {
+    size_t len = strcspn( p, "/" );
+    int    i;
+
+    for( i = 0; excluded[i]; ++i )
+      if( strlen( excluded[i] ) == len && !strncmp( p, excluded[i], len ) ) return 1;
+
+    if( (p = index( p, '/' )) ) ++p;
+  }
+  return 0;
+}
+
+int tarball_extract_package( const char *fname, const char *dir )
+{
+  struct tarball        *tar = NULL;
+  struct tarball_member *member = NULL;
+  int                    rc;
+
+  if( !(tar = tarball_open( fname )) ) return -1;
+
+  while( (rc = tarball_next( tar, &member )) > 0 )
+  {
+    if( tarball_service_file( (const char *)member->name ) ) continue;
+    if( tarball_extract( tar, dir ) != 0 ) { rc = -1; break; }
+  }
+  if( tarball_finish( tar ) != 0 ) rc = -1;
+  tarball_close( tar );
+
+  return ( rc < 0 ) ? 2 : 0;
+}
+/*
+  End of Extract functions.
+ ***************************************************************/
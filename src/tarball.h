@@ -0,0 +1,159 @@
+/**********************************************************************
+
+  Copyright 2019 Andrey V.Kosteltsev
+
+  Licensed under the Radix.pro License, Version 1.0 (the "License");
+  you may not use this file  except  in compliance with the License.
+  You may obtain a copy of the License at
+
+     https://radix.pro/licenses/LICENSE-1.0-en_US.txt
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+  implied.
+
+ **********************************************************************/
+
+#ifndef _TARBALL_H_
+#define _TARBALL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <sys/types.h>
+
+
+/***************************************************************
+  Streaming TAR reader:
+  ====================
+
+    Reads ustar (with pax and GNU long name extensions) archives
+    compressed by gzip, bzip2, xz or not compressed at all. The
+    compression is detected by signature of the file. Members are
+    read one by one in the archive order:
+
+      struct tarball        *tar = tarball_open( fname );
+      struct tarball_member *member;
+
+      while( tarball_next( tar, &member ) > 0 )
+      {
+        if( !strcmp( member->name, ".PKGINFO" ) )
+          tarball_extract( tar, destination );
+      }
+      tarball_close( tar );
+
+    Decompressors are available only if the corresponding library
+    was found by configure script; tarball_open() returns NULL and
+    sets errno to ENOTSUP for other compressions, so the caller can
+    use the tar(1) utility instead.
+ */
+enum _tarball_compression
+{
+  TARBALL_NONE = 0,
+  TARBALL_GZIP,
+  TARBALL_BZIP2,
+  TARBALL_XZ,
+
+  TARBALL_UNKNOWN
+};
+
+struct tarball_member
+{
+  char     *name;      /* without leading './' or '/' */
+  char     *linkname;  /* hard or symbolic link target */
+  char     *uname;
+  char     *gname;
+
+  char      type;      /* ustar typeflag: '0', '1', '2', '3', '4', '5', '6' */
+  mode_t    mode;
+  uid_t     uid;
+  gid_t     gid;
+  uint64_t  size;
+  time_t    mtime;
+  long      mtime_nsec; /* pax archives only */
+  dev_t     devmajor, devminor;
+};
+
+struct tarball;
+
+/* Called with each block of compressed data as it is read from the file: */
+typedef void (*tarball_raw_func)( const void *buf, size_t size, void *user_data );
+
+extern enum _tarball_compression tarball_compression( const char *fname );
+
+/*
+  Returns the letter which the utilities pass to tar(1) for COMPRESSION:
+  'J' for xz, 'j' for bzip2, 'x' for gzip (tar(1) recognizes it without
+  option) or '\0' if the archive is not compressed or unknown.
+ */
+extern char tarball_tar_option( enum _tarball_compression compression );
+
+extern struct tarball *tarball_open( const char *fname );
+extern void tarball_close( struct tarball *tar );
+
+extern void tarball_set_raw_func( struct tarball *tar, tarball_raw_func func, void *user_data );
+
+/*
+  Returns 1 and the next MEMBER, 0 at the end of the archive
+  or -1 on error. The rest of previous member data is skipped.
+ */
+extern int tarball_next( struct tarball *tar, struct tarball_member **member );
+
+/* Reads data of the current member; returns 0 at the end of data or -1 on error: */
+extern ssize_t tarball_read( struct tarball *tar, void *buf, size_t size );
+
+/*
+  Extracts the current member into DIR as tar(1) does. Parent
+  directories are created if needed. Returns 0 on success.
+
+  Symbolic links are created by tarball_finish() (until then an
+  empty file holds the place of each link), so the members cannot
+  be written through the links of the same archive.
+ */
+extern int tarball_extract( struct tarball *tar, const char *dir );
+
+/*
+  Creates deferred symbolic links and restores mtimes of extracted
+  directories. Returns 0 on success. The tarball_close() finishes
+  extraction if it is not done by caller.
+ */
+extern int tarball_finish( struct tarball *tar );
+
+/* Reads the archive up to the end (the raw data function receives all the file): */
+extern int tarball_skip_rest( struct tarball *tar );
+
+/*
+  Extracts members listed in NAMES (NULL terminated array) from the
+  FNAME archive into DIR by one pass. Returns the number of members
+  which are not found or -1 if the archive cannot be read.
+
+  If GROUP is not NULL, the members of GROUP are expected to be placed
+  one after another (like service files of a package) and the reading
+  stops at the first member out of GROUP which follows them.
+ */
+extern int tarball_extract_members( const char *fname, const char *dir,
+                                    const char * const *names, const char * const *group );
+
+/*
+  Returns 1 if NAME is a service file of package (.PKGINFO, .FILELIST,
+  etc.) or is placed under such directory. Each component of the NAME
+  is compared as tar(1) --exclude option does.
+ */
+extern int tarball_service_file( const char *name );
+
+/*
+  Extracts the package FNAME into DIR excluding service files. Returns
+  0 on success, -1 if the compression is not supported and the caller
+  should use the tar(1) utility, or 2 on error.
+ */
+extern int tarball_extract_package( const char *fname, const char *dir );
+
+
+#ifdef __cplusplus
+}  /* ... extern "C" */
+#endif
+
+#endif /* _TARBALL_H_ */
@@ -61,6 +61,8 @@
 
 #include <cmpvers.h>
 #include <dlist.h>
+#include <pkgdb.h>
+#include <tarball.h>
 
 #if defined( HAVE_DIALOG )
 #include <dialog-ui.h>
@@ -600,12 +602,10 @@ static void set_signal_handlers()
 static enum _input_type check_input_file( char *uncompress, const char *fname )
 {
   struct stat st;
-  size_t pkglog_size = 0;
+  enum _tarball_compression compression;
   unsigned char buf[8];
   int rc, fd;
 
-  /* SIGNATURES: https://www.garykessler.net/library/file_sigs.html */
-
   if( uncompress )
   {
     *uncompress = '\0';
@@ -616,8 +616,6 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     FATAL_ERROR( "Cannot access %s file: %s", basename( (char *)fname ), strerror( errno ) );
   }
 
-  pkglog_size = st.st_size;
-
   if( (fd = open( fname, O_RDONLY )) == -1 )
   {
     FATAL_ERROR( "Cannot open %s file: %s", basename( (char *)fname ), strerror( errno ) );
@@ -636,47 +634,14 @@ static enum _input_type check_input_file( char *uncompress, const char *fname )
     close( fd ); return IFMT_LOG;
   }
 
-  /* GZ */
-  if( buf[0] == 0x1F && buf[1] == 0x8B && buf[2] == 0x08 )
-  {
-    if( uncompress ) { *uncompress = 'x'; }
-    close( fd ); return IFMT_PKG;
-  }
+  close( fd );
 
-  /* BZ2 */
-  if( buf[0] == 0x42 && buf[1] == 0x5A && buf[2] == 0x68 )
-  {
-    if( uncompress ) { *uncompress = 'j'; }
-    close( fd ); return IFMT_PKG;
-  }
+  /* GZ, BZ2, XZ or TAR */
+  if( (compression = tarball_compression( fname )) == TARBALL_UNKNOWN ) return IFMT_UNKNOWN;
 
-  /* XZ */
-  if( buf[0] == 0xFD && buf[1] == 0x37 && buf[2] == 0x7A &&
-      buf[3] == 0x58 && buf[4] == 0x5A && buf[5] == 0x00   )
-  {
-    if( uncompress ) { *uncompress = 'J'; }
-    close( fd ); return IFMT_PKG;
-  }
+  if( uncompress ) { *uncompress = tarball_tar_option( compression ); }
 
-  if( pkglog_size > 262 )
-  {
-    if( lseek( fd, 257, SEEK_SET ) == -1 )
-    {
-      FATAL_ERROR( "Cannot check signature of %s file: %s", basename( (char *)fname ), strerror( errno ) );
-    }
-    rc = (int)read( fd, &buf[0], 5 );
-    if( rc != 5 )
-    {
-      FATAL_ERROR( "Cannot read signature of %s file", basename( (char *)fname ) );
-    }
-    /* TAR */
-    if( buf[0] == 0x75 && buf[1] == 0x73 && buf[2] == 0x74 && buf[3] == 0x61 && buf[4] == 0x72 )
-    {
-      close( fd ); return IFMT_PKG;
-    }
-  }
-
-  close( fd ); return IFMT_UNKNOWN;
+  return IFMT_PKG;
 }
 
 
@@ -2047,6 +2012,30 @@ static void read_service_files( void )
 }
 
 
+static void check_requires_status( int rc )
+{
+  if( rc != 0 )
+  {
+    if( update_mode != CONSOLE )
+    {
+#if defined( HAVE_DIALOG )
+      info_pkg_box( "Update:", pkgname, pkgver, strprio( priority, 0 ),
+                    "\nPackage requires other packages to be installed.\n", 5, 0, 0 );
+#else
+      fprintf( stdout, "\nPackage '%s-%s' requires other packages to be installed.\n\n", pkgname, pkgver );
+#endif
+    }
+    else
+    {
+      fprintf( stdout, "\nPackage '%s-%s' requires other packages to be installed.\n\n", pkgname, pkgver );
+    }
+
+    if( tmpdir ) { _rm_tmpdir( (const char *)tmpdir ); free( tmpdir ); }
+    free_resources();
+    exit( rc );
+  }
+}
+
 static void check_requires( void )
 {
   pid_t p = (pid_t) -1;
@@ -2055,6 +2044,17 @@ static void check_requires( void )
   int   len = 0;
   char *cmd = NULL;
 
+  /*************************************************************
+    Check requires in-process against the set of installed
+    packages loaded from the index of Setup Database. If the
+    index cannot be used we run the check-requires utility:
+   */
+  if( (rc = pkgdb_requires_status( (const char *)pkgs_path, (const char *)pkglog_fname )) >= 0 )
+  {
+    check_requires_status( rc );
+    return;
+  }
+
   cmd = (char *)malloc( (size_t)PATH_MAX );
   if( !cmd ) { FATAL_ERROR( "Cannot allocate memory" ); }
   bzero( (void *)cmd, PATH_MAX );
@@ -2071,26 +2071,7 @@ static void check_requires( void )
 
   free( cmd );
 
-  if( rc != 0 )
-  {
-    if( update_mode != CONSOLE )
-    {
-#if defined( HAVE_DIALOG )
-      info_pkg_box( "Update:", pkgname, pkgver, strprio( priority, 0 ),
-                    "\nPackage requires other packages to be installed.\n", 5, 0, 0 );
-#else
-      fprintf( stdout, "\nPackage '%s-%s' requires other packages to be installed.\n\n", pkgname, pkgver );
-#endif
-    }
-    else
-    {
-      fprintf( stdout, "\nPackage '%s-%s' requires other packages to be installed.\n\n", pkgname, pkgver );
-    }
-
-    if( tmpdir ) { _rm_tmpdir( (const char *)tmpdir ); free( tmpdir ); }
-    free_resources();
-    exit( rc );
-  }
+  check_requires_status( rc );
 }
 
 /********************************************************
@@ -2141,10 +2122,10 @@ static void read_filelist( void **d, void **f, const char *path )
   char *ln   = NULL;
   char *line = NULL, *tmp = NULL;
 
-  struct dlist *dirs  = (struct dlist *)(*d);
-  struct dlist *files = (struct dlist *)(*f);
+  struct dlist_head dirs  = DLIST_HEAD_INIT,
+                    files = DLIST_HEAD_INIT;
 
-  if( !dirs || !files || !path ) return;
+  if( !d || !f || !*d || !*f || !path ) return;
 
   tmp = (char *)malloc( (size_t)PATH_MAX );
   if( !tmp ) { FATAL_ERROR( "Cannot allocate memory" ); }
@@ -2167,6 +2148,9 @@ static void read_filelist( void **d, void **f, const char *path )
   if( !line ) { FATAL_ERROR( "Cannot allocate memory" ); }
   bzero( (void *)line, PATH_MAX );
 
+  dlist_head_attach( &dirs,  (struct dlist *)(*d) );
+  dlist_head_attach( &files, (struct dlist *)(*f) );
+
   while( (ln = fgets( line, PATH_MAX, fp )) )
   {
     ln[strlen(ln) - 1] = '\0'; /* replace new-line symbol      */
@@ -2176,16 +2160,19 @@ static void read_filelist( void **d, void **f, const char *path )
     {
       *(ln + strlen(ln) - 1) = '\0';
       (void)sprintf( &tmp[0], "%s%s", (const char *)root, (const char *)ln );
-      dirs = dlist_append( dirs, strdup( (const char *)&tmp[0] ) );
+      dlist_head_append( &dirs, strdup( (const char *)&tmp[0] ) );
     }
     else
     {
       (void)sprintf( &tmp[0], "%s%s", (const char *)root, (const char *)ln );
-      files = dlist_append( files, strdup( (const char *)&tmp[0] ) );
+      dlist_head_append( &files, strdup( (const char *)&tmp[0] ) );
     }
 
   } /* End of while( file list entry ) */
 
+  *d = (void *)dlist_head_detach( &dirs );
+  *f = (void *)dlist_head_detach( &files );
+
   fclose( fp );
 
   free( line );
@@ -2844,6 +2831,8 @@ static void uncompress_package( void )
 
   char decompressor[64];
 
+  if( (rc = tarball_extract_package( (const char *)pkg_fname, (const char *)root )) >= 0 ) goto done;
+
   (void)fill_decompressor( (char *)&decompressor[0], uncompress );
 
   cmd = (char *)malloc( (size_t)PATH_MAX );
@@ -2869,6 +2858,7 @@ static void uncompress_package( void )
 
   free( cmd );
 
+done:
   if( rc != 0 )
   {
     exit_status = 44;
@@ -3141,6 +3131,34 @@ static void finalize_update( void )
     }
   }
 
+  /*****************************************************
+    Update the index of the Setup Database: the PKGLOG
+    of removed version is dropped, the new one is added:
+   */
+  bzero( (void *)tmp, PATH_MAX );
+  {
+    char       *oldlog = (char *)&tmp[PATH_MAX / 2];
+    const char *pkglogs[2];
+
+    if( group )
+      (void)snprintf( &tmp[0], PATH_MAX / 2, "%s/%s", group, basename( (char *)pkglog_fname ) );
+    else
+      (void)snprintf( &tmp[0], PATH_MAX / 2, "%s", basename( (char *)pkglog_fname ) );
+
+    if( installed_group )
+      (void)snprintf( oldlog, PATH_MAX / 2, "%s/%s", installed_group, basename( (char *)remlog_fname ) );
+    else
+      (void)snprintf( oldlog, PATH_MAX / 2, "%s", basename( (char *)remlog_fname ) );
+
+    pkglogs[0] = (const char *)&tmp[0];
+    pkglogs[1] = (const char *)oldlog;
+
+    if( pkgdb_update( (const char *)pkgs_path, pkglogs, 2, 1 ) != 0 )
+    {
+      WARNING( "Cannot update the index of Setup Database" );
+    }
+  }
+
   free( tmp );
 }
 